@@ -0,0 +1,274 @@
+/*
+ * @file LevelCompression.cpp
+ * @brief Définition de la classe LevelCompression.
+ * @author Noah Blattner
+ * @date Octobre 2026
+ */
+
+#include <cstring>
+
+#include <QFile>
+#include <QVector>
+#include <QtEndian>
+#include "LevelCompression.h"
+#include "tracing.h"
+
+//! Retourne le nom d'un algorithme de compression, pour l'affichage
+//! \param codec L'algorithme
+QString LevelCompression::codecName(Codec codec) {
+    switch (codec) {
+        case NoCodec: return "Aucune";
+        case ZlibCodec: return "zlib";
+        case Lz4Codec: return "LZ4";
+    }
+    return QString();
+}
+
+//! Indique si des données sont un niveau compressé
+//! \param data Les données
+//! \param size La taille des données
+bool LevelCompression::isCompressed(const char* data, qsizetype size) {
+    return size >= HEADER_SIZE && qFromLittleEndian<quint32>(data) == MAGIC;
+}
+
+//! Retourne l'algorithme de compression d'un fichier de niveau, en lisant uniquement son en-tête
+//! \param filePath Le chemin du fichier
+//! \return L'algorithme, NoCodec si le fichier n'est pas compressé ou ne peut pas être lu
+LevelCompression::Codec LevelCompression::fileCodec(const QString& filePath) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return NoCodec;
+    }
+    QByteArray header = file.read(HEADER_SIZE);
+    if (!isCompressed(header.constData(), header.size())) {
+        return NoCodec;
+    }
+    return static_cast<Codec>(static_cast<quint8>(header[6]));
+}
+
+//! Compresse un niveau et l'enveloppe dans le conteneur de niveau compressé
+//! \param data Le contenu du fichier de niveau (binaire ou JSON)
+//! \param codec L'algorithme de compression. Avec NoCodec, les données sont retournées telles quelles
+//! \return Le contenu du fichier compressé
+QByteArray LevelCompression::compress(const QByteArray& data, Codec codec) {
+    TRACE_SCOPE("LevelCompression::compress");
+
+    if (codec != ZlibCodec && codec != Lz4Codec) {
+        return data;
+    }
+
+    char header[HEADER_SIZE] = {};
+    qToLittleEndian<quint32>(MAGIC, header);
+    qToLittleEndian<quint16>(VERSION, header + 4);
+    header[6] = static_cast<char>(codec);
+    qToLittleEndian<quint64>(static_cast<quint64>(data.size()), header + 8);
+
+    QByteArray output(header, HEADER_SIZE);
+    if (codec == ZlibCodec) {
+        output.append(qCompress(data));
+    } else {
+        output.append(compressLz4(data.constData(), data.size()));
+    }
+    return output;
+}
+
+//! Décompresse un niveau compressé
+//! \param data Le contenu du fichier compressé
+//! \param size La taille du fichier
+//! \param output Reçoit le contenu du fichier de niveau (binaire ou JSON)
+//! \param pError Reçoit la description de l'erreur, si non nul
+//! \return true si les données ont pu être décompressées
+bool LevelCompression::decompress(const char* data, qsizetype size, QByteArray& output, QString* pError) {
+    TRACE_SCOPE("LevelCompression::decompress");
+
+    auto fail = [pError](const QString& error) {
+        if (pError != nullptr) {
+            *pError = error;
+        }
+        return false;
+    };
+
+    if (!isCompressed(data, size)) {
+        return fail("Le fichier n'est pas un niveau compressé");
+    }
+    if (qFromLittleEndian<quint16>(data + 4) != VERSION) {
+        return fail("Version de niveau compressé non prise en charge");
+    }
+
+    auto codec = static_cast<Codec>(static_cast<quint8>(data[6]));
+    quint64 outputSize = qFromLittleEndian<quint64>(data + 8);
+    const char* payload = data + HEADER_SIZE;
+    qsizetype payloadSize = size - HEADER_SIZE;
+
+    switch (codec) {
+        case ZlibCodec:
+            output = qUncompress(reinterpret_cast<const uchar*>(payload), payloadSize);
+            if (static_cast<quint64>(output.size()) != outputSize) {
+                return fail("Niveau compressé tronqué ou corrompu");
+            }
+            return true;
+        case Lz4Codec:
+            // Une séquence LZ4 produit au plus 255 octets par octet lu : une taille supérieure est forcément corrompue
+            if (outputSize > static_cast<quint64>(payloadSize) * 255) {
+                return fail("Niveau compressé tronqué ou corrompu");
+            }
+            output = QByteArray(static_cast<qsizetype>(outputSize), Qt::Uninitialized);
+            if (!decompressLz4(payload, payloadSize, output.data(), output.size())) {
+                output.clear();
+                return fail("Niveau compressé tronqué ou corrompu");
+            }
+            return true;
+        case NoCodec:
+            break;
+    }
+    return fail("Algorithme de compression inconnu");
+}
+
+//! Compresse des données au format de bloc LZ4
+//! Chaque séquence est composée d'un jeton (longueurs des littéraux et de la correspondance), des littéraux,
+//! puis de la distance de la correspondance. Les correspondances sont trouvées avec une table de hachage
+//! des quatre octets suivant chaque position.
+//! \param data Les données
+//! \param size La taille des données
+//! \return Le bloc compressé
+QByteArray LevelCompression::compressLz4(const char* data, qsizetype size) {
+    const auto* pSource = reinterpret_cast<const uchar*>(data);
+
+    QByteArray output;
+    output.reserve(size + size / 255 + 16); // Pire cas : données incompressibles
+
+    auto appendLength = [&output](qsizetype length) {
+        for (; length >= 255; length -= 255) {
+            output.append(static_cast<char>(255));
+        }
+        output.append(static_cast<char>(length));
+    };
+
+    // Écrit une séquence. Une longueur de correspondance nulle indique la dernière séquence, composée de littéraux
+    auto appendSequence = [&](qsizetype literalStart, qsizetype literalLength, qsizetype offset, qsizetype matchLength) {
+        qsizetype matchCode = matchLength > 0 ? matchLength - LZ4_MIN_MATCH : 0;
+        output.append(static_cast<char>(qMin<qsizetype>(literalLength, 15) << 4 | qMin<qsizetype>(matchCode, 15)));
+        if (literalLength >= 15) {
+            appendLength(literalLength - 15);
+        }
+        output.append(data + literalStart, literalLength);
+        if (matchLength > 0) {
+            output.append(static_cast<char>(offset & 0xff));
+            output.append(static_cast<char>(offset >> 8));
+            if (matchCode >= 15) {
+                appendLength(matchCode - 15);
+            }
+        }
+    };
+
+    auto read32 = [pSource](qsizetype position) {
+        return qFromUnaligned<quint32>(pSource + position);
+    };
+    auto hash = [](quint32 sequence) {
+        return (sequence * 2654435761u) >> (32 - LZ4_HASH_LOG);
+    };
+
+    QVector<qsizetype> positions(1 << LZ4_HASH_LOG, -1); // Dernière position de chaque valeur de hachage
+    qsizetype anchor = 0; // Début des littéraux en attente
+    qsizetype position = 0;
+    const qsizetype matchStartLimit = size - LZ4_MATCH_LIMIT;
+    const qsizetype matchEndLimit = size - LZ4_LAST_LITERALS;
+    while (position < matchStartLimit) {
+        quint32 sequence = read32(position);
+        quint32 sequenceHash = hash(sequence);
+        qsizetype candidate = positions[sequenceHash];
+        positions[sequenceHash] = position;
+
+        if (candidate < 0 || position - candidate > LZ4_MAX_OFFSET || read32(candidate) != sequence) {
+            // Pas de correspondance. Plus les littéraux en attente sont nombreux, plus on avance vite :
+            // les données incompressibles sont parcourues rapidement
+            position += 1 + ((position - anchor) >> 6);
+            continue;
+        }
+
+        qsizetype matchLength = LZ4_MIN_MATCH;
+        while (position + matchLength < matchEndLimit && pSource[candidate + matchLength] == pSource[position + matchLength]) {
+            matchLength++;
+        }
+        appendSequence(anchor, position - anchor, position - candidate, matchLength);
+        position += matchLength;
+        anchor = position;
+    }
+    appendSequence(anchor, size - anchor, 0, 0);
+
+    return output;
+}
+
+//! Décompresse un bloc LZ4. Toutes les longueurs et distances sont vérifiées : un bloc corrompu est refusé
+//! \param data Le bloc compressé
+//! \param size La taille du bloc
+//! \param output Reçoit les données décompressées
+//! \param outputSize La taille attendue des données décompressées
+//! \return true si le bloc est valide et produit exactement outputSize octets
+bool LevelCompression::decompressLz4(const char* data, qsizetype size, char* output, qsizetype outputSize) {
+    const auto* pSource = reinterpret_cast<const uchar*>(data);
+    qsizetype input = 0;
+    qsizetype written = 0;
+
+    auto readLength = [&](qsizetype& length) {
+        uchar byte = 0;
+        do {
+            if (input >= size) {
+                return false;
+            }
+            byte = pSource[input++];
+            length += byte;
+        } while (byte == 255);
+        return true;
+    };
+
+    while (input < size) {
+        uchar token = pSource[input++];
+
+        // Littéraux
+        qsizetype literalLength = token >> 4;
+        if (literalLength == 15 && !readLength(literalLength)) {
+            return false;
+        }
+        if (literalLength > size - input || literalLength > outputSize - written) {
+            return false;
+        }
+        std::memcpy(output + written, data + input, literalLength);
+        input += literalLength;
+        written += literalLength;
+
+        if (input == size) { // Dernière séquence : pas de correspondance
+            break;
+        }
+
+        // Correspondance
+        if (size - input < 2) {
+            return false;
+        }
+        qsizetype offset = pSource[input] | pSource[input + 1] << 8;
+        input += 2;
+        if (offset == 0 || offset > written) {
+            return false;
+        }
+        qsizetype matchLength = token & 15;
+        if (matchLength == 15 && !readLength(matchLength)) {
+            return false;
+        }
+        matchLength += LZ4_MIN_MATCH;
+        if (matchLength > outputSize - written) {
+            return false;
+        }
+
+        const char* pMatch = output + written - offset;
+        if (offset >= matchLength) {
+            std::memcpy(output + written, pMatch, matchLength);
+        } else { // La correspondance recouvre les octets qu'elle produit : copie octet par octet
+            for (qsizetype i = 0; i < matchLength; i++) {
+                output[written + i] = pMatch[i];
+            }
+        }
+        written += matchLength;
+    }
+
+    return written == outputSize;
+}
@@ -0,0 +1,61 @@
+/*
+ * @file LevelCompression.h
+ * @brief Déclaration de la classe LevelCompression.
+ * @author Noah Blattner
+ * @date Octobre 2026
+ */
+
+#ifndef WORLDBUILDR_LEVELCOMPRESSION_H
+#define WORLDBUILDR_LEVELCOMPRESSION_H
+
+#include <QByteArray>
+#include <QString>
+
+//! Compression des fichiers de niveau, utilisée par l'éditeur et par LevelLoader.
+//!
+//! Un niveau compressé (binaire ou JSON) est enveloppé dans un conteneur qui décrit sa compression :
+//! - un en-tête de taille fixe (HEADER_SIZE octets) : MAGIC, VERSION, algorithme (Codec), un octet réservé,
+//!   puis la taille des données décompressées ;
+//! - les données compressées.
+//! Le conteneur est reconnu à son contenu, quelle que soit l'extension du fichier : les lecteurs de niveau
+//! (LevelFile::readFile(), LevelLoader) choisissent eux-mêmes l'algorithme de décompression.
+//!
+//! Deux algorithmes sont proposés :
+//! - zlib (qCompress()), pour les fichiers les plus petits ;
+//! - LZ4, au format de bloc LZ4, implémenté ici. Moins efficace que zlib, il est bien plus rapide à décompresser.
+//! Tous les entiers de l'en-tête sont écrits en petit-boutiste.
+class LevelCompression {
+public:
+    enum Codec : quint8 {
+        NoCodec,
+        ZlibCodec,
+        Lz4Codec
+    };
+
+    static constexpr qsizetype HEADER_SIZE = 16;
+
+    static QString codecName(Codec codec);
+
+    static bool isCompressed(const char* data, qsizetype size);
+    static Codec fileCodec(const QString& filePath);
+
+    static QByteArray compress(const QByteArray& data, Codec codec);
+    static bool decompress(const char* data, qsizetype size, QByteArray& output, QString* pError = nullptr);
+
+private:
+    static QByteArray compressLz4(const char* data, qsizetype size);
+    static bool decompressLz4(const char* data, qsizetype size, char* output, qsizetype outputSize);
+
+    static constexpr quint32 MAGIC = 0x5a4c4257; // Octets "WBLZ"
+    static constexpr quint16 VERSION = 1;
+
+    // Paramètres du format de bloc LZ4
+    static constexpr int LZ4_HASH_LOG = 12; // Taille de la table de hachage du compresseur : 2^LZ4_HASH_LOG positions
+    static constexpr qsizetype LZ4_MIN_MATCH = 4; // Longueur minimale d'une correspondance
+    static constexpr qsizetype LZ4_MATCH_LIMIT = 12; // Une correspondance commence au moins 12 octets avant la fin
+    static constexpr qsizetype LZ4_LAST_LITERALS = 5; // Les 5 derniers octets sont toujours des littéraux
+    static constexpr qsizetype LZ4_MAX_OFFSET = 65535;
+};
+
+
+#endif //WORLDBUILDR_LEVELCOMPRESSION_H
@@ -0,0 +1,661 @@
+/*
+ * @file LevelFile.cpp
+ * @brief Définition de la classe LevelFile.
+ * @author Noah Blattner
+ * @date Octobre 2026
+ */
+
+#include <cmath>
+#include <limits>
+
+#include <QBuffer>
+#include <QFile>
+#include <QHash>
+#include <QtEndian>
+#include <QVector>
+#include "LevelCompression.h"
+#include "LevelFile.h"
+#include "LevelJsonStream.h"
+#include "tracing.h"
+
+const QString LevelFile::BINARY_EXTENSION = ".wbl";
+const QString LevelFile::JSON_EXTENSION = ".json";
+
+namespace {
+
+//! Ajoute une valeur en petit-boutiste à la fin d'un tampon
+template <typename T>
+void appendLittleEndian(QByteArray& buffer, T value) {
+    char bytes[sizeof(T)];
+    qToLittleEndian(value, bytes);
+    buffer.append(bytes, sizeof(T));
+}
+
+//! Lit une valeur en petit-boutiste à une position donnée d'un tampon
+template <typename T>
+T readLittleEndian(const char* data, qsizetype offset) {
+    return qFromLittleEndian<T>(data + offset);
+}
+
+}
+
+//! Lit un fichier de niveau, au format binaire ou JSON, compressé ou non. Le format est reconnu au contenu du fichier
+//! Un niveau binaire est lu depuis une projection du fichier en mémoire, sans copie préalable.
+//! Un niveau JSON est analysé au fil de la lecture (LevelJsonReader), sans construire de document JSON
+//! \param filePath Le chemin du fichier
+//! \param level Reçoit le contenu du niveau
+//! \param pError Reçoit la description de l'erreur, si non nul
+//! \return true si le fichier a pu être lu
+bool LevelFile::readFile(const QString& filePath, LevelData& level, QString* pError) {
+    TRACE_SCOPE("LevelFile::readFile");
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (pError != nullptr) {
+            *pError = "Impossible d'ouvrir le fichier " + filePath;
+        }
+        return false;
+    }
+
+    QByteArray magic = file.peek(HEADER_SIZE);
+    if (isBinary(magic.constData(), magic.size())) {
+        file.close();
+
+        LevelFileView view;
+        return view.map(filePath, pError) && fromView(view, level);
+    }
+
+    if (LevelCompression::isCompressed(magic.constData(), magic.size())) { // Niveau compressé : décompressé en mémoire
+        const QByteArray compressed = file.readAll();
+        file.close();
+
+        QByteArray data;
+        if (!LevelCompression::decompress(compressed.constData(), compressed.size(), data, pError)) {
+            return false;
+        }
+        if (isBinary(data.constData(), data.size())) {
+            return fromBinary(data.constData(), data.size(), level, pError);
+        }
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+        return readJson(&buffer, level, pError);
+    }
+
+    bool ok = readJson(&file, level, pError);
+    file.close();
+    return ok;
+}
+
+//! Lit un niveau JSON au fil de la lecture (LevelJsonReader)
+//! \param pDevice Le périphérique à lire, ouvert en lecture
+//! \param level Reçoit le contenu du niveau
+//! \param pError Reçoit la description de l'erreur, si non nul
+//! \return true si le niveau a pu être lu
+bool LevelFile::readJson(QIODevice* pDevice, LevelData& level, QString* pError) {
+    level = LevelData();
+    LevelJsonReader reader(pDevice);
+    bool ok = reader.read(level, [&level](const LevelSprite& sprite) {
+        level.sprites.append(sprite);
+    });
+
+    if (!ok && pError != nullptr) {
+        *pError = reader.errorString();
+    }
+    return ok;
+}
+
+//! Indique si des données sont au format binaire
+//! \param data Les données
+//! \param size La taille des données
+bool LevelFile::isBinary(const char* data, qsizetype size) {
+    return size >= HEADER_SIZE && readLittleEndian<quint32>(data, 0) == MAGIC;
+}
+
+//! Indique si un fichier est un niveau au format binaire, en lisant uniquement son en-tête
+//! \param filePath Le chemin du fichier
+bool LevelFile::isBinaryFile(const QString& filePath) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QByteArray header = file.read(HEADER_SIZE);
+    return isBinary(header.constData(), header.size());
+}
+
+//! Complète la table des textures d'un niveau : chaque sprite qui n'y référence pas encore sa texture
+//! y reçoit l'index de son chemin, ajouté à la table s'il n'y figure pas
+//! \param level Le niveau
+void LevelFile::indexTextures(LevelData& level) {
+    LevelTextureTable textureTable(level.textures);
+    for (LevelSprite& sprite : level.sprites) {
+        sprite.textureIndex = textureTable.indexOf(sprite);
+    }
+    level.textures = textureTable.textures();
+}
+
+//! Convertit un niveau au format binaire, en mémoire (voir writeBinary())
+//! \param level Le niveau
+//! \param chunkSize La taille des régions, en unités de la scène. Une taille nulle est remplacée par DEFAULT_CHUNK_SIZE
+//! \return Le contenu du fichier binaire
+QByteArray LevelFile::toBinary(const LevelData& level, quint32 chunkSize) {
+    QByteArray content;
+    QBuffer buffer(&content);
+    buffer.open(QIODevice::WriteOnly);
+    writeBinary(&buffer, level, chunkSize);
+    return content;
+}
+
+//! Écrit un niveau au format binaire. Les sprites sont répartis en régions, pour le chargement progressif.
+//! Les tables (chaînes, régions) sont construites avant l'écriture ; les enregistrements sont ensuite écrits par blocs
+//! de BINARY_WRITE_BLOCK_SIZE octets : le fichier n'est jamais entièrement en mémoire
+//! \param pDevice Le périphérique, ouvert en écriture
+//! \param level Le niveau
+//! \param chunkSize La taille des régions, en unités de la scène. Une taille nulle est remplacée par DEFAULT_CHUNK_SIZE
+//! \param onProgress Si non vide, appelée après l'écriture de chaque bloc avec le nombre de sprites écrits
+//! \return true si tout le niveau a été écrit
+bool LevelFile::writeBinary(QIODevice* pDevice, const LevelData& level, quint32 chunkSize,
+                            const std::function<void(qsizetype)>& onProgress) {
+    TRACE_SCOPE("LevelFile::writeBinary");
+
+    if (chunkSize == 0) { // Refusée à la lecture
+        chunkSize = DEFAULT_CHUNK_SIZE;
+    }
+
+    // Table des chaînes : chaque chaîne n'est écrite qu'une fois
+    QStringList strings;
+    QHash<QString, quint32> stringIndices;
+    auto stringIndex = [&strings, &stringIndices](const QString& string) -> quint32 {
+        if (string.isEmpty()) {
+            return NO_STRING;
+        }
+        auto it = stringIndices.constFind(string);
+        if (it != stringIndices.constEnd()) {
+            return it.value();
+        }
+        auto index = static_cast<quint32>(strings.size());
+        stringIndices.insert(string, index);
+        strings.append(string);
+        return index;
+    };
+
+    quint32 backgroundIndex = stringIndex(level.background);
+    quint32 historyTokenIndex = stringIndex(level.historyToken);
+    QVector<quint32> tagIndices;
+    tagIndices.reserve(level.tags.size());
+    for (const QString& tag : level.tags) {
+        tagIndices.append(stringIndex(tag));
+    }
+    // Les textures de la table des textures ne sont recherchées qu'une fois, et non pour chaque sprite
+    QVector<quint32> tableTextureIndices;
+    tableTextureIndices.reserve(level.textures.size());
+    for (const QString& texture : level.textures) {
+        tableTextureIndices.append(stringIndex(texture));
+    }
+    QVector<quint32> textureIndices(level.sprites.size());
+    QVector<quint32> spriteTagIndices(level.sprites.size());
+    for (qsizetype i = 0; i < level.sprites.size(); i++) {
+        const LevelSprite& sprite = level.sprites[i];
+        bool isIndexed = sprite.textureIndex >= 0 && sprite.textureIndex < tableTextureIndices.size();
+        textureIndices[i] = isIndexed ? tableTextureIndices[sprite.textureIndex] : stringIndex(sprite.texturePath);
+        spriteTagIndices[i] = stringIndex(sprite.tag);
+    }
+
+    // Régions : chaque sprite appartient à la région qui contient sa position. Les régions sont numérotées
+    // dans l'ordre d'apparition de leur premier sprite ; l'ordre des sprites n'est pas modifié
+    QVector<QPoint> chunkCoordinates;
+    QVector<QVector<quint32>> chunkSprites;
+    QHash<quint64, qsizetype> chunkIndices; // Index de chaque région, par clé de région (chunkKey())
+    for (qsizetype i = 0; i < level.sprites.size(); i++) {
+        QPoint chunk = chunkAt(level.sprites[i].x, level.sprites[i].y, chunkSize);
+        auto it = chunkIndices.constFind(chunkKey(chunk));
+        if (it == chunkIndices.constEnd()) {
+            it = chunkIndices.insert(chunkKey(chunk), chunkCoordinates.size());
+            chunkCoordinates.append(chunk);
+            chunkSprites.append(QVector<quint32>());
+        }
+        chunkSprites[it.value()].append(static_cast<quint32>(i));
+    }
+
+    QByteArray stringTable;
+    for (const QString& string : std::as_const(strings)) {
+        QByteArray utf8 = string.toUtf8();
+        appendLittleEndian<quint32>(stringTable, utf8.size());
+        stringTable.append(utf8);
+    }
+
+    // Bloc en cours d'écriture, vidé dans le périphérique dès qu'il atteint BINARY_WRITE_BLOCK_SIZE octets
+    QByteArray content;
+    content.reserve(BINARY_WRITE_BLOCK_SIZE + SPRITE_RECORD_SIZE);
+    auto writeBlock = [pDevice, &content]() {
+        bool written = pDevice->write(content) == content.size();
+        content.resize(0); // Conserve la capacité réservée
+        return written;
+    };
+
+    // En-tête
+    appendLittleEndian<quint32>(content, MAGIC);
+    appendLittleEndian<quint16>(content, VERSION);
+    appendLittleEndian<quint16>(content, CHUNKED_OPTION); // Options
+    appendLittleEndian<qint32>(content, level.sceneSize.width());
+    appendLittleEndian<qint32>(content, level.sceneSize.height());
+    appendLittleEndian<quint32>(content, backgroundIndex);
+    appendLittleEndian<quint32>(content, historyTokenIndex);
+    appendLittleEndian<quint32>(content, strings.size());
+    appendLittleEndian<quint32>(content, tagIndices.size());
+    appendLittleEndian<quint32>(content, level.sprites.size());
+    appendLittleEndian<quint32>(content, stringTable.size());
+
+    // Table des chaînes et tags du niveau
+    content.append(stringTable);
+    for (quint32 tagIndex : std::as_const(tagIndices)) {
+        appendLittleEndian<quint32>(content, tagIndex);
+    }
+
+    // Sprites
+    for (qsizetype i = 0; i < level.sprites.size(); i++) {
+        const LevelSprite& sprite = level.sprites[i];
+        appendLittleEndian<quint64>(content, sprite.id);
+        appendLittleEndian<double>(content, sprite.x);
+        appendLittleEndian<double>(content, sprite.y);
+        appendLittleEndian<double>(content, sprite.rotation);
+        appendLittleEndian<double>(content, sprite.scale);
+        appendLittleEndian<double>(content, sprite.opacity);
+        appendLittleEndian<double>(content, sprite.z);
+        appendLittleEndian<quint32>(content, textureIndices[i]);
+        appendLittleEndian<quint32>(content, spriteTagIndices[i]);
+
+        if (content.size() >= BINARY_WRITE_BLOCK_SIZE) {
+            if (!writeBlock()) {
+                return false;
+            }
+            if (onProgress) {
+                onProgress(i + 1);
+            }
+        }
+    }
+
+    // Régions : taille et nombre des régions, position et sprites de chaque région, puis index des sprites par région
+    appendLittleEndian<quint32>(content, chunkSize);
+    appendLittleEndian<quint32>(content, chunkCoordinates.size());
+    quint32 firstSprite = 0;
+    for (qsizetype i = 0; i < chunkCoordinates.size(); i++) {
+        appendLittleEndian<qint32>(content, chunkCoordinates[i].x());
+        appendLittleEndian<qint32>(content, chunkCoordinates[i].y());
+        appendLittleEndian<quint32>(content, firstSprite);
+        appendLittleEndian<quint32>(content, chunkSprites[i].size());
+        firstSprite += static_cast<quint32>(chunkSprites[i].size());
+        if (content.size() >= BINARY_WRITE_BLOCK_SIZE && !writeBlock()) {
+            return false;
+        }
+    }
+    for (const QVector<quint32>& sprites : std::as_const(chunkSprites)) {
+        for (quint32 spriteIndex : sprites) {
+            appendLittleEndian<quint32>(content, spriteIndex);
+            if (content.size() >= BINARY_WRITE_BLOCK_SIZE && !writeBlock()) {
+                return false;
+            }
+        }
+    }
+
+    return writeBlock();
+}
+
+//! Retourne les coordonnées de la région qui contient une position
+//! \param x L'abscisse de la position, dans la scène
+//! \param y L'ordonnée de la position, dans la scène
+//! \param chunkSize La taille des régions, en unités de la scène
+//! \return Les coordonnées de la région, limitées aux valeurs d'un int. (0, 0) si la taille est nulle,
+//! une coordonnée non numérique (NaN) est ramenée à 0
+QPoint LevelFile::chunkAt(double x, double y, quint32 chunkSize) {
+    if (chunkSize == 0) {
+        return {0, 0};
+    }
+
+    // La conversion d'un réel hors des valeurs d'un int n'est pas définie : le quotient est d'abord borné
+    auto coordinate = [chunkSize](double position) {
+        double quotient = std::floor(position / chunkSize);
+        if (std::isnan(quotient)) {
+            return 0;
+        }
+        return static_cast<int>(qBound<double>(std::numeric_limits<int>::min(), quotient, std::numeric_limits<int>::max()));
+    };
+    return {coordinate(x), coordinate(y)};
+}
+
+//! Retourne une clé unique pour une région, utilisable dans un QHash
+//! \param chunk Les coordonnées de la région
+quint64 LevelFile::chunkKey(QPoint chunk) {
+    return static_cast<quint64>(static_cast<quint32>(chunk.x())) << 32 | static_cast<quint32>(chunk.y());
+}
+
+//! Lit un niveau au format binaire
+//! \param data Les données du fichier
+//! \param size La taille des données
+//! \param level Reçoit le contenu du niveau
+//! \param pError Reçoit la description de l'erreur, si non nul
+//! \return true si les données sont un niveau binaire valide
+bool LevelFile::fromBinary(const char* data, qsizetype size, LevelData& level, QString* pError) {
+    LevelFileView view;
+    return view.setData(data, size, pError) && fromView(view, level);
+}
+
+//! Copie le contenu d'une vue sur un niveau binaire
+//! \param view La vue, ouverte
+//! \param level Reçoit le contenu du niveau
+//! \return true
+bool LevelFile::fromView(const LevelFileView& view, LevelData& level) {
+    TRACE_SCOPE("LevelFile::fromView");
+
+    // Chaque chaîne n'est décodée qu'une fois, puis partagée entre les sprites
+    QStringList strings;
+    strings.reserve(view.stringCount());
+    for (quint32 i = 0; i < view.stringCount(); i++) {
+        strings.append(view.string(i));
+    }
+    auto stringAt = [&strings](quint32 index) -> QString {
+        return index < static_cast<quint32>(strings.size()) ? strings[index] : QString();
+    };
+
+    level = LevelData();
+    level.sceneSize = view.sceneSize();
+    level.background = stringAt(view.backgroundIndex());
+    level.historyToken = stringAt(view.historyTokenIndex());
+
+    // Tags du niveau
+    level.tags.reserve(view.tagCount());
+    for (quint32 i = 0; i < view.tagCount(); i++) {
+        level.tags.append(stringAt(view.tagIndex(i)));
+    }
+
+    // Sprites. La table des textures est construite à partir des chaînes utilisées comme texture
+    QVector<qint32> stringTextureIndices(view.stringCount(), -1); // Index dans la table des textures, par index de chaîne
+    level.sprites.resize(view.spriteCount());
+    for (quint32 i = 0; i < view.spriteCount(); i++) {
+        LevelFileView::SpriteRecord record = view.sprite(i);
+        LevelSprite& sprite = level.sprites[i];
+        quint32 textureStringIndex = record.textureIndex();
+        if (textureStringIndex < view.stringCount()) {
+            if (stringTextureIndices[textureStringIndex] < 0) {
+                stringTextureIndices[textureStringIndex] = static_cast<qint32>(level.textures.size());
+                level.textures.append(strings[textureStringIndex]);
+            }
+            sprite.textureIndex = stringTextureIndices[textureStringIndex];
+        }
+        sprite.id = record.id();
+        sprite.x = record.x();
+        sprite.y = record.y();
+        sprite.rotation = record.rotation();
+        sprite.scale = record.scale();
+        sprite.opacity = record.opacity();
+        sprite.z = record.z();
+        sprite.texturePath = stringAt(record.textureIndex());
+        sprite.tag = stringAt(record.tagIndex());
+    }
+
+    return true;
+}
+
+/*****************
+ * LevelTextureTable
+ *****************/
+
+//! Constructeur
+//! \param textures La table de départ. Un chemin qui y figure plusieurs fois garde son premier index
+LevelTextureTable::LevelTextureTable(const QStringList& textures) : m_textures(textures) {
+    m_indices.reserve(textures.size());
+    for (qsizetype i = 0; i < textures.size(); i++) {
+        if (!m_indices.contains(textures[i])) {
+            m_indices.insert(textures[i], static_cast<qint32>(i));
+        }
+    }
+}
+
+//! Retourne l'index d'une texture, en l'ajoutant à la table si elle n'y figure pas
+//! \param texturePath Le chemin de la texture
+qint32 LevelTextureTable::indexOf(const QString& texturePath) {
+    auto it = m_indices.constFind(texturePath);
+    if (it != m_indices.constEnd()) {
+        return it.value();
+    }
+    auto index = static_cast<qint32>(m_textures.size());
+    m_indices.insert(texturePath, index);
+    m_textures.append(texturePath);
+    return index;
+}
+
+//! Retourne l'index de la texture d'un sprite. L'index du sprite est conservé s'il désigne bien sa texture
+//! \param sprite Le sprite
+qint32 LevelTextureTable::indexOf(const LevelSprite& sprite) {
+    qint32 index = find(sprite);
+    return index >= 0 ? index : indexOf(sprite.texturePath);
+}
+
+//! Retourne l'index de la texture d'un sprite, sans modifier la table
+//! \param sprite Le sprite
+//! \return L'index, ou -1 si la texture ne figure pas dans la table
+qint32 LevelTextureTable::find(const LevelSprite& sprite) const {
+    if (contains(sprite.textureIndex) && m_textures[sprite.textureIndex] == sprite.texturePath) {
+        return sprite.textureIndex;
+    }
+    return m_indices.value(sprite.texturePath, -1);
+}
+
+/*****************
+ * LevelFileView
+ *****************/
+
+LevelFileView::~LevelFileView() {
+    close();
+}
+
+//! Projette un fichier de niveau binaire en mémoire et l'ouvre
+//! \param filePath Le chemin du fichier
+//! \param pError Reçoit la description de l'erreur, si non nul
+//! \return true si le fichier est un niveau binaire valide
+bool LevelFileView::map(const QString& filePath, QString* pError) {
+    close();
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        if (pError != nullptr) {
+            *pError = "Impossible d'ouvrir le fichier " + filePath;
+        }
+        return false;
+    }
+
+    m_pMapping = m_file.map(0, m_file.size());
+    if (m_pMapping == nullptr) {
+        if (pError != nullptr) {
+            *pError = "Impossible de projeter le fichier " + filePath + " en mémoire";
+        }
+        m_file.close();
+        return false;
+    }
+
+    if (!setData(reinterpret_cast<const char*>(m_pMapping), m_file.size(), pError)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+//! Ouvre la vue sur des données en mémoire, qui doivent rester valides tant que la vue est utilisée
+//! L'en-tête et la table des chaînes sont vérifiés
+//! \param data Les données du niveau
+//! \param size La taille des données
+//! \param pError Reçoit la description de l'erreur, si non nul
+//! \return true si les données sont un niveau binaire valide
+bool LevelFileView::setData(const char* data, qsizetype size, QString* pError) {
+    TRACE_SCOPE("LevelFileView::setData");
+
+    auto fail = [this, pError](const QString& error) {
+        if (pError != nullptr) {
+            *pError = error;
+        }
+        m_pData = nullptr;
+        return false;
+    };
+
+    if (!LevelFile::isBinary(data, size)) {
+        return fail("Le fichier n'est pas un niveau binaire");
+    }
+    quint16 version = readLittleEndian<quint16>(data, 4);
+    if (version < LevelFile::MIN_VERSION || version > LevelFile::VERSION) {
+        return fail("Version de niveau binaire non prise en charge");
+    }
+    quint16 options = readLittleEndian<quint16>(data, 6);
+
+    m_sceneSize = QSize(readLittleEndian<qint32>(data, 8), readLittleEndian<qint32>(data, 12));
+    m_backgroundIndex = readLittleEndian<quint32>(data, 16);
+    m_historyTokenIndex = readLittleEndian<quint32>(data, 20);
+    quint32 stringCount = readLittleEndian<quint32>(data, 24);
+    m_tagCount = readLittleEndian<quint32>(data, 28);
+    m_spriteCount = readLittleEndian<quint32>(data, 32);
+    quint32 stringTableSize = readLittleEndian<quint32>(data, 36);
+
+    // Les tailles annoncées doivent correspondre exactement à la taille des données
+    m_hasFloatSprites = version < LevelFile::DOUBLE_SPRITE_VERSION;
+    qint64 expectedSize = LevelFile::HEADER_SIZE + static_cast<qint64>(stringTableSize) + static_cast<qint64>(m_tagCount) * 4
+                        + static_cast<qint64>(m_spriteCount) * spriteRecordSize();
+    m_chunkSize = 0;
+    m_chunkCount = 0;
+    if (version >= 2 && (options & LevelFile::CHUNKED_OPTION) != 0) { // Section des régions, après les sprites
+        if (expectedSize + LevelFile::CHUNK_SECTION_HEADER_SIZE > size) {
+            return fail("Niveau binaire tronqué ou corrompu");
+        }
+        m_chunksOffset = expectedSize + LevelFile::CHUNK_SECTION_HEADER_SIZE;
+        m_chunkSize = readLittleEndian<quint32>(data, expectedSize);
+        if (m_chunkSize == 0) {
+            return fail("Taille des régions invalide");
+        }
+        m_chunkCount = readLittleEndian<quint32>(data, expectedSize + 4);
+        m_chunkSpritesOffset = m_chunksOffset + static_cast<qint64>(m_chunkCount) * LevelFile::CHUNK_RECORD_SIZE;
+        expectedSize = m_chunkSpritesOffset + static_cast<qint64>(m_spriteCount) * 4;
+    }
+    if (expectedSize != size) {
+        return fail("Niveau binaire tronqué ou corrompu");
+    }
+    for (quint32 i = 0; i < m_chunkCount; i++) { // Les sprites de chaque région doivent être dans l'index des sprites
+        qsizetype chunkOffset = m_chunksOffset + static_cast<qsizetype>(i) * LevelFile::CHUNK_RECORD_SIZE;
+        quint64 chunkEnd = static_cast<quint64>(readLittleEndian<quint32>(data, chunkOffset + 8))
+                         + readLittleEndian<quint32>(data, chunkOffset + 12);
+        if (chunkEnd > m_spriteCount) {
+            return fail("Table des régions corrompue");
+        }
+    }
+    if (m_chunkSize != 0) { // L'index des sprites ne doit contenir que des sprites du niveau
+        for (quint32 i = 0; i < m_spriteCount; i++) {
+            if (readLittleEndian<quint32>(data, m_chunkSpritesOffset + static_cast<qsizetype>(i) * 4) >= m_spriteCount) {
+                return fail("Index des sprites par région corrompu");
+            }
+        }
+    }
+
+    // Table des chaînes : on ne retient que la position et la taille de chaque chaîne
+    m_stringOffsets.clear();
+    m_stringLengths.clear();
+    m_stringOffsets.reserve(stringCount);
+    m_stringLengths.reserve(stringCount);
+    qsizetype offset = LevelFile::HEADER_SIZE;
+    qsizetype stringTableEnd = LevelFile::HEADER_SIZE + stringTableSize;
+    for (quint32 i = 0; i < stringCount; i++) {
+        if (offset + 4 > stringTableEnd) {
+            return fail("Table des chaînes corrompue");
+        }
+        quint32 length = readLittleEndian<quint32>(data, offset);
+        offset += 4;
+        if (length > static_cast<quint32>(stringTableEnd - offset)) {
+            return fail("Table des chaînes corrompue");
+        }
+        m_stringOffsets.append(offset);
+        m_stringLengths.append(length);
+        offset += length;
+    }
+    if (offset != stringTableEnd) {
+        return fail("Table des chaînes corrompue");
+    }
+
+    m_tagsOffset = stringTableEnd;
+    m_spritesOffset = m_tagsOffset + static_cast<qsizetype>(m_tagCount) * 4;
+    m_pData = data;
+    m_size = size;
+    return true;
+}
+
+//! Ferme la vue et libère la projection du fichier, s'il y en a une
+void LevelFileView::close() {
+    m_pData = nullptr;
+    m_size = 0;
+    m_chunkSize = 0;
+    m_chunkCount = 0;
+    m_stringOffsets.clear();
+    m_stringLengths.clear();
+
+    if (m_pMapping != nullptr) {
+        m_file.unmap(m_pMapping);
+        m_pMapping = nullptr;
+    }
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+}
+
+//! Décode une chaîne de la table des chaînes
+//! \param index L'index de la chaîne
+//! \return La chaîne, vide si l'index vaut NO_STRING ou est invalide
+QString LevelFileView::string(quint32 index) const {
+    if (index >= stringCount()) {
+        return {};
+    }
+    return QString::fromUtf8(m_pData + m_stringOffsets[index], m_stringLengths[index]);
+}
+
+//! Retourne l'index, dans la table des chaînes, d'un tag du niveau
+//! \param index L'index du tag
+quint32 LevelFileView::tagIndex(quint32 index) const {
+    return readLittleEndian<quint32>(m_pData, m_tagsOffset + static_cast<qsizetype>(index) * 4);
+}
+
+//! Retourne l'enregistrement d'un sprite, lu sur place
+//! \param index L'index du sprite, inférieur à spriteCount()
+LevelFileView::SpriteRecord LevelFileView::sprite(quint32 index) const {
+    return SpriteRecord(m_pData + m_spritesOffset + static_cast<qsizetype>(index) * spriteRecordSize(), m_hasFloatSprites);
+}
+
+//! Retourne l'enregistrement d'une région, lu sur place
+//! \param index L'index de la région, inférieur à chunkCount()
+LevelFileView::ChunkRecord LevelFileView::chunk(quint32 index) const {
+    return ChunkRecord(m_pData + m_chunksOffset + static_cast<qsizetype>(index) * LevelFile::CHUNK_RECORD_SIZE);
+}
+
+//! Retourne l'index d'un sprite dans l'index des sprites par région
+//! \param index La position dans l'index, de ChunkRecord::firstSprite() à firstSprite() + spriteCount() exclu
+//! \return L'index du sprite, inférieur à spriteCount() (vérifié à l'ouverture)
+quint32 LevelFileView::chunkSpriteIndex(quint32 index) const {
+    return readLittleEndian<quint32>(m_pData, m_chunkSpritesOffset + static_cast<qsizetype>(index) * 4);
+}
+
+quint64 LevelFileView::SpriteRecord::id() const { return readLittleEndian<quint64>(m_pRecord, 0); }
+double LevelFileView::SpriteRecord::x() const { return readLittleEndian<double>(m_pRecord, 8); }
+double LevelFileView::SpriteRecord::y() const { return readLittleEndian<double>(m_pRecord, 16); }
+double LevelFileView::SpriteRecord::rotation() const { return readValue(0); }
+double LevelFileView::SpriteRecord::scale() const { return readValue(1); }
+double LevelFileView::SpriteRecord::opacity() const { return readValue(2); }
+double LevelFileView::SpriteRecord::z() const { return readValue(3); }
+quint32 LevelFileView::SpriteRecord::textureIndex() const { return readLittleEndian<quint32>(m_pRecord, m_isFloatRecord ? 40 : 56); }
+quint32 LevelFileView::SpriteRecord::tagIndex() const { return readLittleEndian<quint32>(m_pRecord, m_isFloatRecord ? 44 : 60); }
+
+//! Lit une des valeurs qui suivent la position (rotation, échelle, opacité, profondeur), dans la précision de l'enregistrement
+//! \param index La position de la valeur, de 0 (rotation) à 3 (profondeur)
+double LevelFileView::SpriteRecord::readValue(int index) const {
+    if (m_isFloatRecord) {
+        return readLittleEndian<float>(m_pRecord, 24 + index * 4);
+    }
+    return readLittleEndian<double>(m_pRecord, 24 + index * 8);
+}
+
+QPoint LevelFileView::ChunkRecord::coordinates() const {
+    return {readLittleEndian<qint32>(m_pRecord, 0), readLittleEndian<qint32>(m_pRecord, 4)};
+}
+quint32 LevelFileView::ChunkRecord::firstSprite() const { return readLittleEndian<quint32>(m_pRecord, 8); }
+quint32 LevelFileView::ChunkRecord::spriteCount() const { return readLittleEndian<quint32>(m_pRecord, 12); }
@@ -0,0 +1,242 @@
+/*
+ * @file LevelFile.h
+ * @brief Déclaration de la classe LevelFile.
+ * @author Noah Blattner
+ * @date Octobre 2026
+ */
+
+#ifndef WORLDBUILDR_LEVELFILE_H
+#define WORLDBUILDR_LEVELFILE_H
+
+#include <functional>
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QPoint>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class QIODevice;
+class LevelFileView;
+
+//! Sprite d'un niveau, tel qu'il est enregistré dans un fichier de niveau.
+//! Les chemins de texture sont relatifs au dossier des ressources.
+struct LevelSprite {
+    quint64 id = 0;
+    QString texturePath;
+    qint32 textureIndex = -1; // Index de la texture dans LevelData::textures, -1 si elle n'y est pas (encore) référencée
+    QString tag;
+    double x = 0;
+    double y = 0;
+    double rotation = 0;
+    double scale = 1;
+    double opacity = 1;
+    double z = 0;
+};
+
+//! Contenu d'un fichier de niveau, indépendant de son format.
+//! Après lecture, chaque sprite référence sa texture dans la table des textures (textures), qui donne aussi
+//! la liste des textures à charger.
+struct LevelData {
+    QSize sceneSize;
+    QString background; // Relatif au dossier des ressources
+    QString historyToken; // Utilisé par l'éditeur pour retrouver l'historique du niveau
+    QStringList tags;
+    QStringList textures; // Table des textures : chaque chemin n'y figure qu'une fois
+    QList<LevelSprite> sprites;
+};
+
+//! Construction de la table des textures d'un niveau : associe à chaque chemin de texture un index unique.
+//! Les index des sprites qui référencent déjà correctement leur texture sont conservés.
+class LevelTextureTable {
+public:
+    explicit LevelTextureTable(const QStringList& textures = QStringList());
+
+    qint32 indexOf(const QString& texturePath);
+    qint32 indexOf(const LevelSprite& sprite);
+    qint32 find(const LevelSprite& sprite) const;
+    bool contains(qint32 index) const { return index >= 0 && index < m_textures.size(); }
+
+    const QStringList& textures() const { return m_textures; }
+
+private:
+    QStringList m_textures;
+    QHash<QString, qint32> m_indices; // Index de chaque texture, par chemin
+};
+
+//! Lecture et écriture des fichiers de niveau, utilisée par l'éditeur et par LevelLoader.
+//!
+//! Deux formats sont pris en charge :
+//! - le format binaire (extension BINARY_EXTENSION), compact et rapide à lire ;
+//! - le format JSON (extension JSON_EXTENSION), lisible et conservé pour l'échange avec d'autres outils.
+//! La méthode readFile() reconnaît le format d'un fichier à son contenu. Les deux formats peuvent être
+//! compressés (voir LevelCompression) : readFile() les décompresse alors en mémoire avant de les lire.
+//! Pour lire un niveau binaire sans le copier en mémoire, voir LevelFileView ; pour l'écrire sans le construire
+//! en mémoire, voir writeBinary(). Pour écrire ou lire un niveau JSON sans construire de document JSON, voir
+//! LevelJsonWriter et LevelJsonReader.
+//!
+//! Le format binaire est composé, dans l'ordre, de :
+//! - un en-tête de taille fixe (HEADER_SIZE octets) : MAGIC, VERSION, options, taille de la scène, index de l'arrière-plan
+//!   et du jeton d'historique dans la table des chaînes, nombre de chaînes, de tags et de sprites, taille de la table des chaînes ;
+//! - la table des chaînes : chaque chemin de texture et chaque tag n'y est écrit qu'une fois (taille, puis UTF-8) ;
+//! - les tags du niveau, sous forme d'index dans la table des chaînes ;
+//! - les sprites, sous forme d'enregistrements de taille fixe (SPRITE_RECORD_SIZE octets) : identifiant, position,
+//!   rotation, échelle, opacité et profondeur en double précision, index de la texture et du tag. Jusqu'à la version 2,
+//!   la rotation, l'échelle, l'opacité et la profondeur étaient en simple précision (FLOAT_SPRITE_RECORD_SIZE octets) :
+//!   ces niveaux restent lisibles ;
+//! - les régions (option CHUNKED_OPTION) : la scène est découpée en régions carrées de même taille, et chaque sprite
+//!   appartient à la région qui contient sa position. Cette section contient la taille et le nombre des régions,
+//!   un enregistrement par région non vide (CHUNK_RECORD_SIZE octets : coordonnées, premier sprite et nombre de
+//!   sprites dans l'index), puis l'index des sprites, regroupés par région. L'ordre des sprites n'est pas modifié.
+//!   Elle permet de ne charger que les régions proches d'un point (voir LevelLoader::updateStreaming()).
+//! Au format JSON, les chemins de texture sont écrits une fois dans le tableau "textures", et chaque sprite
+//! y fait référence par son index ("texture"). Les fichiers plus anciens, où chaque sprite contient son
+//! chemin ("texturePath"), restent lisibles.
+//! Tous les entiers et réels sont écrits en petit-boutiste. Un index valant NO_STRING indique l'absence de chaîne.
+class LevelFile {
+public:
+    static const QString BINARY_EXTENSION;
+    static const QString JSON_EXTENSION;
+
+    static bool readFile(const QString& filePath, LevelData& level, QString* pError = nullptr);
+    static void indexTextures(LevelData& level);
+
+    static bool isBinary(const char* data, qsizetype size);
+    static bool isBinaryFile(const QString& filePath);
+    static constexpr quint32 DEFAULT_CHUNK_SIZE = 1024; // Taille des régions, en unités de la scène
+
+    static QByteArray toBinary(const LevelData& level, quint32 chunkSize = DEFAULT_CHUNK_SIZE);
+    static bool writeBinary(QIODevice* pDevice, const LevelData& level, quint32 chunkSize = DEFAULT_CHUNK_SIZE,
+                            const std::function<void(qsizetype)>& onProgress = {});
+    static bool fromBinary(const char* data, qsizetype size, LevelData& level, QString* pError = nullptr);
+
+    static QPoint chunkAt(double x, double y, quint32 chunkSize);
+    static quint64 chunkKey(QPoint chunk);
+
+private:
+    friend class LevelFileView;
+
+    static bool fromView(const LevelFileView& view, LevelData& level);
+    static bool readJson(QIODevice* pDevice, LevelData& level, QString* pError);
+
+    static constexpr quint32 MAGIC = 0x564c4257; // Octets "WBLV"
+    static constexpr quint16 VERSION = 3;
+    static constexpr quint16 MIN_VERSION = 1; // Les niveaux de version 1 n'ont pas de section des régions
+    static constexpr quint16 DOUBLE_SPRITE_VERSION = 3; // Première version dont les sprites sont en double précision
+    static constexpr quint16 CHUNKED_OPTION = 0x1; // Option de l'en-tête : le niveau contient la section des régions
+    static constexpr quint32 NO_STRING = 0xffffffff;
+    static constexpr qsizetype HEADER_SIZE = 40;
+    static constexpr qsizetype SPRITE_RECORD_SIZE = 64;
+    static constexpr qsizetype FLOAT_SPRITE_RECORD_SIZE = 48; // Versions antérieures à DOUBLE_SPRITE_VERSION
+    static constexpr qsizetype CHUNK_SECTION_HEADER_SIZE = 8;
+    static constexpr qsizetype CHUNK_RECORD_SIZE = 16;
+    static constexpr qsizetype BINARY_WRITE_BLOCK_SIZE = 64 * 1024; // Taille des blocs écrits par writeBinary()
+};
+
+//! Vue en lecture seule sur un niveau binaire, sans copie : les sprites sont lus directement dans les données du fichier.
+//!
+//! La méthode map() projette un fichier en mémoire (QFile::map()) ; la méthode setData() utilise des données
+//! déjà en mémoire, qui doivent rester valides tant que la vue est utilisée.
+//! L'en-tête et la table des chaînes sont vérifiés à l'ouverture. Seule la position de chaque chaîne est retenue :
+//! string() décode une chaîne à la demande. sprite() retourne un enregistrement lu sur place (SpriteRecord).
+class LevelFileView {
+public:
+    //! Enregistrement d'un sprite, lu directement dans les données du niveau.
+    //! Les enregistrements des niveaux antérieurs à la version 3 (simple précision) sont convertis à la lecture
+    class SpriteRecord {
+    public:
+        SpriteRecord(const char* pRecord, bool isFloatRecord) : m_pRecord(pRecord), m_isFloatRecord(isFloatRecord) { }
+
+        quint64 id() const;
+        double x() const;
+        double y() const;
+        double rotation() const;
+        double scale() const;
+        double opacity() const;
+        double z() const;
+        quint32 textureIndex() const;
+        quint32 tagIndex() const;
+
+    private:
+        double readValue(int index) const;
+
+        const char* m_pRecord;
+        bool m_isFloatRecord;
+    };
+
+    //! Enregistrement d'une région, lu directement dans les données du niveau
+    class ChunkRecord {
+    public:
+        explicit ChunkRecord(const char* pRecord) : m_pRecord(pRecord) { }
+
+        QPoint coordinates() const;
+        quint32 firstSprite() const; // Position du premier sprite de la région dans l'index des sprites (chunkSpriteIndex())
+        quint32 spriteCount() const;
+
+    private:
+        const char* m_pRecord;
+    };
+
+    LevelFileView() = default;
+    ~LevelFileView();
+
+    LevelFileView(const LevelFileView&) = delete;
+    LevelFileView& operator=(const LevelFileView&) = delete;
+
+    bool map(const QString& filePath, QString* pError = nullptr);
+    bool setData(const char* data, qsizetype size, QString* pError = nullptr);
+    void close();
+    bool isOpen() const { return m_pData != nullptr; }
+
+    QSize sceneSize() const { return m_sceneSize; }
+    quint32 backgroundIndex() const { return m_backgroundIndex; }
+    quint32 historyTokenIndex() const { return m_historyTokenIndex; }
+
+    quint32 stringCount() const { return static_cast<quint32>(m_stringOffsets.size()); }
+    QString string(quint32 index) const;
+
+    quint32 tagCount() const { return m_tagCount; }
+    quint32 tagIndex(quint32 index) const;
+
+    quint32 spriteCount() const { return m_spriteCount; }
+    SpriteRecord sprite(quint32 index) const;
+
+    bool hasChunks() const { return m_chunkSize != 0; }
+    quint32 chunkSize() const { return m_chunkSize; }
+    quint32 chunkCount() const { return m_chunkCount; }
+    ChunkRecord chunk(quint32 index) const;
+    quint32 chunkSpriteIndex(quint32 index) const;
+
+private:
+    qsizetype spriteRecordSize() const {
+        return m_hasFloatSprites ? LevelFile::FLOAT_SPRITE_RECORD_SIZE : LevelFile::SPRITE_RECORD_SIZE;
+    }
+
+    QFile m_file;
+    uchar* m_pMapping = nullptr;
+
+    const char* m_pData = nullptr;
+    qsizetype m_size = 0;
+
+    QSize m_sceneSize;
+    quint32 m_backgroundIndex = LevelFile::NO_STRING;
+    quint32 m_historyTokenIndex = LevelFile::NO_STRING;
+    QVector<qsizetype> m_stringOffsets; // Position de chaque chaîne (après sa taille) dans les données
+    QVector<quint32> m_stringLengths;
+    qsizetype m_tagsOffset = 0;
+    quint32 m_tagCount = 0;
+    qsizetype m_spritesOffset = 0;
+    quint32 m_spriteCount = 0;
+    bool m_hasFloatSprites = false; // Niveau antérieur à la version 3 : sprites en simple précision
+    qsizetype m_chunksOffset = 0;
+    qsizetype m_chunkSpritesOffset = 0;
+    quint32 m_chunkSize = 0; // 0 si le niveau n'a pas de section des régions
+    quint32 m_chunkCount = 0;
+};
+
+
+#endif //WORLDBUILDR_LEVELFILE_H
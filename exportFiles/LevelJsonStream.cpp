@@ -0,0 +1,586 @@
+/*
+ * @file LevelJsonStream.cpp
+ * @brief Définition des classes LevelJsonWriter et LevelJsonReader.
+ * @author Noah Blattner
+ * @date Octobre 2026
+ */
+
+#include <cctype>
+#include <cmath>
+#include <limits>
+
+#include <QIODevice>
+#include <QLocale>
+#include "LevelJsonStream.h"
+#include "tracing.h"
+
+/*****************
+ * LevelJsonWriter
+ *****************/
+
+//! Constructeur
+//! \param pDevice Le périphérique dans lequel écrire, ouvert en écriture
+LevelJsonWriter::LevelJsonWriter(QIODevice* pDevice) : m_pDevice(pDevice) {
+    m_buffer.reserve(FLUSH_THRESHOLD + 1024);
+}
+
+//! Écrit les champs du niveau et la table des textures, puis ouvre la liste des sprites
+//! \param level Le niveau. Ses sprites ne sont utilisés que pour compléter la table des textures :
+//! ils doivent être écrits avec writeSprite()
+void LevelJsonWriter::writeHeader(const LevelData& level) {
+    m_textureTable = LevelTextureTable(level.textures);
+    for (const LevelSprite& sprite : level.sprites) {
+        m_textureTable.indexOf(sprite);
+    }
+
+    m_buffer.append("{\n");
+
+    writeKey("tags");
+    m_buffer.append('[');
+    for (qsizetype i = 0; i < level.tags.size(); i++) {
+        if (i > 0) {
+            m_buffer.append(", ");
+        }
+        writeString(level.tags[i]);
+    }
+    m_buffer.append("],\n");
+
+    writeKey("sceneWidth");
+    m_buffer.append(QByteArray::number(level.sceneSize.width())).append(",\n");
+    writeKey("sceneHeight");
+    m_buffer.append(QByteArray::number(level.sceneSize.height())).append(",\n");
+    writeKey("background");
+    writeString(level.background);
+    m_buffer.append(",\n");
+    if (!level.historyToken.isEmpty()) {
+        writeKey("historyToken");
+        writeString(level.historyToken);
+        m_buffer.append(",\n");
+    }
+
+    writeKey("textures");
+    m_buffer.append('[');
+    const QStringList& textures = m_textureTable.textures();
+    for (qsizetype i = 0; i < textures.size(); i++) {
+        m_buffer.append(i > 0 ? ",\n        " : "\n        ");
+        writeString(textures[i]);
+    }
+    m_buffer.append(textures.isEmpty() ? "],\n" : "\n    ],\n");
+
+    writeKey("sprites");
+    m_buffer.append('[');
+    m_firstSprite = true;
+}
+
+//! Écrit un sprite à la suite de la liste des sprites
+//! \param sprite Le sprite
+void LevelJsonWriter::writeSprite(const LevelSprite& sprite) {
+    m_buffer.append(m_firstSprite ? "\n        {" : ",\n        {");
+    m_firstSprite = false;
+
+    m_buffer.append("\"x\": ");
+    writeNumber(sprite.x);
+    m_buffer.append(", \"y\": ");
+    writeNumber(sprite.y);
+    m_buffer.append(", \"scale\": ");
+    writeNumber(sprite.scale);
+    qint32 textureIndex = m_textureTable.find(sprite);
+    if (textureIndex >= 0) {
+        m_buffer.append(", \"texture\": ");
+        m_buffer.append(QByteArray::number(textureIndex));
+    } else { // Texture absente de la table écrite : son chemin est écrit dans le sprite
+        m_buffer.append(", \"texturePath\": ");
+        writeString(sprite.texturePath);
+    }
+    m_buffer.append(", \"rotation\": ");
+    writeNumber(sprite.rotation);
+    m_buffer.append(", \"opacity\": ");
+    writeNumber(sprite.opacity);
+    m_buffer.append(", \"z\": ");
+    writeNumber(sprite.z);
+    m_buffer.append(", \"tag\": ");
+    writeString(sprite.tag);
+    m_buffer.append(", \"id\": ");
+    m_buffer.append(QByteArray::number(static_cast<qint64>(sprite.id)));
+    m_buffer.append('}');
+
+    flush(FLUSH_THRESHOLD);
+}
+
+//! Ferme la liste des sprites et le niveau, puis vide le tampon dans le périphérique
+//! \return true si toutes les écritures ont réussi
+bool LevelJsonWriter::finish() {
+    m_buffer.append(m_firstSprite ? "]\n}\n" : "\n    ]\n}\n");
+    flush(0);
+    return !m_error;
+}
+
+//! Écrit une clé d'objet, indentée
+//! \param key La clé
+void LevelJsonWriter::writeKey(const char* key) {
+    m_buffer.append("    \"").append(key).append("\": ");
+}
+
+//! Écrit une chaîne JSON, en échappant les caractères qui doivent l'être
+//! \param value La chaîne
+void LevelJsonWriter::writeString(const QString& value) {
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+
+    m_buffer.append('"');
+    const QByteArray utf8 = value.toUtf8();
+    for (char c : utf8) {
+        switch (c) {
+            case '"': m_buffer.append("\\\""); break;
+            case '\\': m_buffer.append("\\\\"); break;
+            case '\b': m_buffer.append("\\b"); break;
+            case '\f': m_buffer.append("\\f"); break;
+            case '\n': m_buffer.append("\\n"); break;
+            case '\r': m_buffer.append("\\r"); break;
+            case '\t': m_buffer.append("\\t"); break;
+            default:
+                if (static_cast<uchar>(c) < 0x20) { // Autres caractères de contrôle
+                    m_buffer.append("\\u00");
+                    m_buffer.append(HEX_DIGITS[static_cast<uchar>(c) >> 4]);
+                    m_buffer.append(HEX_DIGITS[static_cast<uchar>(c) & 0xf]);
+                } else {
+                    m_buffer.append(c);
+                }
+        }
+    }
+    m_buffer.append('"');
+}
+
+//! Écrit un nombre, avec la représentation la plus courte qui le conserve exactement
+//! \param value Le nombre. Une valeur non finie est écrite comme null, comme le fait QJsonDocument
+void LevelJsonWriter::writeNumber(double value) {
+    if (!std::isfinite(value)) {
+        m_buffer.append("null");
+        return;
+    }
+    m_buffer.append(QByteArray::number(value, 'g', QLocale::FloatingPointShortest));
+}
+
+//! Vide le tampon dans le périphérique s'il dépasse une taille donnée
+//! \param threshold La taille au-delà de laquelle le tampon est vidé
+void LevelJsonWriter::flush(qsizetype threshold) {
+    if (m_buffer.size() <= threshold) {
+        return;
+    }
+    if (m_pDevice->write(m_buffer) != m_buffer.size()) {
+        m_error = true;
+    }
+    m_buffer.clear(); // La capacité est conservée
+}
+
+/*****************
+ * LevelJsonReader
+ *****************/
+
+//! Constructeur
+//! \param pDevice Le périphérique à lire, ouvert en lecture
+LevelJsonReader::LevelJsonReader(QIODevice* pDevice) : m_pDevice(pDevice) {
+}
+
+//! Lit un objet JSON
+//! \param readMember Fonction appelée pour chaque membre avec sa clé. Elle doit lire la valeur du membre
+template <typename Function>
+bool LevelJsonReader::readObject(Function readMember) {
+    if (!expect('{')) {
+        return false;
+    }
+    skipWhitespace();
+    if (peek() == '}') {
+        m_position++;
+        return true;
+    }
+
+    while (true) {
+        QString key;
+        if (!readString(key) || !expect(':') || !readMember(key)) {
+            return false;
+        }
+        skipWhitespace();
+        char c = next();
+        if (c == '}') {
+            return true;
+        }
+        if (c != ',') {
+            return fail("',' ou '}' attendu");
+        }
+    }
+}
+
+//! Lit un tableau JSON
+//! \param readElement Fonction appelée pour chaque élément. Elle doit lire l'élément
+template <typename Function>
+bool LevelJsonReader::readArray(Function readElement) {
+    if (!expect('[')) {
+        return false;
+    }
+    skipWhitespace();
+    if (peek() == ']') {
+        m_position++;
+        return true;
+    }
+
+    while (true) {
+        if (!readElement()) {
+            return false;
+        }
+        skipWhitespace();
+        char c = next();
+        if (c == ']') {
+            return true;
+        }
+        if (c != ',') {
+            return fail("',' ou ']' attendu");
+        }
+    }
+}
+
+//! Lit un niveau
+//! Les sprites qui contiennent le chemin de leur texture (ancien format, "texturePath") sont transmis dès qu'ils sont lus.
+//! Un sprite qui référence sa texture par son index ("texture") ne peut l'être qu'une fois la table des textures lue :
+//! s'il la précède dans le fichier (comme dans les fichiers écrits par QJsonDocument, qui trie les clés), il est mis
+//! de côté avec les sprites qui le suivent, puis transmis dès la lecture de la table, ou à la fin du niveau
+//! \param level Reçoit les champs du niveau. Ses sprites ne sont pas modifiés
+//! \param onSprite Fonction appelée pour chaque sprite, dans l'ordre du fichier
+//! \return true si le niveau a pu être lu. Sinon, errorString() décrit l'erreur
+bool LevelJsonReader::read(LevelData& level, const std::function<void(const LevelSprite&)>& onSprite) {
+    TRACE_SCOPE("LevelJsonReader::read");
+
+    double sceneWidth = 0;
+    double sceneHeight = 0;
+    // Table des textures du niveau. Les chemins des sprites de l'ancien format lus avant la table du fichier y sont
+    // ajoutés en premier : leur index, déjà transmis, reste donc valide
+    LevelTextureTable textureTable;
+    QStringList fileTextures; // Table des textures du fichier, à laquelle font référence les index des sprites
+    bool texturesRead = false;
+    QList<LevelSprite> pendingSprites; // Sprites qui attendent la table des textures
+
+    // Complète le chemin ou l'index de texture d'un sprite, puis le transmet
+    auto resolveSprite = [&](LevelSprite& sprite) {
+        if (sprite.textureIndex >= 0) { // Texture référencée par son index dans la table du fichier
+            if (sprite.textureIndex >= fileTextures.size()) {
+                return fail("Index de texture invalide : " + QString::number(sprite.textureIndex));
+            }
+            sprite.texturePath = fileTextures[sprite.textureIndex];
+        }
+        sprite.textureIndex = textureTable.indexOf(sprite.texturePath);
+        onSprite(sprite);
+        return true;
+    };
+
+    auto resolvePendingSprites = [&]() {
+        for (LevelSprite& sprite : pendingSprites) {
+            if (!resolveSprite(sprite)) {
+                return false;
+            }
+        }
+        pendingSprites.clear();
+        return true;
+    };
+
+    bool ok = readObject([&](const QString& key) {
+        if (key == "tags") {
+            return readStringArray(level.tags);
+        } else if (key == "textures") {
+            if (!readStringArray(fileTextures)) {
+                return false;
+            }
+            for (const QString& texture : std::as_const(fileTextures)) {
+                textureTable.indexOf(texture);
+            }
+            texturesRead = true;
+            return resolvePendingSprites();
+        } else if (key == "sceneWidth") {
+            return readDouble(sceneWidth);
+        } else if (key == "sceneHeight") {
+            return readDouble(sceneHeight);
+        } else if (key == "background") {
+            return readString(level.background);
+        } else if (key == "historyToken") {
+            return readString(level.historyToken);
+        } else if (key == "sprites") {
+            return readArray([&]() {
+                LevelSprite sprite;
+                if (!readSprite(sprite)) {
+                    return false;
+                }
+                // La table des textures peut encore suivre : l'index sera vérifié à sa lecture.
+                // Les sprites suivants attendent aussi, pour être transmis dans l'ordre du fichier
+                if (!texturesRead && (sprite.textureIndex >= 0 || !pendingSprites.isEmpty())) {
+                    pendingSprites.append(sprite);
+                    return true;
+                }
+                return resolveSprite(sprite);
+            });
+        }
+        return skipValue();
+    });
+
+    // Sprites qui référencent une table des textures absente du fichier : leur index est forcément invalide
+    ok = ok && resolvePendingSprites();
+
+    level.sceneSize = QSize(static_cast<int>(sceneWidth), static_cast<int>(sceneHeight));
+    level.textures = textureTable.textures();
+    return ok;
+}
+
+//! Retourne le prochain caractère sans le consommer. Lit le bloc suivant si nécessaire
+//! \return Le caractère, ou '\0' à la fin du périphérique
+char LevelJsonReader::peek() {
+    if (m_position >= m_buffer.size()) {
+        m_buffer = m_pDevice->read(CHUNK_SIZE);
+        m_position = 0;
+        if (m_buffer.isEmpty()) {
+            return '\0';
+        }
+    }
+    return m_buffer[m_position];
+}
+
+//! Consomme et retourne le prochain caractère
+//! \return Le caractère, ou '\0' à la fin du périphérique
+char LevelJsonReader::next() {
+    char c = peek();
+    if (c != '\0') {
+        m_position++;
+    }
+    return c;
+}
+
+//! Ignore les espaces, tabulations et retours à la ligne
+void LevelJsonReader::skipWhitespace() {
+    char c = peek();
+    while (c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+        m_position++;
+        c = peek();
+    }
+}
+
+//! Consomme le caractère attendu, après d'éventuels espaces
+//! \param expected Le caractère attendu
+//! \return true si le caractère suivant est celui attendu
+bool LevelJsonReader::expect(char expected) {
+    skipWhitespace();
+    if (next() != expected) {
+        return fail(QString("'%1' attendu").arg(expected));
+    }
+    return true;
+}
+
+//! Lit une chaîne JSON et décode ses séquences d'échappement
+//! \param value Reçoit la chaîne
+bool LevelJsonReader::readString(QString& value) {
+    if (!expect('"')) {
+        return false;
+    }
+
+    QByteArray utf8;
+    while (true) {
+        char c = next();
+        if (c == '"') {
+            break;
+        }
+        if (c == '\0') {
+            return fail("Chaîne non terminée");
+        }
+        if (c != '\\') {
+            utf8.append(c);
+            continue;
+        }
+
+        // Séquence d'échappement
+        c = next();
+        switch (c) {
+            case '"': case '\\': case '/': utf8.append(c); break;
+            case 'b': utf8.append('\b'); break;
+            case 'f': utf8.append('\f'); break;
+            case 'n': utf8.append('\n'); break;
+            case 'r': utf8.append('\r'); break;
+            case 't': utf8.append('\t'); break;
+            case 'u': {
+                auto readCodeUnit = [this](char32_t& codeUnit) {
+                    codeUnit = 0;
+                    for (int i = 0; i < 4; i++) {
+                        int digit = std::tolower(static_cast<uchar>(next()));
+                        if (!std::isxdigit(digit)) {
+                            return false;
+                        }
+                        codeUnit = (codeUnit << 4) | static_cast<char32_t>(digit <= '9' ? digit - '0' : digit - 'a' + 10);
+                    }
+                    return true;
+                };
+
+                char32_t codePoint = 0;
+                if (!readCodeUnit(codePoint)) {
+                    return fail("Séquence \\u invalide");
+                }
+                if (QChar::isHighSurrogate(codePoint)) { // Caractère codé sur deux unités UTF-16
+                    char32_t low = 0;
+                    if (next() != '\\' || next() != 'u' || !readCodeUnit(low) || !QChar::isLowSurrogate(low)) {
+                        return fail("Séquence \\u invalide");
+                    }
+                    codePoint = QChar::surrogateToUcs4(static_cast<char16_t>(codePoint), static_cast<char16_t>(low));
+                }
+                utf8.append(QString::fromUcs4(&codePoint, 1).toUtf8());
+                break;
+            }
+            default:
+                return fail("Séquence d'échappement invalide");
+        }
+    }
+
+    value = QString::fromUtf8(utf8);
+    return true;
+}
+
+//! Lit le texte d'un nombre JSON, sans le convertir
+//! \param token Reçoit le texte du nombre
+bool LevelJsonReader::readNumber(QByteArray& token) {
+    skipWhitespace();
+    token.clear();
+    char c = peek();
+    while (c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E' || (c >= '0' && c <= '9')) {
+        token.append(c);
+        m_position++;
+        c = peek();
+    }
+    if (token.isEmpty()) {
+        return fail("Nombre attendu");
+    }
+    return true;
+}
+
+//! Lit un nombre réel. La valeur null est acceptée et laisse la valeur inchangée
+//! \param value Reçoit le nombre
+bool LevelJsonReader::readDouble(double& value) {
+    skipWhitespace();
+    if (peek() == 'n') {
+        return readLiteral("null");
+    }
+
+    QByteArray token;
+    if (!readNumber(token)) {
+        return false;
+    }
+    bool ok = false;
+    double number = token.toDouble(&ok);
+    if (!ok) {
+        return fail("Nombre invalide : " + QString::fromLatin1(token));
+    }
+    value = number;
+    return true;
+}
+
+//! Lit un littéral JSON (true, false ou null)
+//! \param literal Le littéral attendu
+bool LevelJsonReader::readLiteral(const char* literal) {
+    skipWhitespace();
+    for (const char* c = literal; *c != '\0'; c++) {
+        if (next() != *c) {
+            return fail(QString("'%1' attendu").arg(QString::fromLatin1(literal)));
+        }
+    }
+    return true;
+}
+
+//! Lit un tableau de chaînes
+//! \param values Reçoit les chaînes, à la suite de celles qu'il contient déjà
+bool LevelJsonReader::readStringArray(QStringList& values) {
+    return readArray([&]() {
+        QString value;
+        if (!readString(value)) {
+            return false;
+        }
+        values.append(value);
+        return true;
+    });
+}
+
+//! Lit un sprite. Les champs absents gardent leur valeur par défaut
+//! \param sprite Reçoit le sprite
+bool LevelJsonReader::readSprite(LevelSprite& sprite) {
+    return readObject([&](const QString& key) {
+        if (key == "x") {
+            return readDouble(sprite.x);
+        } else if (key == "y") {
+            return readDouble(sprite.y);
+        } else if (key == "rotation") {
+            return readDouble(sprite.rotation);
+        } else if (key == "scale") {
+            return readDouble(sprite.scale);
+        } else if (key == "opacity") {
+            return readDouble(sprite.opacity);
+        } else if (key == "z") {
+            return readDouble(sprite.z);
+        } else if (key == "texture") {
+            double textureIndex = -1;
+            if (!readDouble(textureIndex)) {
+                return false;
+            }
+            if (textureIndex < 0 || textureIndex > std::numeric_limits<qint32>::max()
+                || textureIndex != std::floor(textureIndex)) {
+                return fail("Index de texture invalide : " + QString::number(textureIndex));
+            }
+            sprite.textureIndex = static_cast<qint32>(textureIndex);
+            return true;
+        } else if (key == "texturePath") {
+            return readString(sprite.texturePath);
+        } else if (key == "tag") {
+            return readString(sprite.tag);
+        } else if (key == "id") {
+            skipWhitespace();
+            if (peek() == 'n') {
+                return readLiteral("null");
+            }
+            QByteArray token;
+            if (!readNumber(token)) {
+                return false;
+            }
+            bool ok = false;
+            sprite.id = static_cast<quint64>(token.toLongLong(&ok));
+            if (!ok) { // L'identifiant n'est pas écrit comme un entier
+                sprite.id = static_cast<quint64>(token.toDouble(&ok));
+            }
+            return ok || fail("Identifiant invalide : " + QString::fromLatin1(token));
+        }
+        return skipValue();
+    });
+}
+
+//! Ignore une valeur JSON quelconque
+bool LevelJsonReader::skipValue() {
+    skipWhitespace();
+    switch (peek()) {
+        case '{':
+            return readObject([this](const QString&) { return skipValue(); });
+        case '[':
+            return readArray([this]() { return skipValue(); });
+        case '"': {
+            QString ignored;
+            return readString(ignored);
+        }
+        case 't':
+            return readLiteral("true");
+        case 'f':
+            return readLiteral("false");
+        case 'n':
+            return readLiteral("null");
+        default: {
+            QByteArray ignored;
+            return readNumber(ignored);
+        }
+    }
+}
+
+//! Enregistre une erreur de lecture
+//! \param error La description de l'erreur
+//! \return false
+bool LevelJsonReader::fail(const QString& error) {
+    if (m_error.isEmpty()) { // On conserve la première erreur, la plus précise
+        m_error = "Fichier de niveau invalide : " + error;
+    }
+    return false;
+}
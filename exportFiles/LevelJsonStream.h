@@ -0,0 +1,100 @@
+/*
+ * @file LevelJsonStream.h
+ * @brief Déclaration des classes LevelJsonWriter et LevelJsonReader.
+ * @author Noah Blattner
+ * @date Octobre 2026
+ */
+
+#ifndef WORLDBUILDR_LEVELJSONSTREAM_H
+#define WORLDBUILDR_LEVELJSONSTREAM_H
+
+#include <functional>
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
+#include "LevelFile.h"
+
+class QIODevice;
+
+//! Écriture d'un niveau au format JSON, sprite par sprite, directement dans un périphérique (un fichier, par exemple).
+//!
+//! Aucun document JSON n'est construit en mémoire : chaque sprite est formaté dans un petit tampon,
+//! vidé dans le périphérique dès qu'il dépasse FLUSH_THRESHOLD octets.
+//! La mémoire utilisée ne dépend donc pas de la taille du niveau.
+//!
+//! Utilisation : writeHeader(), puis writeSprite() pour chaque sprite, puis finish().
+//! La table des textures est écrite par writeHeader() ; chaque sprite y fait ensuite référence par son index.
+//! Le fichier produit est lisible par LevelJsonReader.
+class LevelJsonWriter {
+public:
+    explicit LevelJsonWriter(QIODevice* pDevice);
+
+    void writeHeader(const LevelData& level);
+    void writeSprite(const LevelSprite& sprite);
+    bool finish();
+
+private:
+    void writeKey(const char* key);
+    void writeString(const QString& value);
+    void writeNumber(double value);
+    void flush(qsizetype threshold);
+
+    static constexpr qsizetype FLUSH_THRESHOLD = 64 * 1024;
+
+    QIODevice* m_pDevice;
+    QByteArray m_buffer;
+    LevelTextureTable m_textureTable; // Table écrite par writeHeader()
+    bool m_firstSprite = true;
+    bool m_error = false;
+};
+
+//! Lecture d'un niveau au format JSON, au fil de l'eau (analyseur à la demande).
+//!
+//! Le fichier est lu par blocs de CHUNK_SIZE octets et analysé au fur et à mesure : aucun document JSON
+//! n'est construit en mémoire. Chaque sprite est transmis à la fonction fournie à read() dès qu'il est lu ;
+//! les autres champs du niveau (taille de la scène, arrière-plan, tags...) sont rangés dans le niveau.
+//! Les champs inconnus sont ignorés.
+//! Les sprites transmis ont toujours leur chemin de texture et leur index dans la table des textures du niveau,
+//! qu'ils fassent référence à la table ("texture") ou qu'ils contiennent leur chemin (ancien format, "texturePath").
+//! Un sprite qui référence la table des textures avant qu'elle soit lue est transmis, avec ceux qui le suivent,
+//! une fois la table lue.
+class LevelJsonReader {
+public:
+    explicit LevelJsonReader(QIODevice* pDevice);
+
+    bool read(LevelData& level, const std::function<void(const LevelSprite&)>& onSprite);
+    QString errorString() const { return m_error; }
+
+private:
+    char peek();
+    char next();
+    void skipWhitespace();
+    bool expect(char expected);
+
+    bool readString(QString& value);
+    bool readNumber(QByteArray& token);
+    bool readDouble(double& value);
+    bool readLiteral(const char* literal);
+    bool readStringArray(QStringList& values);
+    bool readSprite(LevelSprite& sprite);
+    bool skipValue();
+
+    template <typename Function>
+    bool readObject(Function readMember);
+    template <typename Function>
+    bool readArray(Function readElement);
+
+    bool fail(const QString& error);
+
+    static constexpr qint64 CHUNK_SIZE = 64 * 1024;
+
+    QIODevice* m_pDevice;
+    QByteArray m_buffer;
+    qsizetype m_position = 0;
+    QString m_error;
+};
+
+
+#endif //WORLDBUILDR_LEVELJSONSTREAM_H
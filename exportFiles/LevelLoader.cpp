@@ -5,34 +5,79 @@
  * @date Février 2023
  */
 
+#include <cmath>
+
+#include <QBuffer>
 #include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
 #include <QMessageBox>
-#include <QJsonObject>
-#include <QJsonDocument>
-#include <QJsonArray>
+#include <QVector>
 #include "LevelLoader.h"
+#include "LevelCompression.h"
+#include "LevelJsonStream.h"
+#include "TextureLoader.h"
 #include "gamescene.h"
 #include "sprite.h"
 #include "resources.h"
+#include "tracing.h"
 
 //! Constructeur
 //! \param scene La scène dans laquelle charger les niveaux
 //! \param levelsPath Le chemin des niveaux
-LevelLoader::LevelLoader(GameScene* scene, QString levelsPath) {
+//! \param pParent L'objet parent
+LevelLoader::LevelLoader(GameScene* scene, QString levelsPath, QObject* pParent) : QObject(pParent) {
     m_pScene = scene;
     m_levelsPath = std::move(levelsPath);
+
+    m_loadTimer.setInterval(0);
+    connect(&m_loadTimer, &QTimer::timeout, this, &LevelLoader::loadSlice);
+}
+
+//! Destructeur. Les régions chargées par openStream() et les sprites d'un chargement incrémental inachevé
+//! appartiennent au chargeur : ils sont retirés de la scène et détruits. Les sprites des niveaux entièrement
+//! chargés restent dans la scène, qui en est propriétaire
+LevelLoader::~LevelLoader() {
+    closeStream();
+    cancelLoading();
 }
 
 //! Charge un niveau dans la scène
+//! Le niveau peut être au format binaire ou JSON (voir LevelFile). Si le nom n'a pas d'extension,
+//! le fichier binaire est utilisé s'il existe, le fichier JSON sinon.
+//! Un niveau binaire est lu sur place, depuis une projection du fichier en mémoire (voir loadBinaryLevel()).
+//! Un niveau JSON est analysé au fil de la lecture (voir loadJsonLevel()).
+//! Un niveau compressé est reconnu à son en-tête et décompressé en mémoire (voir loadCompressedLevel()).
 //! \param scene La scène dans laquelle charger le niveau
 //! \param levelName Le nom du niveau
 //! \return La liste des sprites chargés
 QList<Sprite *> LevelLoader::loadLevel(const QString& levelName) {
+    TRACE_SCOPE("LevelLoader::loadLevel");
+
+    QString levelPath = levelFilePath(levelName);
+    if (levelPath.isEmpty()) { // Si le fichier n'existe pas
+        return {};
+    }
+
+    if (LevelCompression::fileCodec(levelPath) != LevelCompression::NoCodec) { // Si le niveau est compressé
+        return loadCompressedLevel(levelPath, levelName);
+    }
+    if (LevelFile::isBinaryFile(levelPath)) { // Si le niveau est au format binaire
+        return loadBinaryLevel(levelPath, levelName);
+    }
+    return loadJsonLevel(levelPath, levelName);
+}
+
+//! Retourne le chemin du fichier d'un niveau. Si le nom n'a pas d'extension,
+//! le fichier binaire est utilisé s'il existe, le fichier JSON sinon.
+//! \param levelName Le nom du niveau
+//! \return Le chemin du fichier, vide (après avoir affiché une erreur) si le fichier n'existe pas
+QString LevelLoader::levelFilePath(const QString& levelName) const {
     // Concaténation du chemin du niveau avec le nom du niveau
     QString levelPath = m_levelsPath + "/" + levelName;
 
-    if (!levelName.endsWith(".json")) { // Si le nom du niveau ne finit pas par .json
-        levelPath += ".json";
+    if (!levelName.endsWith(LevelFile::BINARY_EXTENSION) && !levelName.endsWith(LevelFile::JSON_EXTENSION)) { // Si le nom du niveau n'a pas d'extension
+        levelPath += QFile::exists(levelPath + LevelFile::BINARY_EXTENSION) ? LevelFile::BINARY_EXTENSION : LevelFile::JSON_EXTENSION;
     }
 
     levelPath = QDir::toNativeSeparators(levelPath);
@@ -42,56 +87,616 @@ QList<Sprite *> LevelLoader::loadLevel(const QString& levelName) {
         QMessageBox::critical(nullptr, "Erreur", "Le fichier de niveau " + levelName + " n'existe pas.");
         return {};
     }
+    return levelPath;
+}
+
+//! Charge un niveau compressé dans la scène
+//! Le fichier est décompressé en mémoire (LevelCompression), avec l'algorithme indiqué par son en-tête,
+//! puis lu comme un niveau binaire ou JSON.
+//! \param levelPath Le chemin du fichier
+//! \param levelName Le nom du niveau, pour les messages d'erreur
+//! \return La liste des sprites chargés
+QList<Sprite*> LevelLoader::loadCompressedLevel(const QString& levelPath, const QString& levelName) {
+    TRACE_SCOPE("LevelLoader::loadCompressedLevel");
 
     QFile file(levelPath);
     if (!file.open(QIODevice::ReadOnly)) { // Si on ne peut pas ouvrir le fichier
         // On affiche une erreur
-        QMessageBox::critical(nullptr, "Erreur", "Impossible d'ouvrir le fichier de niveau " + levelName + ".");
+        QMessageBox::critical(nullptr, "Erreur", "Impossible d'ouvrir le niveau " + levelName + ".");
         return {};
     }
-
-    // On prend les données du fichier et on le ferme
-    QJsonDocument jsonDocument = QJsonDocument::fromJson(file.readAll());
+    const QByteArray compressed = file.readAll();
     file.close();
 
-    // On récupère l'objet JSON
-    QJsonObject levelObject = jsonDocument.object();
+    QByteArray data;
+    QString error;
+    if (!LevelCompression::decompress(compressed.constData(), compressed.size(), data, &error)) { // Si le fichier est invalide
+        // On affiche une erreur
+        QMessageBox::critical(nullptr, "Erreur", "Impossible de charger le niveau " + levelName + " : " + error);
+        return {};
+    }
+
+    if (LevelFile::isBinary(data.constData(), data.size())) { // Si le niveau est au format binaire
+        LevelFileView view;
+        if (!view.setData(data.constData(), data.size(), &error)) { // Si les données sont invalides
+            // On affiche une erreur
+            QMessageBox::critical(nullptr, "Erreur", "Impossible de charger le niveau " + levelName + " : " + error);
+            return {};
+        }
+        return loadBinaryLevel(view);
+    }
+
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::ReadOnly);
+    return loadJsonLevel(&buffer, levelName);
+}
+
+//! Charge un niveau au format binaire dans la scène
+//! Le fichier est projeté en mémoire : les sprites sont lus directement dans ses enregistrements,
+//! sans passer par une copie du niveau (LevelData).
+//! \param levelPath Le chemin du fichier
+//! \param levelName Le nom du niveau, pour les messages d'erreur
+//! \return La liste des sprites chargés
+QList<Sprite*> LevelLoader::loadBinaryLevel(const QString& levelPath, const QString& levelName) {
+    TRACE_SCOPE("LevelLoader::loadBinaryLevel");
+
+    LevelFileView view;
+    QString error;
+    if (!view.map(levelPath, &error)) { // Si on ne peut pas lire le fichier
+        // On affiche une erreur
+        QMessageBox::critical(nullptr, "Erreur", "Impossible de charger le niveau " + levelName + " : " + error);
+        return {};
+    }
+
+    return loadBinaryLevel(view);
+}
 
+//! Charge un niveau binaire déjà ouvert dans la scène
+//! \param view La vue sur le niveau
+//! \return La liste des sprites chargés
+QList<Sprite*> LevelLoader::loadBinaryLevel(const LevelFileView& view) {
     // On charge l'arrière-plan
-    m_pScene->setBackgroundImage(QImage(GameFramework::resourcesPath() + levelObject["background"].toString()));
+    m_pScene->setBackgroundImage(QImage(GameFramework::resourcesPath() + view.string(view.backgroundIndex())));
 
     // On charge les sprites
-    return loadSprites(levelObject["sprites"].toArray());
+    return loadSprites(view);
 }
 
-//! Charge les sprites dans la scène
-//! \param scene La scène dans laquelle charger les sprites
-//! \param spritesArray Le tableau JSON des sprites
-QList<Sprite*> LevelLoader::loadSprites(const QJsonArray& spritesArray) {
+//! Charge les sprites d'un niveau binaire dans la scène
+//! Les textures sont d'abord décodées en parallèle (TextureLoader) : chaque texture est référencée par son index
+//! dans la table des chaînes et n'est décodée qu'une fois. Les sprites sont ensuite créés à partir des textures décodées.
+//! \param view La vue sur le niveau
+//! \return La liste des sprites chargés
+QList<Sprite*> LevelLoader::loadSprites(const LevelFileView& view) {
+    const QString resourcesPath = GameFramework::resourcesPath();
+
+    // Première passe : on demande le décodage de chaque texture utilisée
+    TextureLoader textureLoader;
+    QVector<int> textureIndices(view.stringCount(), -1); // Index de chaque texture dans le chargeur, par index de chaîne
+    for (quint32 i = 0; i < view.spriteCount(); i++) {
+        quint32 stringIndex = view.sprite(i).textureIndex();
+        if (stringIndex < view.stringCount() && textureIndices[stringIndex] < 0) {
+            textureIndices[stringIndex] = textureLoader.request(QDir::toNativeSeparators(resourcesPath + view.string(stringIndex)));
+        }
+    }
+    textureLoader.waitForDone();
+
+    // Seconde passe : on crée les sprites à partir des textures décodées
     QList<Sprite*> sprites;
+    sprites.reserve(view.spriteCount());
+    for (quint32 i = 0; i < view.spriteCount(); i++) {
+        LevelFileView::SpriteRecord record = view.sprite(i);
+
+        quint32 stringIndex = record.textureIndex();
+        QPixmap texture;
+        if (stringIndex < view.stringCount()) {
+            texture = textureLoader.pixmap(textureIndices[stringIndex]);
+        }
+
+        sprites.append(createSprite(texture, record.x(), record.y(), record.rotation(), record.scale(), record.opacity(), record.z()));
+    }
 
-    // Pour chaque sprite
-    for (QJsonValue spriteValue : spritesArray) {
-        // On récupère l'objet JSON
-        QJsonObject spriteJson = spriteValue.toObject();
+    return sprites;
+}
+
+//! Charge un niveau au format JSON dans la scène
+//! Le fichier est analysé au fil de la lecture (LevelJsonReader), sans construire de document JSON.
+//! Le décodage de chaque texture commence, en parallèle, dès que le premier sprite qui l'utilise est lu (TextureLoader) ;
+//! les sprites sont créés une fois la lecture et le décodage terminés.
+//! \param levelPath Le chemin du fichier
+//! \param levelName Le nom du niveau, pour les messages d'erreur
+//! \return La liste des sprites chargés
+QList<Sprite*> LevelLoader::loadJsonLevel(const QString& levelPath, const QString& levelName) {
+    TRACE_SCOPE("LevelLoader::loadJsonLevel");
+
+    QFile file(levelPath);
+    if (!file.open(QIODevice::ReadOnly)) { // Si on ne peut pas ouvrir le fichier
+        // On affiche une erreur
+        QMessageBox::critical(nullptr, "Erreur", "Impossible d'ouvrir le niveau " + levelName + ".");
+        return {};
+    }
 
-        // On crée la sprite avec son image
-        auto* sprite = new Sprite(QDir::toNativeSeparators(GameFramework::resourcesPath() + spriteJson["texturePath"].toString()));
-        sprites.append(sprite); // On ajoute la sprite à la liste
+    return loadJsonLevel(&file, levelName);
+}
+
+//! Charge un niveau JSON dans la scène, depuis un périphérique déjà ouvert
+//! \param pDevice Le périphérique à lire, ouvert en lecture
+//! \param levelName Le nom du niveau, pour les messages d'erreur
+//! \return La liste des sprites chargés
+QList<Sprite*> LevelLoader::loadJsonLevel(QIODevice* pDevice, const QString& levelName) {
+    const QString resourcesPath = GameFramework::resourcesPath();
+    TextureLoader textureLoader;
+    QVector<int> textureIndices; // Index de chaque texture dans le chargeur, par index dans la table des textures
+
+    // On lit les sprites, en demandant le décodage de leurs textures au fil de la lecture.
+    // Les sprites font référence à la table des textures : le chemin de chaque texture n'est construit qu'une fois
+    LevelData level;
+    LevelJsonReader reader(pDevice);
+    bool ok = reader.read(level, [&](const LevelSprite& levelSprite) {
+        if (levelSprite.textureIndex >= textureIndices.size()) {
+            textureIndices.resize(levelSprite.textureIndex + 1, -1);
+        }
+        int& textureIndex = textureIndices[levelSprite.textureIndex];
+        if (textureIndex < 0) { // Première utilisation de la texture
+            textureIndex = textureLoader.request(QDir::toNativeSeparators(resourcesPath + levelSprite.texturePath));
+        }
+        level.sprites.append(levelSprite);
+    });
+
+    if (!ok) { // Si le fichier est invalide
+        // On affiche une erreur
+        QMessageBox::critical(nullptr, "Erreur", "Impossible de charger le niveau " + levelName + " : " + reader.errorString());
+        return {};
+    }
 
-        // On applique les transformations
-        sprite->setPos(spriteJson["x"].toDouble(), spriteJson["y"].toDouble());
-        sprite->setRotation(spriteJson["rotation"].toInt());
-        sprite->setScale(spriteJson["scale"].toDouble());
+    // On charge l'arrière-plan, qui peut être écrit après les sprites dans le fichier
+    m_pScene->setBackgroundImage(QImage(resourcesPath + level.background));
 
-        m_pScene->addSpriteToScene(sprite); // On ajoute la sprite à la scène
+    // On crée les sprites à partir des textures décodées
+    textureLoader.waitForDone();
+    QList<Sprite*> sprites;
+    sprites.reserve(level.sprites.size());
+    for (qsizetype i = 0; i < level.sprites.size(); i++) {
+        const LevelSprite& levelSprite = level.sprites[i];
+        sprites.append(createSprite(textureLoader.pixmap(textureIndices[levelSprite.textureIndex]), levelSprite.x, levelSprite.y,
+                                    levelSprite.rotation, levelSprite.scale, levelSprite.opacity, levelSprite.z));
     }
 
     return sprites;
 }
 
+//! Crée une sprite, lui applique ses transformations et l'ajoute à la scène
+//! \param texture L'image de la sprite
+//! \return La sprite créée
+Sprite* LevelLoader::createSprite(const QPixmap& texture, double x, double y, double rotation, double scale, double opacity, double z) {
+    // On crée la sprite avec son image
+    auto* sprite = new Sprite(texture);
+
+    // On applique les transformations
+    sprite->setPos(x, y);
+    sprite->setRotation(rotation);
+    sprite->setScale(scale);
+    sprite->setOpacity(opacity);
+    sprite->setZValue(z);
+
+    m_pScene->addSpriteToScene(sprite); // On ajoute la sprite à la scène
+    return sprite;
+}
+
+/*****************
+ * Chargement progressif par régions
+ *****************/
+
+//! Ouvre une vue sur un niveau, quel que soit son format
+//! Un niveau binaire non compressé est projeté en mémoire depuis son fichier. Un niveau binaire compressé est
+//! décompressé en mémoire. Les autres niveaux (JSON, ou binaire sans régions si elles sont demandées) sont lus
+//! puis convertis en mémoire au format binaire.
+//! \param levelPath Le chemin du fichier
+//! \param levelName Le nom du niveau, pour les messages d'erreur
+//! \param requireChunks Si vrai, la vue ouverte contient toujours la section des régions
+//! \param view Reçoit la vue sur le niveau
+//! \param data Reçoit les données du niveau lorsqu'elles ne sont pas projetées depuis le fichier
+//! \return true si le niveau a pu être ouvert. Sinon, une erreur est affichée
+bool LevelLoader::openLevelView(const QString& levelPath, const QString& levelName, bool requireChunks,
+                                LevelFileView& view, QByteArray& data) {
+    QString error;
+    if (LevelCompression::fileCodec(levelPath) != LevelCompression::NoCodec) { // Niveau compressé : décompressé en mémoire
+        QFile file(levelPath);
+        if (file.open(QIODevice::ReadOnly)) {
+            const QByteArray compressed = file.readAll();
+            LevelCompression::decompress(compressed.constData(), compressed.size(), data, &error);
+        }
+        if (LevelFile::isBinary(data.constData(), data.size())) {
+            view.setData(data.constData(), data.size(), &error);
+        }
+    } else if (LevelFile::isBinaryFile(levelPath)) {
+        view.map(levelPath, &error);
+    }
+
+    if (!view.isOpen() || (requireChunks && !view.hasChunks())) {
+        // Niveau JSON ou sans régions : on le lit, puis on le convertit en mémoire au format binaire
+        view.close();
+        LevelData level;
+        if (!LevelFile::readFile(levelPath, level, &error)) { // Si on ne peut pas lire le fichier
+            // On affiche une erreur
+            QMessageBox::critical(nullptr, "Erreur", "Impossible de charger le niveau " + levelName + " : " + error);
+            data.clear();
+            return false;
+        }
+        data = LevelFile::toBinary(level);
+        view.setData(data.constData(), data.size());
+    }
+    return true;
+}
+
+//! Ouvre un niveau pour le charger progressivement, région par région, autour d'un point (voir updateStreaming())
+//! Seul l'arrière-plan est chargé : aucun sprite n'est créé avant le premier appel à updateStreaming().
+//! Un niveau binaire découpé en régions est lu sur place, depuis une projection du fichier en mémoire.
+//! Les autres niveaux (JSON, binaire sans régions) sont lus puis découpés en régions en mémoire.
+//! \param levelName Le nom du niveau
+//! \return true si le niveau a pu être ouvert
+bool LevelLoader::openStream(const QString& levelName) {
+    TRACE_SCOPE("LevelLoader::openStream");
+
+    closeStream();
+
+    QString levelPath = levelFilePath(levelName);
+    if (levelPath.isEmpty()) { // Si le fichier n'existe pas
+        return false;
+    }
+
+    if (!openLevelView(levelPath, levelName, true, m_streamView, m_streamData)) { // Si on ne peut pas lire le fichier
+        return false;
+    }
+
+    // On charge l'arrière-plan
+    m_pScene->setBackgroundImage(QImage(GameFramework::resourcesPath() + m_streamView.string(m_streamView.backgroundIndex())));
+
+    // Index des régions, pour retrouver en temps constant les régions proches du point suivi,
+    // et coordonnées extrêmes des régions, qui bornent leur recherche
+    m_streamChunks.reserve(m_streamView.chunkCount());
+    for (quint32 i = 0; i < m_streamView.chunkCount(); i++) {
+        QPoint coordinates = m_streamView.chunk(i).coordinates();
+        m_streamChunks.insert(LevelFile::chunkKey(coordinates), i);
+        if (i == 0) {
+            m_streamFirstChunk = coordinates;
+            m_streamLastChunk = coordinates;
+        } else {
+            m_streamFirstChunk = QPoint(qMin(m_streamFirstChunk.x(), coordinates.x()), qMin(m_streamFirstChunk.y(), coordinates.y()));
+            m_streamLastChunk = QPoint(qMax(m_streamLastChunk.x(), coordinates.x()), qMax(m_streamLastChunk.y(), coordinates.y()));
+        }
+    }
+    return true;
+}
+
+//! Définit les distances de chargement et de déchargement des régions
+//! Une région est chargée lorsqu'elle est à moins de loadRadius du point suivi, et déchargée lorsqu'elle s'en
+//! éloigne de plus de unloadRadius. L'écart entre les deux (hystérésis) évite qu'une région à la limite soit
+//! chargée et déchargée à chaque déplacement.
+//! \param loadRadius La distance de chargement, en unités de la scène
+//! \param unloadRadius La distance de déchargement, au moins égale à la distance de chargement
+void LevelLoader::setStreamingRadius(qreal loadRadius, qreal unloadRadius) {
+    m_loadRadius = loadRadius;
+    m_unloadRadius = qMax(loadRadius, unloadRadius);
+}
+
+//! Met à jour les régions chargées autour d'un point, typiquement le centre de la vue ou la position du joueur.
+//! À appeler à chaque déplacement du point suivi (à chaque tick, par exemple) : les régions qui se sont éloignées
+//! sont déchargées, puis celles qui se sont rapprochées sont chargées.
+//! \param focus Le point suivi, dans la scène
+void LevelLoader::updateStreaming(const QPointF& focus) {
+    if (!m_streamView.isOpen()) {
+        return;
+    }
+    TRACE_SCOPE("LevelLoader::updateStreaming");
+
+    // On décharge les régions trop éloignées
+    QList<quint64> farChunks;
+    for (auto it = m_loadedChunks.cbegin(); it != m_loadedChunks.cend(); ++it) {
+        if (chunkDistance(it.value().coordinates, focus) > m_unloadRadius) {
+            farChunks.append(it.key());
+        }
+    }
+    for (quint64 key : std::as_const(farChunks)) {
+        unloadChunk(key);
+    }
+
+    // On cherche les régions proches qui ne sont pas encore chargées, dans les limites des régions du niveau
+    if (m_streamChunks.isEmpty()) {
+        return;
+    }
+    const quint32 chunkSize = m_streamView.chunkSize();
+    QPoint first = LevelFile::chunkAt(focus.x() - m_loadRadius, focus.y() - m_loadRadius, chunkSize);
+    QPoint last = LevelFile::chunkAt(focus.x() + m_loadRadius, focus.y() + m_loadRadius, chunkSize);
+    first = QPoint(qMax(first.x(), m_streamFirstChunk.x()), qMax(first.y(), m_streamFirstChunk.y()));
+    last = QPoint(qMin(last.x(), m_streamLastChunk.x()), qMin(last.y(), m_streamLastChunk.y()));
+    if (first.x() > last.x() || first.y() > last.y()) { // Point trop éloigné du niveau
+        return;
+    }
+
+    // Les coordonnées peuvent atteindre les limites de int : les calculs se font sur 64 bits,
+    // et le nombre de régions parcourues est comparé sans calculer le produit des côtés
+    QVector<quint32> nearChunks;
+    const qint64 rangeWidth = static_cast<qint64>(last.x()) - first.x() + 1;
+    const qint64 rangeHeight = static_cast<qint64>(last.y()) - first.y() + 1;
+    if (rangeWidth <= m_streamChunks.size() / rangeHeight) { // On parcourt les régions autour du point
+        for (qint64 y = first.y(); y <= last.y(); y++) {
+            for (qint64 x = first.x(); x <= last.x(); x++) {
+                QPoint chunk(static_cast<int>(x), static_cast<int>(y));
+                auto it = m_streamChunks.constFind(LevelFile::chunkKey(chunk));
+                if (it != m_streamChunks.constEnd() && !m_loadedChunks.contains(it.key())
+                    && chunkDistance(chunk, focus) <= m_loadRadius) {
+                    nearChunks.append(it.value());
+                }
+            }
+        }
+    } else { // Distance plus grande que le niveau : on parcourt plutôt les régions du niveau
+        for (auto it = m_streamChunks.cbegin(); it != m_streamChunks.cend(); ++it) {
+            if (!m_loadedChunks.contains(it.key())
+                && chunkDistance(m_streamView.chunk(it.value()).coordinates(), focus) <= m_loadRadius) {
+                nearChunks.append(it.value());
+            }
+        }
+    }
+    if (!nearChunks.isEmpty()) {
+        loadChunks(nearChunks);
+    }
+}
+
+//! Décharge toutes les régions et ferme le niveau ouvert par openStream()
+void LevelLoader::closeStream() {
+    const QList<quint64> keys = m_loadedChunks.keys();
+    for (quint64 key : keys) {
+        unloadChunk(key);
+    }
+    m_streamChunks.clear();
+    m_streamFirstChunk = QPoint();
+    m_streamLastChunk = QPoint();
+    m_streamTextures.clear();
+    m_streamView.close();
+    m_streamData.clear();
+}
+
+//! Charge des régions du niveau ouvert par openStream()
+//! Les textures qui ne sont pas encore chargées sont décodées en parallèle (TextureLoader), puis les sprites
+//! de chaque région sont créés. Chaque texture est partagée entre les régions chargées qui l'utilisent.
+//! \param chunkIndices Les index des régions à charger
+void LevelLoader::loadChunks(const QVector<quint32>& chunkIndices) {
+    TRACE_SCOPE("LevelLoader::loadChunks");
+
+    const QString resourcesPath = GameFramework::resourcesPath();
+
+    // Première passe : on demande le décodage des textures qui ne sont pas encore chargées
+    TextureLoader textureLoader;
+    QHash<quint32, int> requestedTextures; // Index de chaque texture dans le chargeur, par index de chaîne
+    for (quint32 chunkIndex : chunkIndices) {
+        LevelFileView::ChunkRecord chunk = m_streamView.chunk(chunkIndex);
+        for (quint32 i = chunk.firstSprite(); i < chunk.firstSprite() + chunk.spriteCount(); i++) {
+            quint32 spriteIndex = m_streamView.chunkSpriteIndex(i);
+            quint32 stringIndex = m_streamView.sprite(spriteIndex).textureIndex();
+            if (stringIndex < m_streamView.stringCount() && !m_streamTextures.contains(stringIndex)
+                && !requestedTextures.contains(stringIndex)) {
+                requestedTextures.insert(stringIndex, textureLoader.request(QDir::toNativeSeparators(resourcesPath + m_streamView.string(stringIndex))));
+            }
+        }
+    }
+    textureLoader.waitForDone();
+    for (auto it = requestedTextures.cbegin(); it != requestedTextures.cend(); ++it) {
+        m_streamTextures[it.key()].pixmap = textureLoader.pixmap(it.value());
+    }
+
+    // Seconde passe : on crée les sprites de chaque région
+    for (quint32 chunkIndex : chunkIndices) {
+        LevelFileView::ChunkRecord chunk = m_streamView.chunk(chunkIndex);
+        LoadedChunk loadedChunk;
+        loadedChunk.coordinates = chunk.coordinates();
+        loadedChunk.sprites.reserve(chunk.spriteCount());
+
+        for (quint32 i = chunk.firstSprite(); i < chunk.firstSprite() + chunk.spriteCount(); i++) {
+            quint32 spriteIndex = m_streamView.chunkSpriteIndex(i);
+            LevelFileView::SpriteRecord record = m_streamView.sprite(spriteIndex);
+
+            quint32 stringIndex = record.textureIndex();
+            QPixmap texture;
+            if (stringIndex < m_streamView.stringCount()) {
+                StreamTexture& streamTexture = m_streamTextures[stringIndex];
+                texture = streamTexture.pixmap;
+                if (!loadedChunk.textures.contains(stringIndex)) { // Chaque région compte une seule utilisation par texture
+                    loadedChunk.textures.append(stringIndex);
+                    streamTexture.useCount++;
+                }
+            }
+
+            loadedChunk.sprites.append(createSprite(texture, record.x(), record.y(), record.rotation(), record.scale(), record.opacity(), record.z()));
+        }
+
+        m_loadedChunks.insert(LevelFile::chunkKey(loadedChunk.coordinates), loadedChunk);
+    }
+}
+
+//! Décharge une région : ses sprites sont retirés de la scène et détruits, et les textures qu'elle était
+//! la dernière à utiliser sont libérées
+//! \param key La clé de la région (LevelFile::chunkKey())
+void LevelLoader::unloadChunk(quint64 key) {
+    LoadedChunk loadedChunk = m_loadedChunks.take(key);
+    for (const QPointer<Sprite>& sprite : std::as_const(loadedChunk.sprites)) {
+        Sprite* pSprite = sprite.data();
+        if (pSprite == nullptr) { // Sprite déjà détruit par le jeu
+            continue;
+        }
+        m_pScene->removeSpriteFromScene(pSprite);
+        delete pSprite;
+    }
+
+    for (quint32 stringIndex : std::as_const(loadedChunk.textures)) {
+        auto it = m_streamTextures.find(stringIndex);
+        if (it != m_streamTextures.end() && --it.value().useCount <= 0) {
+            m_streamTextures.erase(it);
+        }
+    }
+}
+
+//! Retourne la distance entre un point et une région (0 si le point est dans la région)
+//! \param chunk Les coordonnées de la région
+//! \param point Le point, dans la scène
+qreal LevelLoader::chunkDistance(QPoint chunk, const QPointF& point) const {
+    const qreal chunkSize = m_streamView.chunkSize();
+    qreal left = chunk.x() * chunkSize;
+    qreal top = chunk.y() * chunkSize;
+    qreal dx = qMax<qreal>(0, qMax(left - point.x(), point.x() - (left + chunkSize)));
+    qreal dy = qMax<qreal>(0, qMax(top - point.y(), point.y() - (top + chunkSize)));
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+/*****************
+ * Chargement incrémental
+ *****************/
+
+//! Commence le chargement incrémental d'un niveau. La méthode retourne dès que le niveau est ouvert.
+//! L'arrière-plan est chargé immédiatement et le décodage des textures commence en parallèle (TextureLoader).
+//! Le fil principal n'est pas sollicité pendant le décodage : les tranches commencent à la fin de celui-ci
+//! (TextureLoader::finished()).
+//! Les sprites sont ensuite créés par tranches, à chaque passage dans la boucle d'événements : chaque tranche
+//! s'arrête dès que sliceBudget millisecondes sont écoulées. La progression est signalée après chaque tranche
+//! (loadingProgress()), et la liste des sprites chargés à la fin (loadingFinished()).
+//! Un chargement incrémental en cours est annulé.
+//! \param levelName Le nom du niveau
+//! \param sliceBudget La durée maximale d'une tranche, en millisecondes
+//! \return true si le chargement a commencé
+bool LevelLoader::loadLevelIncrementally(const QString& levelName, int sliceBudget) {
+    TRACE_SCOPE("LevelLoader::loadLevelIncrementally");
+
+    cancelLoading();
+
+    QString levelPath = levelFilePath(levelName);
+    if (levelPath.isEmpty()) { // Si le fichier n'existe pas
+        return false;
+    }
+    if (!openLevelView(levelPath, levelName, false, m_loadView, m_loadData)) { // Si on ne peut pas lire le fichier
+        return false;
+    }
+
+    // On charge l'arrière-plan
+    m_pScene->setBackgroundImage(QImage(GameFramework::resourcesPath() + m_loadView.string(m_loadView.backgroundIndex())));
+
+    // On demande le décodage de chaque texture utilisée : il a lieu pendant que la boucle d'événements continue
+    const QString resourcesPath = GameFramework::resourcesPath();
+    m_pLoadTextures = std::make_unique<TextureLoader>();
+    connect(m_pLoadTextures.get(), &TextureLoader::finished, this, &LevelLoader::onLoadTexturesFinished);
+    m_loadTextureIndices.fill(-1, m_loadView.stringCount());
+    for (quint32 i = 0; i < m_loadView.spriteCount(); i++) {
+        quint32 stringIndex = m_loadView.sprite(i).textureIndex();
+        if (stringIndex < m_loadView.stringCount() && m_loadTextureIndices[stringIndex] < 0) {
+            m_loadTextureIndices[stringIndex] = m_pLoadTextures->request(QDir::toNativeSeparators(resourcesPath + m_loadView.string(stringIndex)));
+        }
+    }
+
+    m_loadingLevelName = levelName;
+    m_nextSprite = 0;
+    m_sliceBudget = sliceBudget;
+    m_loadedSprites.clear();
+    m_loadedSprites.reserve(m_loadView.spriteCount());
+
+    emit loadingStarted(levelName, static_cast<int>(m_loadView.spriteCount()));
+    if (m_pLoadTextures->isDone()) { // Aucune texture à décoder : finished() ne sera pas émis
+        m_loadTimer.start();
+    }
+    return true;
+}
+
+//! Annule le chargement incrémental en cours. Les sprites déjà créés sont retirés de la scène et détruits
+void LevelLoader::cancelLoading() {
+    if (!isLoading()) {
+        return;
+    }
+
+    for (const QPointer<Sprite>& sprite : std::as_const(m_loadedSprites)) {
+        Sprite* pSprite = sprite.data();
+        if (pSprite == nullptr) { // Sprite déjà détruit par le jeu
+            continue;
+        }
+        m_pScene->removeSpriteFromScene(pSprite);
+        delete pSprite;
+    }
+    releaseLoading();
+}
+
+//! Commence les tranches de chargement une fois les textures décodées.
+//! Le signal peut provenir d'un chargement annulé depuis : on vérifie le chargement en cours
+void LevelLoader::onLoadTexturesFinished() {
+    if (isLoading() && m_pLoadTextures->isDone()) {
+        m_loadTimer.start();
+    }
+}
+
+//! Crée une tranche de sprites du niveau en cours de chargement, dans la limite du budget de temps
+void LevelLoader::loadSlice() {
+    TRACE_SCOPE("LevelLoader::loadSlice");
+
+    if (!m_pLoadTextures->isDone()) { // Textures en cours de décodage : les tranches reprennent à leur fin
+        m_loadTimer.stop();
+        return;
+    }
+
+    QElapsedTimer sliceTimer;
+    sliceTimer.start();
+
+    // Au moins un sprite par tranche, pour que le chargement avance quel que soit le budget
+    const quint32 spriteCount = m_loadView.spriteCount();
+    while (m_nextSprite < spriteCount) {
+        LevelFileView::SpriteRecord record = m_loadView.sprite(m_nextSprite++);
+
+        quint32 stringIndex = record.textureIndex();
+        QPixmap texture;
+        if (stringIndex < m_loadView.stringCount()) {
+            texture = m_pLoadTextures->pixmap(m_loadTextureIndices[stringIndex]);
+        }
+        m_loadedSprites.append(createSprite(texture, record.x(), record.y(), record.rotation(), record.scale(), record.opacity(), record.z()));
+
+        if (sliceTimer.elapsed() >= m_sliceBudget) {
+            break;
+        }
+    }
+
+    emit loadingProgress(static_cast<int>(m_nextSprite), static_cast<int>(spriteCount));
+    if (m_nextSprite >= spriteCount) {
+        finishLoading();
+    }
+}
+
+//! Termine le chargement incrémental et signale la liste des sprites chargés
+//! Les sprites détruits par le jeu pendant le chargement n'y figurent pas
+void LevelLoader::finishLoading() {
+    QString levelName = m_loadingLevelName;
+    QList<Sprite*> sprites;
+    sprites.reserve(m_loadedSprites.size());
+    for (const QPointer<Sprite>& sprite : std::as_const(m_loadedSprites)) {
+        if (!sprite.isNull()) {
+            sprites.append(sprite.data());
+        }
+    }
+    releaseLoading();
+
+    emit loadingFinished(levelName, sprites);
+}
+
+//! Arrête les tranches de chargement et libère le niveau en cours de chargement
+void LevelLoader::releaseLoading() {
+    m_loadTimer.stop();
+    m_pLoadTextures.reset();
+    m_loadTextureIndices.clear();
+    m_loadedSprites.clear();
+    m_loadView.close();
+    m_loadData.clear();
+    m_loadingLevelName.clear();
+    m_nextSprite = 0;
+}
+
 //! Décharge un niveau de la scène
 void LevelLoader::unloadLevel() {
+    cancelLoading();
+    closeStream();
+
     for (Sprite* sprite : m_pScene->sprites()) {
         m_pScene->removeSpriteFromScene(sprite);
         delete sprite;
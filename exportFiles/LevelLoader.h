@@ -8,25 +8,125 @@
 #ifndef WORLDBUILDR_LEVELLOADER_H
 #define WORLDBUILDR_LEVELLOADER_H
 
+#include <memory>
+
 #include <QString>
+#include <QByteArray>
+#include <QHash>
 #include <QList>
+#include <QObject>
+#include <QPixmap>
+#include <QPoint>
+#include <QPointer>
+#include <QPointF>
+#include <QTimer>
+#include <QVector>
+#include "LevelFile.h"
 
-class QJsonArray;
+class QIODevice;
 class Sprite;
 class GameScene;
+class TextureLoader;
+
+//! Chargement des niveaux dans une scène de jeu.
+//!
+//! loadLevel() charge tous les sprites d'un niveau. Pour les grands niveaux, le chargement progressif par
+//! régions (voir LevelFile) ne garde en scène que les régions proches d'un point suivi :
+//! - openStream() ouvre le niveau et charge son arrière-plan ;
+//! - updateStreaming(), appelée à chaque déplacement du point suivi (centre de la vue, joueur...), charge les régions
+//!   à moins de la distance de chargement et décharge celles au-delà de la distance de déchargement ;
+//! - closeStream() (ou unloadLevel()) décharge toutes les régions.
+//! La mémoire et le temps de chargement dépendent alors de la zone active, et non de la taille du niveau.
+//! Les sprites des régions appartiennent au chargeur : ils sont détruits au déchargement de leur région.
+//!
+//! loadLevelIncrementally() charge tous les sprites d'un niveau sans bloquer la boucle d'événements : les sprites
+//! sont créés par tranches, chacune limitée à un budget de quelques millisecondes, entre lesquelles la scène est
+//! rendue et animée. Les signaux loadingStarted(), loadingProgress() et loadingFinished() permettent au jeu
+//! d'afficher un écran de chargement pendant ce temps.
+class LevelLoader : public QObject {
+    Q_OBJECT
 
-class LevelLoader {
 public:
-    explicit LevelLoader(GameScene* scene, QString levelsPath);
+    explicit LevelLoader(GameScene* scene, QString levelsPath, QObject* pParent = nullptr);
+    ~LevelLoader() override;
+
+    static constexpr int DEFAULT_SLICE_BUDGET = 8; // Durée maximale d'une tranche de chargement, en millisecondes
 
     QList<Sprite*> loadLevel(const QString& levelName);
     void unloadLevel();
 
+    bool loadLevelIncrementally(const QString& levelName, int sliceBudget = DEFAULT_SLICE_BUDGET);
+    void cancelLoading();
+    bool isLoading() const { return m_pLoadTextures != nullptr; }
+
+    bool openStream(const QString& levelName);
+    void setStreamingRadius(qreal loadRadius, qreal unloadRadius);
+    void updateStreaming(const QPointF& focus);
+    void closeStream();
+    bool isStreaming() const { return m_streamView.isOpen(); }
+    int loadedChunkCount() const { return static_cast<int>(m_loadedChunks.size()); }
+
 private:
+    //! Région chargée dans la scène
+    struct LoadedChunk {
+        QPoint coordinates;
+        QList<QPointer<Sprite>> sprites; // Mis à zéro si le jeu détruit un sprite
+        QVector<quint32> textures; // Index de chaîne des textures utilisées
+    };
+
+    //! Texture partagée entre les régions chargées
+    struct StreamTexture {
+        QPixmap pixmap;
+        int useCount = 0; // Nombre de régions chargées qui l'utilisent
+    };
+
     GameScene* m_pScene;
     QString m_levelsPath;
 
-    QList<Sprite*> loadSprites(const QJsonArray& spritesArray);
+    LevelFileView m_streamView;
+    QByteArray m_streamData; // Données du niveau ouvert, s'il n'est pas projeté depuis son fichier
+    QHash<quint64, quint32> m_streamChunks; // Index de chaque région du niveau, par clé (LevelFile::chunkKey())
+    QPoint m_streamFirstChunk; // Plus petites coordonnées des régions du niveau
+    QPoint m_streamLastChunk; // Plus grandes coordonnées des régions du niveau
+    QHash<quint64, LoadedChunk> m_loadedChunks;
+    QHash<quint32, StreamTexture> m_streamTextures; // Textures chargées, par index de chaîne
+    qreal m_loadRadius = LevelFile::DEFAULT_CHUNK_SIZE;
+    qreal m_unloadRadius = 2 * LevelFile::DEFAULT_CHUNK_SIZE;
+
+    LevelFileView m_loadView; // Niveau en cours de chargement incrémental
+    QByteArray m_loadData;
+    QString m_loadingLevelName;
+    std::unique_ptr<TextureLoader> m_pLoadTextures;
+    QVector<int> m_loadTextureIndices; // Index de chaque texture dans le chargeur, par index de chaîne
+    QList<QPointer<Sprite>> m_loadedSprites; // Mis à zéro si le jeu détruit un sprite pendant le chargement
+    quint32 m_nextSprite = 0;
+    int m_sliceBudget = DEFAULT_SLICE_BUDGET;
+    QTimer m_loadTimer; // Intervalle nul : une tranche à chaque passage dans la boucle d'événements, une fois les textures décodées
+
+    QString levelFilePath(const QString& levelName) const;
+    bool openLevelView(const QString& levelPath, const QString& levelName, bool requireChunks, LevelFileView& view, QByteArray& data);
+    void finishLoading();
+    void releaseLoading();
+    void loadChunks(const QVector<quint32>& chunkIndices);
+    void unloadChunk(quint64 key);
+    qreal chunkDistance(QPoint chunk, const QPointF& point) const;
+
+    QList<Sprite*> loadCompressedLevel(const QString& levelPath, const QString& levelName);
+    QList<Sprite*> loadBinaryLevel(const QString& levelPath, const QString& levelName);
+    QList<Sprite*> loadBinaryLevel(const LevelFileView& view);
+    QList<Sprite*> loadJsonLevel(const QString& levelPath, const QString& levelName);
+    QList<Sprite*> loadJsonLevel(QIODevice* pDevice, const QString& levelName);
+    QList<Sprite*> loadSprites(const LevelFileView& view);
+    Sprite* createSprite(const QPixmap& texture, double x, double y, double rotation, double scale, double opacity, double z);
+
+signals:
+    void loadingStarted(const QString& levelName, int spriteCount);
+    void loadingProgress(int loadedSpriteCount, int spriteCount);
+    void loadingFinished(const QString& levelName, const QList<Sprite*>& sprites);
+
+private slots:
+    void onLoadTexturesFinished();
+    void loadSlice();
 };
 
 
@@ -0,0 +1,72 @@
+/*
+ * @file TextureLoader.cpp
+ * @brief Définition de la classe TextureLoader.
+ * @author Noah Blattner
+ * @date Octobre 2026
+ */
+
+#include <QThread>
+#include "TextureLoader.h"
+#include "tracing.h"
+
+//! Constructeur. Les textures sont décodées sur autant de fils que de cœurs
+TextureLoader::TextureLoader() {
+    m_decoderPool.setMaxThreadCount(QThread::idealThreadCount());
+}
+
+//! Destructeur. Attend la fin des décodages en cours, qui écrivent dans les textures et émettent finished()
+TextureLoader::~TextureLoader() {
+    m_decoderPool.waitForDone();
+}
+
+//! Demande le chargement d'une texture. Si elle n'a pas encore été demandée, son décodage commence aussitôt
+//! \param filePath Le chemin de l'image
+//! \return L'index de la texture, à passer à pixmap()
+int TextureLoader::request(const QString& filePath) {
+    auto it = m_indices.constFind(filePath);
+    if (it != m_indices.constEnd()) { // Texture déjà demandée
+        return it.value();
+    }
+
+    int index = static_cast<int>(m_textures.size());
+    m_indices.insert(filePath, index);
+    m_textures.push_back(std::make_unique<Texture>());
+
+    Texture* pTexture = m_textures.back().get();
+    m_pendingCount.ref();
+    m_decoderPool.start([this, pTexture, filePath]() {
+        TRACE_SCOPE("TextureLoader::decode");
+
+        pTexture->image = QImage(filePath);
+
+        // Le dernier décodage en cours signale la fin du chargement
+        if (!m_pendingCount.deref()) {
+            emit finished();
+        }
+    });
+    return index;
+}
+
+//! Attend la fin du décodage de toutes les textures demandées
+void TextureLoader::waitForDone() {
+    TRACE_SCOPE("TextureLoader::waitForDone");
+
+    m_decoderPool.waitForDone();
+}
+
+//! Indique, sans attendre, si le décodage de toutes les textures demandées est terminé
+bool TextureLoader::isDone() {
+    return m_decoderPool.waitForDone(0);
+}
+
+//! Retourne l'image d'une texture. Doit être appelée sur le fil principal, après waitForDone()
+//! \param index L'index de la texture, retourné par request()
+//! \return L'image, nulle si le fichier n'a pas pu être décodé
+QPixmap TextureLoader::pixmap(int index) {
+    Texture& texture = *m_textures[index];
+    if (!texture.isConverted) {
+        texture.pixmap = QPixmap::fromImage(std::move(texture.image));
+        texture.isConverted = true;
+    }
+    return texture.pixmap;
+}
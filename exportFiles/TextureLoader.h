@@ -0,0 +1,67 @@
+/*
+ * @file TextureLoader.h
+ * @brief Déclaration de la classe TextureLoader.
+ * @author Noah Blattner
+ * @date Octobre 2026
+ */
+
+#ifndef WORLDBUILDR_TEXTURELOADER_H
+#define WORLDBUILDR_TEXTURELOADER_H
+
+#include <memory>
+#include <vector>
+
+#include <QAtomicInt>
+#include <QHash>
+#include <QImage>
+#include <QObject>
+#include <QPixmap>
+#include <QString>
+#include <QThreadPool>
+
+//! Chargement des textures d'un niveau en parallèle, utilisé par l'éditeur et par LevelLoader.
+//!
+//! Le chargement se fait en deux temps :
+//! - request() est appelée pour chaque texture utilisée. Chaque texture n'est demandée qu'une fois : son décodage
+//!   (QImage) commence aussitôt sur un groupe de fils d'exécution, pendant que l'appelant continue sa lecture du niveau ;
+//! - après waitForDone(), pixmap() retourne l'image de chaque texture. La conversion en QPixmap, qui doit avoir lieu
+//!   sur le fil principal, n'est faite qu'une fois par texture.
+//! Les sprites peuvent ainsi être créés sur le fil principal sans décoder leur image.
+//! Pour ne pas bloquer le fil principal pendant le décodage, le signal finished() est émis lorsque toutes les textures
+//! demandées sont décodées. Il est émis depuis un fil de décodage : une connexion à un objet du fil principal est
+//! donc différée jusqu'à la boucle d'événements. isDone() indique, sans attendre, si le décodage est terminé.
+class TextureLoader : public QObject {
+    Q_OBJECT
+
+public:
+    TextureLoader();
+    ~TextureLoader() override;
+
+    TextureLoader(const TextureLoader&) = delete;
+    TextureLoader& operator=(const TextureLoader&) = delete;
+
+    int request(const QString& filePath);
+    void waitForDone();
+    bool isDone();
+
+    int textureCount() const { return static_cast<int>(m_textures.size()); }
+    QPixmap pixmap(int index);
+
+signals:
+    void finished();
+
+private:
+    struct Texture {
+        QImage image; // Écrite par le fil de décodage
+        QPixmap pixmap; // Convertie à la première utilisation, sur le fil principal
+        bool isConverted = false;
+    };
+
+    QThreadPool m_decoderPool;
+    QAtomicInt m_pendingCount; // Nombre de textures demandées dont le décodage n'est pas terminé
+    QHash<QString, int> m_indices; // Index de chaque texture, par chemin
+    std::vector<std::unique_ptr<Texture>> m_textures; // Adresses stables : les fils de décodage y écrivent
+};
+
+
+#endif //WORLDBUILDR_TEXTURELOADER_H
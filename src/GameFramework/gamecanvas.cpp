@@ -9,6 +9,8 @@
 #include "gamecore.h"
 #include "gamescene.h"
 #include "gameview.h"
+#include "tracing.h"
+#include "tweenengine.h"
 
 #include <limits>
 
@@ -33,6 +35,7 @@ GameCanvas::GameCanvas(Ui::MainFrm* ui, QObject* pParent) : QObject(pParent) {
     m_pEditHud = ui->editorActionPanel;
     m_pDetailsPanel = ui->detailsPanel;
     m_pGameCore = nullptr;
+    m_pTweenEngine = new TweenEngine(this);
     m_pDetailedInfosItem = nullptr;
 
     m_keepTicking = false;
@@ -161,6 +164,11 @@ bool GameCanvas::isTicking() const {
     return m_keepTicking;
 }
 
+//! \return le moteur d'interpolation des propriétés des sprites, cadencé par ce canvas.
+TweenEngine* GameCanvas::tweenEngine() const {
+    return m_pTweenEngine;
+}
+
 //! Enclenche le suivi du déplacement de la souris.
 void GameCanvas::startMouseTracking() {
     m_pView->setMouseTracking(true);
@@ -246,6 +254,12 @@ void GameCanvas::keyPressed(QKeyEvent* pKeyEvent) {
                 m_tickTimer.setInterval(m_tickTimer.interval()-1);
                 qDebug() << "Tick interval set to " << m_tickTimer.interval();
                 break;
+            case Qt::Key_T:
+                if (GameFramework::Tracer::isEnabled())
+                    GameFramework::Tracer::stop();
+                else
+                    GameFramework::Tracer::start();
+                break;
             }
         }
         pKeyEvent->accept();
@@ -303,6 +317,8 @@ void GameCanvas::onInit() {
 //! est mesuré et l'objet GameCore est lui-même informé du tick.
 //! Poursuit la génération du tick si nécessaire.
 void GameCanvas::onTick() {
+    TRACE_SCOPE("GameCanvas::onTick");
+
     long long elapsedTime = m_lastUpdateTime.elapsed();
 
     // On évite une division par zéro (peu probable, mais on sait jamais)
@@ -316,7 +332,14 @@ void GameCanvas::onTick() {
     m_totalElapsedTime += elapsedTime;
 
     // Tick
-    m_pGameCore->tick(elapsedTime);
+    {
+        TRACE_SCOPE("GameCore::tick");
+        m_pGameCore->tick(elapsedTime);
+    }
+    {
+        TRACE_SCOPE("TweenEngine::update");
+        m_pTweenEngine->update(elapsedTime);
+    }
     currentScene()->tick(elapsedTime);
 
     if (m_pDetailedInfosItem && m_pDetailedInfosItem->isVisible())
@@ -18,6 +18,7 @@
 class GameCore;
 class GameScene;
 class GameView;
+class TweenEngine;
 class EditorActionPanel;
 class QGraphicsScene;
 class QGraphicsSceneMouseEvent;
@@ -46,6 +47,12 @@ class QKeyEvent;
 //!
 //! Pour stopper le tick, utiliser la commande stopTick().
 //!
+//! À chaque tick, GameCanvas fait également avancer les interpolations de propriétés des sprites
+//! gérées par son moteur d'interpolation (tweenEngine()).
+//!
+//! Le raccourci Ctrl+Shift+T démarre ou arrête l'enregistrement d'une trace des performances
+//! (voir GameFramework::Tracer).
+//!
 //! GameCanvas permet également d'enclencher le suivi des déplacements de la souris (startMouseTracking() et de
 //! le stopper (stopMouseTracking()).
 //!
@@ -77,6 +84,8 @@ public:
     void stopTick();
     bool isTicking() const;
 
+    TweenEngine* tweenEngine() const;
+
     void startMouseTracking();
     void stopMouseTracking();
     QPointF currentMousePosition() const;
@@ -104,6 +113,7 @@ private:
     SpriteDetailsPanel* m_pDetailsPanel;
 
     GameCore* m_pGameCore;
+    TweenEngine* m_pTweenEngine;
     QPointer<QGraphicsTextItem> m_pDetailedInfosItem; // Smart Pointer pour qu'il soit mis à zéro au cas où l'item est effacé par GameScene::clear()
 
     bool m_keepTicking;
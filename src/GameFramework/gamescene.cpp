@@ -6,10 +6,12 @@
 */
 #include "gamescene.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <QApplication>
 #include <QBrush>
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QGraphicsSceneMouseEvent>
 #include <QGraphicsView>
 #include <QKeyEvent>
@@ -17,8 +19,13 @@
 #include <QPen>
 
 #include "gamecore.h"
+#include "movementsystem.h"
 #include "resources.h"
 #include "sprite.h"
+#include "spritetickhandler.h"
+#include "tracing.h"
+
+const int DEFAULT_TICK_BUDGET = 15;
 
 //! Construit la scène de jeu avec une taille par défaut et un fond noir.
 //! \param pParent  Objet propriétaire de cette scène.
@@ -55,6 +62,9 @@ GameScene::~GameScene()  {
     }
     sprites.clear();
 
+    delete m_pMovementSystem;
+    m_pMovementSystem = nullptr;
+
     delete m_pBackgroundImage;
     m_pBackgroundImage = nullptr;
 }
@@ -94,6 +104,9 @@ void GameScene::removeSpriteFromScene(Sprite* pSprite)
     disconnect(pSprite, &Sprite::spriteDestroyed, this, &GameScene::onSpriteDestroyed);
 
     m_registeredForTickSpriteList.removeAll(pSprite);
+    m_pendingTickTime.remove(pSprite);
+    forgetSleepState(pSprite);
+    m_pMovementSystem->removeSprite(pSprite);
 
     emit spriteRemovedFromScene(pSprite);
 }
@@ -225,13 +238,17 @@ void GameScene::setHeight(int sceneHeight)  {
 //! Le sprite donné sera informé du tick.
 //! \param pSprite Sprite qui s'enregistre pour le tick.
 void GameScene::registerSpriteForTick(Sprite* pSprite) {
+    forgetSleepState(pSprite);
     m_registeredForTickSpriteList.append(pSprite);
+    m_pendingTickTime.insert(pSprite, 0);
 }
 
 //! Le sprite donné se va plus être informé du tick.
 //! \param pSprite Sprite qui démissionne du tick.
 void GameScene::unregisterSpriteFromTick(Sprite* pSprite) {
     m_registeredForTickSpriteList.removeAll(pSprite);
+    m_pendingTickTime.remove(pSprite);
+    forgetSleepState(pSprite);
 }
 
 //! Indique si le sprite donné est abonné au tick.
@@ -239,7 +256,79 @@ void GameScene::unregisterSpriteFromTick(Sprite* pSprite) {
 //! \return un booléen à vrai si le sprite donné est abonné au tick.
 bool GameScene::isRegisteredForTick(const Sprite* pSprite) const
 {
-    return m_registeredForTickSpriteList.contains(pSprite);
+    return m_pendingTickTime.contains(pSprite);
+}
+
+//! Endort le sprite donné : il reste abonné au tick, mais n'est plus cadencé jusqu'à son réveil.
+//! Si le sprite dort déjà, son échéance de réveil est remplacée.
+//! Un sprite qui n'est pas abonné au tick est ignoré.
+//! \param pSprite                      Sprite à endormir.
+//! \param sleepDurationInMilliseconds  Durée du sommeil. Avec SLEEP_UNTIL_WOKEN, le sprite dort
+//!                                     jusqu'à un appel à wakeUpSprite().
+void GameScene::sleepSprite(Sprite* pSprite, long long sleepDurationInMilliseconds) {
+    if (!m_pendingTickTime.contains(pSprite))
+        return;
+
+    // Échéance précédente éventuelle
+    auto wakeUpTimeIt = m_wakeUpTimeBySprite.find(pSprite);
+    if (wakeUpTimeIt != m_wakeUpTimeBySprite.end()) {
+        m_wakeUpTimes.remove(wakeUpTimeIt.value(), pSprite);
+        m_wakeUpTimeBySprite.erase(wakeUpTimeIt);
+    }
+
+    if (sleepDurationInMilliseconds >= 0) {
+        const long long wakeUpTime = m_sceneTime + sleepDurationInMilliseconds;
+        m_wakeUpTimes.insert(wakeUpTime, pSprite);
+        m_wakeUpTimeBySprite.insert(pSprite, wakeUpTime);
+    }
+
+    // Le sprite sera retiré de la liste des sprites éveillés au début du prochain tick, ce qui évite
+    // de parcourir la liste à chaque endormissement.
+    if (!m_sleepingSprites.contains(pSprite))
+        m_pendingSleepSprites.insert(pSprite);
+
+    m_pendingTickTime[pSprite] = 0;
+}
+
+//! Réveille le sprite donné, qui sera à nouveau cadencé dès le prochain tick.
+//! Le temps reçu lors de son premier tick est celui écoulé depuis son réveil.
+//! \param pSprite  Sprite à réveiller. S'il ne dort pas, rien ne se passe.
+void GameScene::wakeUpSprite(Sprite* pSprite) {
+    if (m_pendingSleepSprites.remove(pSprite)) {
+        // Il n'a pas encore quitté la liste des sprites éveillés
+        forgetSleepState(pSprite);
+        return;
+    }
+
+    if (!m_sleepingSprites.contains(pSprite))
+        return;
+
+    forgetSleepState(pSprite);
+    m_registeredForTickSpriteList.append(pSprite);
+    m_pendingTickTime[pSprite] = 0;
+}
+
+//! Réveille tous les sprites endormis en collision avec le sprite donné.
+//! \param pSprite  Sprite dont les contacts doivent être réveillés.
+void GameScene::wakeUpCollidingSprites(const Sprite* pSprite) {
+    if (m_sleepingSprites.isEmpty() && m_pendingSleepSprites.isEmpty())
+        return;
+
+    const QList<Sprite*> collidingSpriteList = collidingSprites(pSprite);
+    for(Sprite* pCollidingSprite : collidingSpriteList)
+        wakeUpSprite(pCollidingSprite);
+}
+
+//! Indique si le sprite donné est endormi.
+//! \param pSprite Sprite à vérifier.
+//! \return un booléen à vrai si le sprite donné est abonné au tick et endormi.
+bool GameScene::isSleeping(const Sprite* pSprite) const {
+    return m_sleepingSprites.contains(pSprite) || m_pendingSleepSprites.contains(pSprite);
+}
+
+//! \return le système de déplacement de cette scène, mis à jour à chaque tick.
+MovementSystem* GameScene::movementSystem() const {
+    return m_pMovementSystem;
 }
 
 //! Vérifie si la position donnée fait partie de la scène.
@@ -277,14 +366,149 @@ void GameScene::centerViewOn(QPointF pos) {
     views().at(0)->centerOn(pos);
 }
 
+//! Détermine le budget de temps alloué à la cadence des sprites lors de chaque tick.
+//! Les sprites de priorité normale ou basse qui ne peuvent pas être cadencés dans ce budget
+//! sont reportés au tick suivant.
+//! \param tickBudgetInMilliseconds  Budget en millisecondes. Avec 0, le budget est illimité.
+void GameScene::setTickBudget(int tickBudgetInMilliseconds) {
+    m_tickBudget = tickBudgetInMilliseconds < 0 ? 0 : tickBudgetInMilliseconds;
+}
+
+//! \return le budget de temps (en millisecondes) alloué à la cadence des sprites lors de chaque tick.
+int GameScene::tickBudget() const {
+    return m_tickBudget;
+}
+
 //! Cadence.
+//! Les sprites endormis dont l'échéance est atteinte sont réveillés, puis ceux qui se sont endormis
+//! depuis le tick précédent sont retirés de la liste des sprites éveillés.
+//! Le système de déplacement est mis à jour ensuite : les sprites dont la durée de vie
+//! est écoulée sont retirés de la scène et détruits.
+//! Les sprites de haute priorité sont cadencés en premier, puis ceux de priorité normale et
+//! enfin ceux de basse priorité, tant que le budget de temps n'est pas épuisé.
+//! Les sprites en attente sont cadencés en commençant par ceux qui attendent depuis le plus longtemps.
 //! \param elapsedTimeInMilliseconds  Temps écoulé depuis le tick précédent.
 void GameScene::tick(long long elapsedTimeInMilliseconds) {
+    TRACE_SCOPE("GameScene::tick");
+
+    QElapsedTimer tickDuration;
+    tickDuration.start();
+
+    m_sceneTime += elapsedTimeInMilliseconds;
+    wakeUpExpiredSleepers();
+    compactSleepingSprites();
+
+    // Déplacements simples, en une passe
+    {
+        TRACE_SCOPE("MovementSystem::update");
+        const QList<Sprite*> expiredSprites = m_pMovementSystem->update(elapsedTimeInMilliseconds);
+        for(Sprite* pSprite : expiredSprites) {
+            removeSpriteFromScene(pSprite);
+            pSprite->deleteLater();
+        }
+    }
+
     auto spriteListCopy = m_registeredForTickSpriteList; // On travaille sur une copie au cas où
                                         // la liste originale serait modifiée
                                         // lors de l'appel de tick auprès d'un sprite.
+
+    // Accumulation du temps écoulé et répartition des sprites à cadencer selon leur priorité
+    QList<Sprite*> highPrioritySprites;
+    QList<QPair<long long, Sprite*>> deferrableSprites[2]; // Priorité normale et basse
     for(Sprite* pSprite : spriteListCopy) {
-        pSprite->tick(elapsedTimeInMilliseconds);
+        long long& rPendingTime = m_pendingTickTime[pSprite];
+        rPendingTime += elapsedTimeInMilliseconds;
+
+        const SpriteTickHandler* pTickHandler = pSprite->tickHandler();
+        if (pTickHandler == nullptr) {
+            deferrableSprites[0].append(qMakePair(rPendingTime, pSprite));
+            continue;
+        }
+
+        if (rPendingTime < pTickHandler->tickInterval())
+            continue; // Pas encore son tour
+
+        switch (pTickHandler->tickPriority()) {
+        case SpriteTickHandler::HIGH_PRIORITY:   highPrioritySprites.append(pSprite); break;
+        case SpriteTickHandler::NORMAL_PRIORITY: deferrableSprites[0].append(qMakePair(rPendingTime, pSprite)); break;
+        case SpriteTickHandler::LOW_PRIORITY:    deferrableSprites[1].append(qMakePair(rPendingTime, pSprite)); break;
+        }
+    }
+
+    // Les sprites de haute priorité sont toujours cadencés
+    for(Sprite* pSprite : highPrioritySprites)
+        tickSprite(pSprite);
+
+    // Les autres sprites sont cadencés tant que le budget le permet
+    const qint64 tickBudgetInNanoseconds = m_tickBudget * 1000000LL;
+    int deferredSpriteCount = 0;
+    for(auto& rSprites : deferrableSprites) {
+        // Ceux qui attendent depuis le plus longtemps passent en premier
+        std::stable_sort(rSprites.begin(), rSprites.end(), [](const QPair<long long, Sprite*>& rA, const QPair<long long, Sprite*>& rB) {
+            return rA.first > rB.first;
+        });
+
+        for(const auto& rPendingSprite : rSprites) {
+            if (m_tickBudget > 0 && tickDuration.nsecsElapsed() >= tickBudgetInNanoseconds) {
+                deferredSpriteCount++;
+                continue;
+            }
+            tickSprite(rPendingSprite.second);
+        }
+    }
+
+    if (m_tickBudget > 0 && (deferredSpriteCount > 0 || tickDuration.nsecsElapsed() > tickBudgetInNanoseconds))
+        emit tickBudgetExceeded(tickDuration.elapsed(), deferredSpriteCount);
+}
+
+//! Cadence le sprite donné avec le temps écoulé depuis son dernier tick effectif.
+//! Si le sprite a été désabonné entre-temps (par exemple lors du tick d'un autre sprite),
+//! il est ignoré.
+//! \param pSprite  Sprite à cadencer.
+void GameScene::tickSprite(Sprite* pSprite) {
+    if (m_pendingSleepSprites.contains(pSprite))
+        return; // Endormi lors du tick d'un autre sprite
+
+    auto pendingTimeIt = m_pendingTickTime.find(pSprite);
+    if (pendingTimeIt == m_pendingTickTime.end())
+        return;
+
+    long long elapsedTimeInMilliseconds = pendingTimeIt.value();
+    pendingTimeIt.value() = 0;
+
+    pSprite->tick(elapsedTimeInMilliseconds);
+}
+
+//! Retire de la liste des sprites éveillés ceux qui se sont endormis depuis le tick précédent.
+void GameScene::compactSleepingSprites() {
+    if (m_pendingSleepSprites.isEmpty())
+        return;
+
+    m_registeredForTickSpriteList.removeIf([this](Sprite* pSprite) {
+        return m_pendingSleepSprites.contains(pSprite);
+    });
+
+    for(const Sprite* pSprite : std::as_const(m_pendingSleepSprites))
+        m_sleepingSprites.insert(pSprite);
+    m_pendingSleepSprites.clear();
+}
+
+//! Réveille les sprites dont l'échéance de sommeil est atteinte.
+void GameScene::wakeUpExpiredSleepers() {
+    while (!m_wakeUpTimes.isEmpty() && m_wakeUpTimes.firstKey() <= m_sceneTime)
+        wakeUpSprite(m_wakeUpTimes.first());
+}
+
+//! Oublie l'état de sommeil du sprite donné (sans le remettre dans la liste des sprites éveillés).
+//! \param pSprite  Sprite concerné.
+void GameScene::forgetSleepState(const Sprite* pSprite) {
+    m_sleepingSprites.remove(pSprite);
+    m_pendingSleepSprites.remove(pSprite);
+
+    auto wakeUpTimeIt = m_wakeUpTimeBySprite.find(pSprite);
+    if (wakeUpTimeIt != m_wakeUpTimeBySprite.end()) {
+        m_wakeUpTimes.remove(wakeUpTimeIt.value(), const_cast<Sprite*>(pSprite));
+        m_wakeUpTimeBySprite.erase(wakeUpTimeIt);
     }
 }
 
@@ -303,6 +527,9 @@ void GameScene::drawBackground(QPainter* pPainter, const QRectF& rRect)  {
 //! Initialise la scène
 void GameScene::init() {
     m_pBackgroundImage = nullptr;
+    m_pMovementSystem = new MovementSystem;
+    m_tickBudget = DEFAULT_TICK_BUDGET;
+    m_sceneTime = 0;
 
     this->setBackgroundBrush(QBrush(Qt::black));
     //setBackgroundImage(QImage(GameFramework::imagesPath("demo") + "landscape_background.jpg"));
@@ -316,4 +543,7 @@ void GameScene::init() {
 //! Retire de la liste des sprite le sprite qui va être détruit.
 void GameScene::onSpriteDestroyed(Sprite* pSprite) {
     m_registeredForTickSpriteList.removeAll(pSprite);
+    m_pendingTickTime.remove(pSprite);
+    forgetSleepState(pSprite);
+    m_pMovementSystem->removeSprite(pSprite);
 }
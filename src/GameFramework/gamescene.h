@@ -10,7 +10,11 @@
 #include "gamecanvas.h"
 
 #include <QGraphicsScene>
+#include <QHash>
+#include <QMultiMap>
+#include <QSet>
 
+class MovementSystem;
 class Sprite;
 class QGraphicsSimpleTextItem;
 class QPainter;
@@ -35,6 +39,23 @@ class QPainter;
 //!
 //! La méthode unregisterSpriteFromTick() permet de désabonner un sprite à la cadence.
 //!
+//! Les sprites abonnés sont cadencés selon la priorité et l'intervalle de leur gestionnaire de
+//! cadence (SpriteTickHandler::setTickPriority() et SpriteTickHandler::setTickInterval()).
+//! Les sprites de haute priorité sont cadencés en premier et toujours. Les autres sont cadencés
+//! tant que le budget de temps par tick (setTickBudget()) n'est pas épuisé ; les sprites restants
+//! sont reportés au tick suivant, en commençant par ceux qui attendent depuis le plus longtemps.
+//! Le signal tickBudgetExceeded() est émis lorsque le budget est dépassé.
+//!
+//! Un sprite abonné qui n'a rien à faire peut être endormi (sleepSprite()) : il reste abonné,
+//! mais ne fait plus partie de la boucle de cadence jusqu'à son réveil, qui a lieu à l'échéance
+//! donnée, par un appel à wakeUpSprite() (par exemple depuis un signal connecté à Sprite::wakeUp())
+//! ou lors d'un contact (wakeUpCollidingSprites()). Le coût d'un tick dépend ainsi du nombre de
+//! sprites éveillés, et non du nombre de sprites abonnés.
+//!
+//! Pour les sprites au déplacement simple (projectiles, particules, débris), la scène met à
+//! disposition un système de déplacement (movementSystem()), mis à jour à chaque tick avant
+//! les sprites abonnés.
+//!
 //! Les méthodes isInsideScene() permettent de savoir si un sprite ou un rectangle (QRectF) se trouvent complètement à l'intérieur de la scène.
 //!
 //! Les méthodes centerViewOn() permettent de s'assurer, lorsque la scène est plus vaste que la partie affichée par la vue, que le sprite
@@ -48,6 +69,8 @@ class GameScene : public QGraphicsScene
 {
     Q_OBJECT
 public:
+    enum { SLEEP_UNTIL_WOKEN = -1 };
+
     ~GameScene() override;
 
     void addSpriteToScene(Sprite* pSprite);
@@ -74,17 +97,28 @@ public:
     void unregisterSpriteFromTick(Sprite* pSprite);
     bool isRegisteredForTick(const Sprite* pSprite) const;
 
+    void sleepSprite(Sprite* pSprite, long long sleepDurationInMilliseconds = SLEEP_UNTIL_WOKEN);
+    void wakeUpSprite(Sprite* pSprite);
+    void wakeUpCollidingSprites(const Sprite* pSprite);
+    bool isSleeping(const Sprite* pSprite) const;
+
+    MovementSystem* movementSystem() const;
+
     bool isInsideScene(const QPointF& rPosition) const;
     bool isInsideScene(const QRectF& rRect) const;
 
     void centerViewOn(const Sprite* pSprite);
     void centerViewOn(QPointF pos);
 
+    void setTickBudget(int tickBudgetInMilliseconds);
+    int tickBudget() const;
+
     virtual void tick(long long elapsedTimeInMilliseconds);
 
 signals:
     void spriteAddedToScene(Sprite* pSprite);
     void spriteRemovedFromScene(Sprite* pSprite);
+    void tickBudgetExceeded(long long tickDurationInMilliseconds, int deferredSpriteCount);
 
 protected:
     virtual void drawBackground(QPainter* pPainter, const QRectF& rRect) override;
@@ -101,9 +135,21 @@ private:
     explicit GameScene(qreal x, qreal y, qreal width, qreal height, QObject* pParent = nullptr);
 
     void init();
+    void tickSprite(Sprite* pSprite);
+    void compactSleepingSprites();
+    void wakeUpExpiredSleepers();
+    void forgetSleepState(const Sprite* pSprite);
 
     QImage* m_pBackgroundImage;
-    QList<Sprite*> m_registeredForTickSpriteList;
+    MovementSystem* m_pMovementSystem;
+    QList<Sprite*> m_registeredForTickSpriteList; // Sprites abonnés et éveillés
+    QHash<const Sprite*, long long> m_pendingTickTime; // Temps écoulé depuis le dernier tick effectif de chaque sprite
+    QSet<const Sprite*> m_sleepingSprites;       // Endormis et retirés de la liste des sprites éveillés
+    QSet<const Sprite*> m_pendingSleepSprites;   // Endormis, mais pas encore retirés de la liste des sprites éveillés
+    QMultiMap<long long, Sprite*> m_wakeUpTimes; // Échéances de réveil, en temps de scène
+    QHash<const Sprite*, long long> m_wakeUpTimeBySprite;
+    long long m_sceneTime;                       // Temps cumulé des ticks, en millisecondes
+    int m_tickBudget;
     QGraphicsRectItem* outlineRect;
 
 private slots:
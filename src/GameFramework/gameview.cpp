@@ -9,6 +9,8 @@
 #include <QDebug>
 #include <QMouseEvent>
 
+#include "tracing.h"
+
 //! Construit une fenêtre de visualisation de la scène de jeu.
 //! \param pParent  Widget parent.
 GameView::GameView(QWidget* pParent) : QGraphicsView(pParent) {
@@ -86,6 +88,13 @@ void GameView::resizeEvent(QResizeEvent* pEvent) {
     }
 }
 
+//! Dessine la vue.
+//! \param pEvent   Evénement de dessin reçu.
+void GameView::paintEvent(QPaintEvent* pEvent) {
+    TRACE_SCOPE("GameView::paintEvent");
+    QGraphicsView::paintEvent(pEvent);
+}
+
 //! Si la scène doit être clippée, dessine en avant-plan des rectangles permettant
 //! de cacher les marges de la scène, car il n'y a pas de méthodes propres à Qt le permettant,
 //! étant donné que chaque QGraphicsItem est responsable de se dessiner.
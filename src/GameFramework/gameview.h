@@ -39,6 +39,7 @@ public:
 
 protected:
     virtual void resizeEvent(QResizeEvent* pEvent) override;
+    virtual void paintEvent(QPaintEvent* pEvent) override;
     virtual void drawForeground(QPainter* pPainter, const QRectF& rRect) override;
 
 private:
@@ -0,0 +1,209 @@
+/**
+  \file
+  \brief    Définition de la classe MovementSystem.
+  \author   Noah Blattner
+  \date     octobre 2026
+*/
+#include "movementsystem.h"
+
+#include <limits>
+
+#include "sprite.h"
+
+//! Ajoute un sprite au système de déplacement.
+//! Si le sprite est déjà géré par le système, ses composantes sont remplacées.
+//! La position et la rotation initiales sont celles du sprite.
+//! \param pSprite                  Sprite à déplacer.
+//! \param velocity                 Vitesse initiale, en pixels par seconde.
+//! \param acceleration             Accélération, en pixels par seconde au carré.
+//! \param angularVelocity          Vitesse angulaire, en degrés par seconde.
+//! \param lifetimeInMilliseconds   Durée de vie du sprite. Avec INFINITE_LIFETIME, le sprite n'expire pas.
+void MovementSystem::addSprite(Sprite* pSprite, QPointF velocity, QPointF acceleration,
+                               qreal angularVelocity, long long lifetimeInMilliseconds) {
+    Q_ASSERT(pSprite != nullptr);
+
+    removeSprite(pSprite);
+
+    m_indexBySprite.insert(pSprite, m_sprites.count());
+    m_sprites.append(pSprite);
+    m_posX.append(static_cast<float>(pSprite->x()));
+    m_posY.append(static_cast<float>(pSprite->y()));
+    m_velocityX.append(static_cast<float>(velocity.x()));
+    m_velocityY.append(static_cast<float>(velocity.y()));
+    m_accelerationX.append(static_cast<float>(acceleration.x()));
+    m_accelerationY.append(static_cast<float>(acceleration.y()));
+    m_rotation.append(static_cast<float>(pSprite->rotation()));
+    m_angularVelocity.append(static_cast<float>(angularVelocity));
+    m_remainingLifetime.append(lifetimeInMilliseconds < 0 ? std::numeric_limits<float>::infinity()
+                                                          : static_cast<float>(lifetimeInMilliseconds));
+}
+
+//! Retire un sprite du système de déplacement. Le sprite n'est pas détruit.
+//! \param pSprite  Sprite à retirer.
+void MovementSystem::removeSprite(const Sprite* pSprite) {
+    auto indexIt = m_indexBySprite.constFind(pSprite);
+    if (indexIt == m_indexBySprite.constEnd())
+        return;
+
+    removeAt(indexIt.value());
+}
+
+//! \return un booléen indiquant si le sprite donné est géré par le système.
+bool MovementSystem::contains(const Sprite* pSprite) const {
+    return m_indexBySprite.contains(pSprite);
+}
+
+//! Retire tous les sprites du système de déplacement.
+void MovementSystem::clear() {
+    m_sprites.clear();
+    m_posX.clear();
+    m_posY.clear();
+    m_velocityX.clear();
+    m_velocityY.clear();
+    m_accelerationX.clear();
+    m_accelerationY.clear();
+    m_rotation.clear();
+    m_angularVelocity.clear();
+    m_remainingLifetime.clear();
+    m_indexBySprite.clear();
+}
+
+//! Déplace instantanément un sprite géré par le système.
+//! \param pSprite   Sprite à déplacer.
+//! \param position  Nouvelle position.
+void MovementSystem::setPosition(const Sprite* pSprite, QPointF position) {
+    int index = m_indexBySprite.value(pSprite, -1);
+    if (index < 0)
+        return;
+
+    m_posX[index] = static_cast<float>(position.x());
+    m_posY[index] = static_cast<float>(position.y());
+    m_sprites[index]->setPos(position);
+}
+
+//! Change la vitesse d'un sprite géré par le système.
+//! \param pSprite   Sprite à modifier.
+//! \param velocity  Nouvelle vitesse, en pixels par seconde.
+void MovementSystem::setVelocity(const Sprite* pSprite, QPointF velocity) {
+    int index = m_indexBySprite.value(pSprite, -1);
+    if (index < 0)
+        return;
+
+    m_velocityX[index] = static_cast<float>(velocity.x());
+    m_velocityY[index] = static_cast<float>(velocity.y());
+}
+
+//! \return la vitesse actuelle du sprite donné, ou un vecteur nul s'il n'est pas géré par le système.
+QPointF MovementSystem::velocity(const Sprite* pSprite) const {
+    int index = m_indexBySprite.value(pSprite, -1);
+    if (index < 0)
+        return QPointF(0, 0);
+
+    return QPointF(m_velocityX[index], m_velocityY[index]);
+}
+
+//! Change l'accélération d'un sprite géré par le système.
+//! \param pSprite       Sprite à modifier.
+//! \param acceleration  Nouvelle accélération, en pixels par seconde au carré.
+void MovementSystem::setAcceleration(const Sprite* pSprite, QPointF acceleration) {
+    int index = m_indexBySprite.value(pSprite, -1);
+    if (index < 0)
+        return;
+
+    m_accelerationX[index] = static_cast<float>(acceleration.x());
+    m_accelerationY[index] = static_cast<float>(acceleration.y());
+}
+
+//! Change la vitesse angulaire d'un sprite géré par le système.
+//! \param pSprite          Sprite à modifier.
+//! \param angularVelocity  Nouvelle vitesse angulaire, en degrés par seconde.
+void MovementSystem::setAngularVelocity(const Sprite* pSprite, qreal angularVelocity) {
+    int index = m_indexBySprite.value(pSprite, -1);
+    if (index < 0)
+        return;
+
+    m_angularVelocity[index] = static_cast<float>(angularVelocity);
+}
+
+//! Met à jour tous les sprites gérés par le système.
+//! Les composantes sont d'abord intégrées en une passe sur les tableaux, puis les positions
+//! et rotations sont reportées sur les sprites.
+//! \param elapsedTimeInMilliseconds  Temps écoulé depuis la mise à jour précédente.
+//! \return la liste des sprites dont la durée de vie est écoulée. Ils ne font plus partie du système.
+QList<Sprite*> MovementSystem::update(long long elapsedTimeInMilliseconds) {
+    const int spriteCount = m_sprites.count();
+    const float elapsedTime = static_cast<float>(elapsedTimeInMilliseconds);
+    const float deltaTime = elapsedTime / 1000.0f;
+
+    float* pPosX = m_posX.data();
+    float* pPosY = m_posY.data();
+    float* pVelocityX = m_velocityX.data();
+    float* pVelocityY = m_velocityY.data();
+    const float* pAccelerationX = m_accelerationX.constData();
+    const float* pAccelerationY = m_accelerationY.constData();
+    float* pRotation = m_rotation.data();
+    const float* pAngularVelocity = m_angularVelocity.constData();
+    float* pRemainingLifetime = m_remainingLifetime.data();
+
+    // Intégration (sans branchement, afin que le compilateur puisse vectoriser la boucle)
+    for (int i = 0; i < spriteCount; ++i) {
+        pVelocityX[i] += pAccelerationX[i] * deltaTime;
+        pVelocityY[i] += pAccelerationY[i] * deltaTime;
+        pPosX[i] += pVelocityX[i] * deltaTime;
+        pPosY[i] += pVelocityY[i] * deltaTime;
+        pRotation[i] += pAngularVelocity[i] * deltaTime;
+        pRemainingLifetime[i] -= elapsedTime;
+    }
+
+    // Report des résultats sur les sprites
+    for (int i = 0; i < spriteCount; ++i) {
+        Sprite* pSprite = m_sprites[i];
+        pSprite->setPos(pPosX[i], pPosY[i]);
+        if (pAngularVelocity[i] != 0.0f)
+            pSprite->setRotation(pRotation[i]);
+    }
+
+    // Retrait des sprites expirés (parcours à l'envers, car le retrait déplace le dernier élément)
+    QList<Sprite*> expiredSprites;
+    for (int i = spriteCount - 1; i >= 0; --i) {
+        if (m_remainingLifetime[i] <= 0.0f) {
+            expiredSprites.append(m_sprites[i]);
+            removeAt(i);
+        }
+    }
+
+    return expiredSprites;
+}
+
+//! Retire l'entrée à l'index donné en la remplaçant par la dernière entrée.
+//! \param index  Index de l'entrée à retirer.
+void MovementSystem::removeAt(int index) {
+    const int lastIndex = m_sprites.count() - 1;
+
+    m_indexBySprite.remove(m_sprites[index]);
+
+    if (index != lastIndex) {
+        m_sprites[index] = m_sprites[lastIndex];
+        m_posX[index] = m_posX[lastIndex];
+        m_posY[index] = m_posY[lastIndex];
+        m_velocityX[index] = m_velocityX[lastIndex];
+        m_velocityY[index] = m_velocityY[lastIndex];
+        m_accelerationX[index] = m_accelerationX[lastIndex];
+        m_accelerationY[index] = m_accelerationY[lastIndex];
+        m_rotation[index] = m_rotation[lastIndex];
+        m_angularVelocity[index] = m_angularVelocity[lastIndex];
+        m_remainingLifetime[index] = m_remainingLifetime[lastIndex];
+        m_indexBySprite[m_sprites[index]] = index;
+    }
+
+    m_sprites.removeLast();
+    m_posX.removeLast();
+    m_posY.removeLast();
+    m_velocityX.removeLast();
+    m_velocityY.removeLast();
+    m_accelerationX.removeLast();
+    m_accelerationY.removeLast();
+    m_rotation.removeLast();
+    m_angularVelocity.removeLast();
+    m_remainingLifetime.removeLast();
+}
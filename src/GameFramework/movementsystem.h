@@ -0,0 +1,77 @@
+/**
+  \file
+  \brief    Déclaration de la classe MovementSystem.
+  \author   Noah Blattner
+  \date     octobre 2026
+*/
+#ifndef MOVEMENTSYSTEM_H
+#define MOVEMENTSYSTEM_H
+
+#include <QHash>
+#include <QList>
+#include <QPointF>
+#include <QVector>
+
+class Sprite;
+
+//! \brief Système de déplacement simple pour un grand nombre de sprites.
+//!
+//! MovementSystem offre une alternative légère aux gestionnaires de cadence (SpriteTickHandler)
+//! pour les sprites dont le déplacement est purement cinématique : projectiles, particules, débris...
+//!
+//! Les composantes de déplacement (position, vitesse, accélération, vitesse angulaire et durée de vie)
+//! sont stockées dans des tableaux contigus, une entrée par sprite. À chaque tick, update()
+//! met à jour toutes les entrées en une seule passe, sans appel virtuel, puis reporte les positions
+//! et rotations sur les sprites.
+//!
+//! Chaque GameScene possède son propre système (GameScene::movementSystem()), qui est mis à jour
+//! automatiquement lors de GameScene::tick(). Les sprites retirés de la scène ou détruits sont
+//! automatiquement retirés du système.
+//!
+//! Tant qu'un sprite est géré par le système, sa position et sa rotation sont pilotées par celui-ci :
+//! pour le déplacer instantanément, il faut utiliser setPosition() plutôt que Sprite::setPos().
+//!
+//! Les vitesses sont exprimées en pixels par seconde, les accélérations en pixels par seconde au carré
+//! et la vitesse angulaire en degrés par seconde.
+//! Lorsque la durée de vie d'un sprite est écoulée, update() le retire du système et le retourne
+//! à l'appelant (GameScene le retire alors de la scène et le détruit).
+class MovementSystem
+{
+public:
+    enum { INFINITE_LIFETIME = -1 };
+
+    MovementSystem() = default;
+
+    void addSprite(Sprite* pSprite, QPointF velocity, QPointF acceleration = QPointF(0, 0),
+                   qreal angularVelocity = 0, long long lifetimeInMilliseconds = INFINITE_LIFETIME);
+    void removeSprite(const Sprite* pSprite);
+    bool contains(const Sprite* pSprite) const;
+    int count() const { return m_sprites.count(); }
+    void clear();
+
+    void setPosition(const Sprite* pSprite, QPointF position);
+    void setVelocity(const Sprite* pSprite, QPointF velocity);
+    QPointF velocity(const Sprite* pSprite) const;
+    void setAcceleration(const Sprite* pSprite, QPointF acceleration);
+    void setAngularVelocity(const Sprite* pSprite, qreal angularVelocity);
+
+    QList<Sprite*> update(long long elapsedTimeInMilliseconds);
+
+private:
+    void removeAt(int index);
+
+    QVector<Sprite*> m_sprites;
+    QVector<float> m_posX;
+    QVector<float> m_posY;
+    QVector<float> m_velocityX;
+    QVector<float> m_velocityY;
+    QVector<float> m_accelerationX;
+    QVector<float> m_accelerationY;
+    QVector<float> m_rotation;
+    QVector<float> m_angularVelocity;
+    QVector<float> m_remainingLifetime; // En millisecondes, infini si le sprite n'expire pas
+
+    QHash<const Sprite*, int> m_indexBySprite;
+};
+
+#endif // MOVEMENTSYSTEM_H
@@ -254,6 +254,28 @@ void Sprite::unregisterFromTick() {
     m_pParentScene->unregisterSpriteFromTick(this);
 }
 
+//! Endort ce sprite : il reste abonné à la cadence, mais tick() n'est plus appelé
+//! jusqu'à son réveil.
+//! \param sleepDurationInMilliseconds  Durée du sommeil. Avec GameScene::SLEEP_UNTIL_WOKEN,
+//!                                     le sprite dort jusqu'à un appel à wakeUp().
+//! \see GameScene::sleepSprite()
+void Sprite::sleep(long long sleepDurationInMilliseconds) {
+    Q_ASSERT(m_pParentScene != nullptr);
+    m_pParentScene->sleepSprite(this, sleepDurationInMilliseconds);
+}
+
+//! Réveille ce sprite s'il est endormi.
+//! Ce slot peut être connecté à n'importe quel signal qui doit réveiller le sprite.
+void Sprite::wakeUp() {
+    if (m_pParentScene)
+        m_pParentScene->wakeUpSprite(this);
+}
+
+//! \return un booléen à vrai si ce sprite est endormi.
+bool Sprite::isSleeping() const {
+    return m_pParentScene && m_pParentScene->isSleeping(this);
+}
+
 //! Cadence.
 //! Pour qu'un sprite soit cadencé, il doit s'enregister avec la méthode
 //! registerForTick().
@@ -111,6 +111,9 @@ class SpriteTickHandler;
 //! Une dernière solution est  de spécialiser la classe Sprite afin de surcharger
 //! la méthode tick().
 //!
+//! Un sprite abonné qui n'a momentanément rien à faire peut s'endormir avec sleep() :
+//! tick() n'est alors plus appelé jusqu'à l'échéance donnée ou jusqu'à l'appel du slot wakeUp().
+//!
 class Sprite : public QObject, public QGraphicsPixmapItem
 {
     Q_OBJECT
@@ -173,6 +176,8 @@ public:
     virtual void tick(long long elapsedTimeInMilliseconds);
     void registerForTick();
     void unregisterFromTick();
+    void sleep(long long sleepDurationInMilliseconds);
+    bool isSleeping() const;
 
     void setTickHandler(SpriteTickHandler* pTickHandler);
     SpriteTickHandler* tickHandler() const;
@@ -186,6 +191,9 @@ public:
     virtual void paint(QPainter* pPainter, const QStyleOptionGraphicsItem* pOption, QWidget* pWidget = nullptr) override;
 #endif
 
+public slots:
+    void wakeUp();
+
 signals:
     void animationFinished();
     void opacityChanged();
@@ -6,6 +6,7 @@
 */
 #include "spritetickhandler.h"
 
+#include "gamescene.h"
 #include "sprite.h"
 
 //! Construit un gestionnaire de tick pour le Sprite donné.
@@ -24,6 +25,47 @@ void SpriteTickHandler::setParentSprite(Sprite* pParentSprite) {
     m_pParentSprite = pParentSprite;
 }
 
+//! Détermine la priorité de ce gestionnaire lors de la cadence.
+//! \param priority  Priorité du gestionnaire.
+void SpriteTickHandler::setTickPriority(TickPriority priority) {
+    m_tickPriority = priority;
+}
+
+//! \return la priorité de ce gestionnaire lors de la cadence.
+SpriteTickHandler::TickPriority SpriteTickHandler::tickPriority() const {
+    return m_tickPriority;
+}
+
+//! Détermine l'intervalle de temps minimal entre deux appels de tick().
+//! \param tickIntervalInMilliseconds  Intervalle en millisecondes. Avec 0, le gestionnaire
+//!                                    est appelé à chaque tick.
+void SpriteTickHandler::setTickInterval(int tickIntervalInMilliseconds) {
+    m_tickInterval = tickIntervalInMilliseconds < 0 ? 0 : tickIntervalInMilliseconds;
+}
+
+//! \return l'intervalle de temps minimal (en millisecondes) entre deux appels de tick().
+int SpriteTickHandler::tickInterval() const {
+    return m_tickInterval;
+}
+
+//! Endort le sprite géré : ce gestionnaire n'est plus appelé jusqu'à son réveil.
+//! \param sleepDurationInMilliseconds  Durée du sommeil. Avec une valeur négative, le sprite
+//!                                     dort jusqu'à un appel à wakeUp().
+void SpriteTickHandler::sleep(long long sleepDurationInMilliseconds) {
+    m_pParentSprite->sleep(sleepDurationInMilliseconds < 0 ? GameScene::SLEEP_UNTIL_WOKEN
+                                                           : sleepDurationInMilliseconds);
+}
+
+//! Réveille le sprite géré.
+void SpriteTickHandler::wakeUp() {
+    m_pParentSprite->wakeUp();
+}
+
+//! \return un booléen à vrai si le sprite géré est endormi.
+bool SpriteTickHandler::isSleeping() const {
+    return m_pParentSprite->isSleeping();
+}
+
 //! \return un pointeur sur la scène à laquelle appartient le sprite géré
 //! par ce gestionnaire.
 GameScene* SpriteTickHandler::parentScene() const {
@@ -22,9 +22,29 @@ class Sprite;
 //! Depuis le gestionnaire, il est possible d'accéder au Sprite en question avec
 //! l'attribut m_pParentSprite.
 //!
+//! Un gestionnaire peut indiquer sa priorité (setTickPriority()) et la cadence à laquelle
+//! il souhaite être appelé (setTickInterval()). Par défaut, il est de priorité normale et
+//! appelé à chaque tick.
+//! Un gestionnaire de haute priorité est toujours appelé, alors que les gestionnaires de
+//! priorité normale ou basse peuvent être reportés aux ticks suivants si le budget de temps
+//! de la scène est épuisé (voir GameScene::setTickBudget()).
+//! Lorsqu'un appel est reporté ou espacé, le temps reçu par tick() est le temps écoulé
+//! depuis le dernier appel effectif.
+//!
+//! Un gestionnaire inactif peut endormir son sprite avec sleep() : il n'est alors plus appelé
+//! jusqu'à l'échéance donnée, jusqu'à ce que wakeUp() soit appelé (par exemple depuis un
+//! signal connecté au slot Sprite::wakeUp()) ou jusqu'à un contact signalé par
+//! GameScene::wakeUpCollidingSprites().
+//!
 class SpriteTickHandler
 {
 public:
+    enum TickPriority {
+        HIGH_PRIORITY,
+        NORMAL_PRIORITY,
+        LOW_PRIORITY
+    };
+
     SpriteTickHandler(Sprite* pParentSprite = nullptr);
     virtual ~SpriteTickHandler();
 
@@ -34,10 +54,24 @@ public:
     virtual void init() {}
     virtual void tick(long long elapsedTimeInMilliseconds) = 0;
 
+    void setTickPriority(TickPriority priority);
+    TickPriority tickPriority() const;
+
+    void setTickInterval(int tickIntervalInMilliseconds);
+    int tickInterval() const;
+
 protected:
     GameScene* parentScene() const;
 
+    void sleep(long long sleepDurationInMilliseconds = -1);
+    void wakeUp();
+    bool isSleeping() const;
+
     Sprite* m_pParentSprite;
+
+private:
+    TickPriority m_tickPriority = NORMAL_PRIORITY;
+    int m_tickInterval = 0;
 };
 
 #endif // SPRITETICKHANDLER_H
@@ -0,0 +1,147 @@
+/**
+  \file
+  \brief    Instrumentation du jeu au format trace_event (chrome://tracing, Perfetto).
+  \author   Noah Blattner
+  \date     octobre 2026
+*/
+#include "tracing.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QVector>
+
+#include "resources.h"
+
+namespace GameFramework {
+
+    //! Nombre maximal d'événements mémorisés lors d'un enregistrement (environ 32 Mo).
+    static const int MAX_TRACE_EVENTS = 1000000;
+
+    struct TraceEvent {
+        const char* pName;
+        qint64 startTime;
+        qint64 duration;
+        quintptr threadId;
+    };
+
+    static QMutex traceMutex;
+    //! Origine des temps de l'enregistrement courant, en nanosecondes sur monotonicClock().
+    //! Atomique : now() la lit sans verrou, depuis n'importe quel thread, pendant que start() peut la modifier.
+    static std::atomic<qint64> traceClockOrigin(0);
+    static QVector<TraceEvent> traceEvents;
+    static int droppedTraceEventCount = 0;
+    static QString traceFileLocation;
+
+    std::atomic<bool> Tracer::s_enabled(false);
+
+    //! Horloge monotone démarrée une seule fois : elle n'est jamais modifiée ensuite, et peut donc
+    //! être lue depuis n'importe quel thread.
+    static const QElapsedTimer& monotonicClock() {
+        static const QElapsedTimer clock = [] {
+            QElapsedTimer timer;
+            timer.start();
+            return timer;
+        }();
+        return clock;
+    }
+
+    //! Démarre l'enregistrement des traces.
+    //! Les événements d'un éventuel enregistrement précédent sont oubliés.
+    //! \param traceFilePath  Chemin du fichier qui sera écrit par stop(). Si vide, un fichier horodaté
+    //!                       est créé dans le dossier `traces` des ressources.
+    void Tracer::start(const QString& traceFilePath) {
+        QMutexLocker locker(&traceMutex);
+
+        traceFileLocation = traceFilePath;
+        if (traceFileLocation.isEmpty()) {
+            QDir traceDir(resourcesPath() + "traces");
+            if (!traceDir.exists())
+                traceDir.mkpath(".");
+            traceFileLocation = traceDir.filePath(QDateTime::currentDateTime().toString("'trace_'yyyyMMdd_hhmmss'.json'"));
+        }
+
+        traceEvents.clear();
+        traceEvents.reserve(4096);
+        droppedTraceEventCount = 0;
+        traceClockOrigin.store(monotonicClock().nsecsElapsed(), std::memory_order_relaxed);
+
+        s_enabled.store(true, std::memory_order_relaxed);
+    }
+
+    //! Arrête l'enregistrement des traces et écrit le fichier JSON.
+    //! \return le chemin du fichier écrit, ou une chaîne vide si l'écriture a échoué.
+    QString Tracer::stop() {
+        s_enabled.store(false, std::memory_order_relaxed);
+
+        QMutexLocker locker(&traceMutex);
+
+        QFile traceFile(traceFileLocation);
+        if (!traceFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qWarning() << "Impossible d'écrire le fichier de trace" << traceFileLocation;
+            return QString();
+        }
+
+        // Ecriture par blocs, afin de ne pas construire tout le document en mémoire
+        QByteArray chunk = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        for (int i = 0; i < traceEvents.count(); ++i) {
+            const TraceEvent& rEvent = traceEvents[i];
+            QByteArray name(rEvent.pName);
+            name.replace('\\', "\\\\").replace('"', "\\\"");
+
+            chunk += "{\"name\":\"" + name + "\",\"cat\":\"WorldBuildr\",\"ph\":\"X\",\"pid\":1"
+                     + ",\"tid\":" + QByteArray::number(static_cast<qulonglong>(rEvent.threadId))
+                     + ",\"ts\":" + QByteArray::number(rEvent.startTime)
+                     + ",\"dur\":" + QByteArray::number(rEvent.duration) + "}";
+            if (i < traceEvents.count() - 1)
+                chunk += ",\n";
+
+            if (chunk.size() > 64 * 1024) {
+                traceFile.write(chunk);
+                chunk.clear();
+            }
+        }
+        chunk += "\n]}\n";
+        traceFile.write(chunk);
+        traceFile.close();
+
+        if (droppedTraceEventCount > 0)
+            qWarning() << droppedTraceEventCount << "événements de trace ont été ignorés (limite atteinte)";
+
+        traceEvents.clear();
+        traceEvents.squeeze();
+
+        qInfo() << "Trace written to " + traceFileLocation;
+        return traceFileLocation;
+    }
+
+    //! \return le temps écoulé, en microsecondes, depuis le début de l'enregistrement.
+    qint64 Tracer::now() {
+        return (monotonicClock().nsecsElapsed() - traceClockOrigin.load(std::memory_order_relaxed)) / 1000;
+    }
+
+    //! Mémorise un événement de durée.
+    //! Cette méthode peut être appelée depuis n'importe quel thread.
+    //! \param pName      Nom de l'événement (chaîne littérale).
+    //! \param startTime  Début de l'événement, en microsecondes (voir now()).
+    //! \param endTime    Fin de l'événement, en microsecondes.
+    void Tracer::addCompleteEvent(const char* pName, qint64 startTime, qint64 endTime) {
+        quintptr threadId = reinterpret_cast<quintptr>(QThread::currentThreadId());
+
+        QMutexLocker locker(&traceMutex);
+        if (!isEnabled())
+            return;
+
+        if (traceEvents.count() >= MAX_TRACE_EVENTS) {
+            droppedTraceEventCount++;
+            return;
+        }
+
+        traceEvents.append({pName, startTime, endTime - startTime, threadId});
+    }
+}
@@ -0,0 +1,78 @@
+/**
+  \file
+  \brief    Instrumentation du jeu au format trace_event (chrome://tracing, Perfetto).
+  \author   Noah Blattner
+  \date     octobre 2026
+*/
+#ifndef TRACING_H
+#define TRACING_H
+
+#include <atomic>
+
+#include <QString>
+#include <QtGlobal>
+
+// Décommenter pour retirer complètement les marqueurs de trace du code compilé.
+//#define DISABLE_TRACING
+
+//!
+//! Espace de noms contenant les fonctions utilitaires de trace.
+//!
+namespace GameFramework {
+
+    //! \brief Enregistreur de traces.
+    //!
+    //! Tracer mémorise des événements de durée (début et durée, en microsecondes) produits par
+    //! les marqueurs TRACE_SCOPE() placés dans le code, puis les écrit dans un fichier JSON au
+    //! format trace_event, qui peut être ouvert avec chrome://tracing ou https://ui.perfetto.dev.
+    //!
+    //! L'enregistrement est démarré avec start() et stoppé avec stop(), qui écrit le fichier.
+    //! Dans le jeu, Ctrl+Shift+T permet de basculer l'enregistrement (voir GameCanvas).
+    //!
+    //! Lorsque l'enregistrement est arrêté, un marqueur ne coûte qu'une lecture atomique.
+    //! Si DISABLE_TRACING est défini, les marqueurs ne sont plus compilés du tout.
+    //!
+    //! Les noms donnés aux marqueurs doivent être des chaînes littérales : seul leur pointeur est mémorisé.
+    class Tracer {
+    public:
+        static void start(const QString& traceFilePath = QString());
+        static QString stop();
+        static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+        static qint64 now();
+        static void addCompleteEvent(const char* pName, qint64 startTime, qint64 endTime);
+
+    private:
+        static std::atomic<bool> s_enabled;
+    };
+
+    //! \brief Marqueur de trace couvrant la portée dans laquelle il est déclaré.
+    //! \see TRACE_SCOPE()
+    class ScopedTrace {
+    public:
+        explicit ScopedTrace(const char* pName) : m_pName(pName), m_startTime(Tracer::isEnabled() ? Tracer::now() : -1) {}
+        ~ScopedTrace() {
+            if (m_startTime >= 0)
+                Tracer::addCompleteEvent(m_pName, m_startTime, Tracer::now());
+        }
+
+        ScopedTrace(const ScopedTrace&) = delete;
+        ScopedTrace& operator=(const ScopedTrace&) = delete;
+
+    private:
+        const char* m_pName;
+        qint64 m_startTime;
+    };
+}
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifdef DISABLE_TRACING
+    #define TRACE_SCOPE(name)
+#else
+    //! Trace la durée de la portée courante sous le nom donné (chaîne littérale).
+    #define TRACE_SCOPE(name) GameFramework::ScopedTrace TRACE_CONCAT(scopedTrace_, __LINE__)(name)
+#endif
+
+#endif // TRACING_H
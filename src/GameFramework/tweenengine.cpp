@@ -0,0 +1,282 @@
+/**
+  \file
+  \brief    Définition de la classe TweenEngine.
+  \author   Noah Blattner
+  \date     octobre 2026
+*/
+#include "tweenengine.h"
+
+#include <cmath>
+#include <QPointer>
+#include <QtMath>
+
+#include "sprite.h"
+
+//! Construit un moteur d'interpolation sans interpolation en cours.
+//! \param pParent  Objet parent.
+TweenEngine::TweenEngine(QObject* pParent) : QObject(pParent) {
+
+}
+
+//! Démarre l'interpolation d'une propriété d'un sprite entre deux valeurs.
+//! Si la propriété est déjà animée, l'interpolation précédente est remplacée.
+//! \param pSprite                 Sprite à animer.
+//! \param property                Propriété à animer.
+//! \param fromValue               Valeur de départ.
+//! \param toValue                 Valeur d'arrivée.
+//! \param durationInMilliseconds  Durée de l'interpolation.
+//! \param easing                  Courbe d'accélération.
+//! \param delayInMilliseconds     Délai avant le début de l'interpolation.
+void TweenEngine::animate(Sprite* pSprite, Property property, qreal fromValue, qreal toValue,
+                          int durationInMilliseconds, Easing easing, int delayInMilliseconds) {
+    Q_ASSERT(pSprite != nullptr);
+    Q_ASSERT(property >= 0 && property < PROPERTY_COUNT);
+    Q_ASSERT(easing >= 0 && easing < EASING_COUNT);
+
+    const TweenKey key(pSprite, property);
+    int index = m_indexByKey.value(key, -1);
+    if (index < 0) {
+        index = m_sprites.count();
+        m_indexByKey.insert(key, index);
+
+        m_sprites.append(pSprite);
+        m_properties.append(static_cast<quint8>(property));
+        m_easings.append(0);
+        m_fromValues.append(0);
+        m_deltaValues.append(0);
+        m_elapsedTimes.append(0);
+        m_durations.append(0);
+
+        // Une seule connexion par sprite, quel que soit le nombre de ses interpolations
+        if (m_tweenCountBySprite[pSprite]++ == 0)
+            connect(pSprite, &Sprite::spriteDestroyed, this, &TweenEngine::onSpriteDestroyed);
+    }
+
+    m_easings[index] = static_cast<quint8>(easing);
+    m_fromValues[index] = static_cast<float>(fromValue);
+    m_deltaValues[index] = static_cast<float>(toValue - fromValue);
+    m_elapsedTimes[index] = static_cast<float>(delayInMilliseconds > 0 ? -delayInMilliseconds : 0);
+    m_durations[index] = static_cast<float>(durationInMilliseconds > 0 ? durationInMilliseconds : 0);
+}
+
+//! Démarre l'interpolation d'une propriété d'un sprite, de sa valeur actuelle vers la valeur donnée.
+//! \param pSprite                 Sprite à animer.
+//! \param property                Propriété à animer.
+//! \param toValue                 Valeur d'arrivée.
+//! \param durationInMilliseconds  Durée de l'interpolation.
+//! \param easing                  Courbe d'accélération.
+//! \param delayInMilliseconds     Délai avant le début de l'interpolation.
+void TweenEngine::animateTo(Sprite* pSprite, Property property, qreal toValue,
+                            int durationInMilliseconds, Easing easing, int delayInMilliseconds) {
+    animate(pSprite, property, propertyValue(pSprite, property), toValue,
+            durationInMilliseconds, easing, delayInMilliseconds);
+}
+
+//! Démarre le déplacement d'un sprite, de sa position actuelle vers la position donnée.
+//! Deux interpolations sont créées, une pour chaque axe.
+//! \param pSprite                 Sprite à déplacer.
+//! \param toPosition              Position d'arrivée.
+//! \param durationInMilliseconds  Durée du déplacement.
+//! \param easing                  Courbe d'accélération.
+//! \param delayInMilliseconds     Délai avant le début du déplacement.
+void TweenEngine::animatePosTo(Sprite* pSprite, QPointF toPosition,
+                               int durationInMilliseconds, Easing easing, int delayInMilliseconds) {
+    animateTo(pSprite, POS_X, toPosition.x(), durationInMilliseconds, easing, delayInMilliseconds);
+    animateTo(pSprite, POS_Y, toPosition.y(), durationInMilliseconds, easing, delayInMilliseconds);
+}
+
+//! Abandonne l'interpolation d'une propriété d'un sprite. La propriété garde sa valeur actuelle.
+//! \param pSprite   Sprite concerné.
+//! \param property  Propriété dont l'interpolation doit être abandonnée.
+void TweenEngine::stopTween(const Sprite* pSprite, Property property) {
+    const int index = m_indexByKey.value(TweenKey(pSprite, property), -1);
+    if (index >= 0)
+        removeAt(index);
+}
+
+//! Abandonne toutes les interpolations d'un sprite.
+//! \param pSprite   Sprite concerné.
+void TweenEngine::stopTweens(const Sprite* pSprite) {
+    for (int property = 0; property < PROPERTY_COUNT && m_tweenCountBySprite.contains(pSprite); ++property)
+        stopTween(pSprite, static_cast<Property>(property));
+}
+
+//! Abandonne toutes les interpolations.
+void TweenEngine::clear() {
+    for (auto it = m_tweenCountBySprite.cbegin(); it != m_tweenCountBySprite.cend(); ++it)
+        disconnect(it.key(), &Sprite::spriteDestroyed, this, &TweenEngine::onSpriteDestroyed);
+
+    m_sprites.clear();
+    m_properties.clear();
+    m_easings.clear();
+    m_fromValues.clear();
+    m_deltaValues.clear();
+    m_elapsedTimes.clear();
+    m_durations.clear();
+    m_indexByKey.clear();
+    m_tweenCountBySprite.clear();
+}
+
+//! \return un booléen à vrai si la propriété donnée du sprite est en cours d'interpolation.
+bool TweenEngine::isAnimating(const Sprite* pSprite, Property property) const {
+    return m_indexByKey.contains(TweenKey(pSprite, property));
+}
+
+//! Fait avancer toutes les interpolations en une passe.
+//! Les interpolations terminées sont retirées, puis le signal tweenFinished() est émis pour
+//! chacune d'elles.
+//! \param elapsedTimeInMilliseconds  Temps écoulé depuis la mise à jour précédente.
+void TweenEngine::update(long long elapsedTimeInMilliseconds) {
+    const int tweenCount = m_sprites.count();
+    if (tweenCount == 0)
+        return;
+
+    const float elapsedTime = static_cast<float>(elapsedTimeInMilliseconds);
+    float* pElapsedTimes = m_elapsedTimes.data();
+    for (int i = 0; i < tweenCount; ++i)
+        pElapsedTimes[i] += elapsedTime;
+
+    QVector<int> finishedIndexes;
+    for (int i = 0; i < tweenCount; ++i) {
+        const float tweenElapsedTime = pElapsedTimes[i];
+        if (tweenElapsedTime < 0)
+            continue; // Délai pas encore écoulé
+
+        const float duration = m_durations[i];
+        const float progress = (duration > 0 && tweenElapsedTime < duration) ? tweenElapsedTime / duration : 1.0f;
+        const qreal value = m_fromValues[i] + m_deltaValues[i] * ease(static_cast<Easing>(m_easings[i]), progress);
+        applyValue(m_sprites[i], static_cast<Property>(m_properties[i]), value);
+
+        if (progress >= 1.0f)
+            finishedIndexes.append(i);
+    }
+
+    if (finishedIndexes.isEmpty())
+        return;
+
+    // Retrait à l'envers, car le retrait déplace le dernier élément
+    QVector<QPair<QPointer<Sprite>, Property>> finishedTweens;
+    finishedTweens.reserve(finishedIndexes.count());
+    for (int i = finishedIndexes.count() - 1; i >= 0; --i) {
+        const int index = finishedIndexes[i];
+        finishedTweens.append(qMakePair(QPointer<Sprite>(m_sprites[index]), static_cast<Property>(m_properties[index])));
+        removeAt(index);
+    }
+
+    // Les signaux sont émis une fois les tableaux à jour, car un slot peut démarrer une nouvelle
+    // interpolation, ou détruire un sprite.
+    for (int i = finishedTweens.count() - 1; i >= 0; --i) {
+        if (!finishedTweens[i].first.isNull())
+            emit tweenFinished(finishedTweens[i].first.data(), finishedTweens[i].second);
+    }
+}
+
+//! Calcule la progression interpolée selon la courbe d'accélération donnée.
+//! \param easing    Courbe d'accélération.
+//! \param progress  Progression linéaire, entre 0 et 1.
+//! \return la progression interpolée (peut légèrement dépasser 1 avec OUT_BACK).
+qreal TweenEngine::ease(Easing easing, qreal progress) {
+    const qreal t = progress;
+    switch (easing) {
+    case LINEAR:       return t;
+    case IN_QUAD:      return t * t;
+    case OUT_QUAD:     return t * (2 - t);
+    case IN_OUT_QUAD:  return t < 0.5 ? 2 * t * t : -1 + (4 - 2 * t) * t;
+    case IN_CUBIC:     return t * t * t;
+    case OUT_CUBIC:    { const qreal u = t - 1; return u * u * u + 1; }
+    case IN_OUT_CUBIC: { const qreal u = 2 * t - 2; return t < 0.5 ? 4 * t * t * t : 0.5 * u * u * u + 1; }
+    case IN_SINE:      return 1 - std::cos(t * M_PI_2);
+    case OUT_SINE:     return std::sin(t * M_PI_2);
+    case IN_OUT_SINE:  return 0.5 * (1 - std::cos(t * M_PI));
+    case OUT_BACK: {
+        const qreal overshoot = 1.70158;
+        const qreal u = t - 1;
+        return 1 + (overshoot + 1) * u * u * u + overshoot * u * u;
+    }
+    case OUT_BOUNCE: {
+        const qreal n = 7.5625;
+        const qreal d = 2.75;
+        if (t < 1 / d)
+            return n * t * t;
+        if (t < 2 / d) {
+            const qreal u = t - 1.5 / d;
+            return n * u * u + 0.75;
+        }
+        if (t < 2.5 / d) {
+            const qreal u = t - 2.25 / d;
+            return n * u * u + 0.9375;
+        }
+        const qreal u = t - 2.625 / d;
+        return n * u * u + 0.984375;
+    }
+    case EASING_COUNT:
+        break;
+    }
+    return t;
+}
+
+//! \return la valeur actuelle de la propriété donnée du sprite.
+qreal TweenEngine::propertyValue(const Sprite* pSprite, Property property) {
+    switch (property) {
+    case POS_X:    return pSprite->x();
+    case POS_Y:    return pSprite->y();
+    case ROTATION: return pSprite->rotation();
+    case SCALE:    return pSprite->scale();
+    case OPACITY:  return pSprite->opacity();
+    case PROPERTY_COUNT:
+        break;
+    }
+    return 0;
+}
+
+//! Applique directement une valeur à la propriété donnée du sprite.
+void TweenEngine::applyValue(Sprite* pSprite, Property property, qreal value) {
+    switch (property) {
+    case POS_X:    pSprite->setX(value); break;
+    case POS_Y:    pSprite->setY(value); break;
+    case ROTATION: pSprite->setRotation(value); break;
+    case SCALE:    pSprite->setScale(value); break;
+    case OPACITY:  pSprite->setOpacity(value); break;
+    case PROPERTY_COUNT:
+        break;
+    }
+}
+
+//! Retire l'interpolation à l'index donné en la remplaçant par la dernière.
+//! \param index  Index de l'interpolation à retirer.
+void TweenEngine::removeAt(int index) {
+    const int lastIndex = m_sprites.count() - 1;
+    Sprite* pSprite = m_sprites[index];
+
+    m_indexByKey.remove(TweenKey(pSprite, m_properties[index]));
+
+    if (index != lastIndex) {
+        m_sprites[index] = m_sprites[lastIndex];
+        m_properties[index] = m_properties[lastIndex];
+        m_easings[index] = m_easings[lastIndex];
+        m_fromValues[index] = m_fromValues[lastIndex];
+        m_deltaValues[index] = m_deltaValues[lastIndex];
+        m_elapsedTimes[index] = m_elapsedTimes[lastIndex];
+        m_durations[index] = m_durations[lastIndex];
+        m_indexByKey[TweenKey(m_sprites[index], m_properties[index])] = index;
+    }
+
+    m_sprites.removeLast();
+    m_properties.removeLast();
+    m_easings.removeLast();
+    m_fromValues.removeLast();
+    m_deltaValues.removeLast();
+    m_elapsedTimes.removeLast();
+    m_durations.removeLast();
+
+    auto countIt = m_tweenCountBySprite.find(pSprite);
+    if (countIt != m_tweenCountBySprite.end() && --countIt.value() == 0) {
+        m_tweenCountBySprite.erase(countIt);
+        disconnect(pSprite, &Sprite::spriteDestroyed, this, &TweenEngine::onSpriteDestroyed);
+    }
+}
+
+//! Abandonne les interpolations du sprite qui va être détruit.
+void TweenEngine::onSpriteDestroyed(Sprite* pSprite) {
+    stopTweens(pSprite);
+}
@@ -0,0 +1,111 @@
+/**
+  \file
+  \brief    Déclaration de la classe TweenEngine.
+  \author   Noah Blattner
+  \date     octobre 2026
+*/
+#ifndef TWEENENGINE_H
+#define TWEENENGINE_H
+
+#include <QHash>
+#include <QObject>
+#include <QPair>
+#include <QPointF>
+#include <QVector>
+
+class Sprite;
+
+//! \brief Moteur d'interpolation (tween) des propriétés des sprites.
+//!
+//! TweenEngine anime la position, la rotation, l'échelle et l'opacité des sprites sans passer
+//! par QPropertyAnimation : aucun objet ni minuteur n'est créé par interpolation, et les valeurs
+//! sont appliquées directement sur le sprite, sans passer par le système de méta-objets.
+//!
+//! Les interpolations sont stockées dans des tableaux contigus, une entrée par interpolation,
+//! et sont toutes mises à jour en une seule passe lors de chaque tick (update()).
+//! Le moteur est possédé et cadencé par GameCanvas (GameCanvas::tweenEngine()).
+//!
+//! Chaque propriété d'un sprite ne peut être animée que par une interpolation à la fois : démarrer
+//! une nouvelle interpolation remplace la précédente.
+//! Lorsqu'une interpolation se termine, le signal tweenFinished() est émis. Si un sprite est
+//! détruit, ses interpolations sont automatiquement abandonnées.
+//!
+//! Les durées et délais sont exprimés en millisecondes.
+class TweenEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Property {
+        POS_X,
+        POS_Y,
+        ROTATION,
+        SCALE,
+        OPACITY,
+        PROPERTY_COUNT
+    };
+
+    enum Easing {
+        LINEAR,
+        IN_QUAD,
+        OUT_QUAD,
+        IN_OUT_QUAD,
+        IN_CUBIC,
+        OUT_CUBIC,
+        IN_OUT_CUBIC,
+        IN_SINE,
+        OUT_SINE,
+        IN_OUT_SINE,
+        OUT_BACK,
+        OUT_BOUNCE,
+        EASING_COUNT
+    };
+    Q_ENUM(Property)
+    Q_ENUM(Easing)
+
+    explicit TweenEngine(QObject* pParent = nullptr);
+
+    void animate(Sprite* pSprite, Property property, qreal fromValue, qreal toValue,
+                 int durationInMilliseconds, Easing easing = LINEAR, int delayInMilliseconds = 0);
+    void animateTo(Sprite* pSprite, Property property, qreal toValue,
+                   int durationInMilliseconds, Easing easing = LINEAR, int delayInMilliseconds = 0);
+    void animatePosTo(Sprite* pSprite, QPointF toPosition,
+                      int durationInMilliseconds, Easing easing = LINEAR, int delayInMilliseconds = 0);
+
+    void stopTween(const Sprite* pSprite, Property property);
+    void stopTweens(const Sprite* pSprite);
+    void clear();
+
+    bool isAnimating(const Sprite* pSprite, Property property) const;
+    int tweenCount() const { return m_sprites.count(); }
+
+    void update(long long elapsedTimeInMilliseconds);
+
+    static qreal ease(Easing easing, qreal progress);
+    static qreal propertyValue(const Sprite* pSprite, Property property);
+
+signals:
+    void tweenFinished(Sprite* pSprite, TweenEngine::Property property);
+
+private:
+    typedef QPair<const Sprite*, int> TweenKey;
+
+    void removeAt(int index);
+    static void applyValue(Sprite* pSprite, Property property, qreal value);
+
+    QVector<Sprite*> m_sprites;
+    QVector<quint8> m_properties;
+    QVector<quint8> m_easings;
+    QVector<float> m_fromValues;
+    QVector<float> m_deltaValues;
+    QVector<float> m_elapsedTimes; // Négatif tant que le délai n'est pas écoulé
+    QVector<float> m_durations;
+
+    QHash<TweenKey, int> m_indexByKey;
+    QHash<const Sprite*, int> m_tweenCountBySprite;
+
+private slots:
+    void onSpriteDestroyed(Sprite* pSprite);
+};
+
+#endif // TWEENENGINE_H
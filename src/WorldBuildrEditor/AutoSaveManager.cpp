@@ -0,0 +1,342 @@
+/**
+ * @file AutoSaveManager.cpp
+ * @brief Définition de la classe AutoSaveManager.
+ * @author Noah Blattner
+ * @date Octobre 2026
+ */
+
+#include "AutoSaveManager.h"
+
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QHash>
+#include <QIODevice>
+#include <QSaveFile>
+#include <QUuid>
+
+#include "EditorManager.h"
+#include "EditorSprite.h"
+#include "LevelFile.h"
+#include "SaveFileManager.h"
+#include "resources.h"
+#include "tracing.h"
+
+namespace {
+
+//! Écrit un sprite de niveau dans un flux
+QDataStream& operator<<(QDataStream& stream, const LevelSprite& sprite) {
+    return stream << sprite.id << sprite.texturePath << sprite.tag << sprite.x << sprite.y
+                  << sprite.rotation << sprite.scale << sprite.opacity << sprite.z;
+}
+
+//! Lit un sprite de niveau depuis un flux
+QDataStream& operator>>(QDataStream& stream, LevelSprite& sprite) {
+    return stream >> sprite.id >> sprite.texturePath >> sprite.tag >> sprite.x >> sprite.y
+                  >> sprite.rotation >> sprite.scale >> sprite.opacity >> sprite.z;
+}
+
+}
+
+//! Constructeur. La sauvegarde automatique suit les modifications de l'éditeur donné
+//! \param pEditorManager L'éditeur, qui devient le parent de cet objet
+AutoSaveManager::AutoSaveManager(EditorManager* pEditorManager) : QObject(pEditorManager), m_pEditorManager(pEditorManager) {
+    m_writerPool.setMaxThreadCount(1);
+
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(FLUSH_DELAY);
+    connect(&m_flushTimer, &QTimer::timeout, this, &AutoSaveManager::flush);
+
+    connect(m_pEditorManager, &EditorManager::editorSpriteAdded, this, &AutoSaveManager::onEditorSpriteAdded);
+    connect(m_pEditorManager, &EditorManager::editorSpriteDeleted, this, &AutoSaveManager::onEditorSpriteDeleted);
+    connect(m_pEditorManager, &EditorManager::historyChanged, this, &AutoSaveManager::onLevelModified);
+}
+
+//! Destructeur. L'éditeur est fermé normalement : la sauvegarde automatique est supprimée
+AutoSaveManager::~AutoSaveManager() {
+    m_flushTimer.stop();
+    m_writerPool.waitForDone();
+    removeAutoSave();
+}
+
+//! Retourne le dossier de la sauvegarde automatique
+QString AutoSaveManager::autoSaveDirectory() {
+    return SaveFileManager::DEFAULT_SAVE_DIR + "/autosave";
+}
+
+//! Retourne le chemin de la sauvegarde complète
+QString AutoSaveManager::levelFilePath() {
+    return autoSaveDirectory() + "/autosave" + LevelFile::BINARY_EXTENSION;
+}
+
+//! Retourne le chemin du journal des modifications
+QString AutoSaveManager::journalFilePath() {
+    return autoSaveDirectory() + "/autosave.journal";
+}
+
+//! Indique si une sauvegarde automatique existe, par exemple après un arrêt brutal de l'éditeur
+bool AutoSaveManager::hasAutoSave() {
+    return QFile::exists(levelFilePath());
+}
+
+//! Relit la sauvegarde automatique : la sauvegarde complète, puis les modifications de son journal
+//! \param level Reçoit le niveau. Son jeton d'historique est vide : il ne correspond à aucun journal d'historique
+//! \return true si la sauvegarde complète a pu être lue
+bool AutoSaveManager::readAutoSave(LevelData& level) {
+    TRACE_SCOPE("AutoSaveManager::readAutoSave");
+
+    if (!LevelFile::readFile(levelFilePath(), level)) {
+        return false;
+    }
+    QString token = level.historyToken;
+    level.historyToken.clear();
+
+    QFile file(journalFilePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return true;
+    }
+
+    QDataStream stream(&file);
+    quint32 magic = 0;
+    quint32 version = 0;
+    QString journalToken;
+    stream >> magic >> version;
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream >> journalToken;
+    if (stream.status() != QDataStream::Ok || magic != MAGIC || version != VERSION || journalToken != token) {
+        return true; // Le journal ne correspond pas à la sauvegarde complète
+    }
+
+    // Index de chaque sprite dans le niveau, pour rejouer les modifications en temps constant
+    QHash<quint64, qsizetype> spriteIndices;
+    spriteIndices.reserve(level.sprites.size());
+    for (qsizetype i = 0; i < level.sprites.size(); i++) {
+        spriteIndices.insert(level.sprites[i].id, i);
+    }
+    QSet<quint64> deletedSpriteIds;
+
+    while (!stream.atEnd()) {
+        quint8 type = 0;
+        quint32 payloadSize = 0;
+        stream >> type >> payloadSize;
+        // La taille est lue dans le fichier : elle est vérifiée avant d'allouer l'enregistrement
+        if (stream.status() != QDataStream::Ok || payloadSize > file.bytesAvailable()) {
+            break; // Enregistrement incomplet : le journal a été tronqué
+        }
+        QByteArray payload(static_cast<qsizetype>(payloadSize), Qt::Uninitialized);
+        if (stream.readRawData(payload.data(), payload.size()) != payload.size()) {
+            break;
+        }
+
+        QDataStream payloadStream(payload);
+        payloadStream.setVersion(QDataStream::Qt_6_0);
+
+        switch (static_cast<RecordType>(type)) {
+            case SpriteStateRecord: {
+                LevelSprite sprite;
+                payloadStream >> sprite;
+                auto it = spriteIndices.constFind(sprite.id);
+                if (it != spriteIndices.constEnd()) {
+                    level.sprites[it.value()] = sprite;
+                } else {
+                    spriteIndices.insert(sprite.id, level.sprites.size());
+                    level.sprites.append(sprite);
+                }
+                deletedSpriteIds.remove(sprite.id);
+                break;
+            }
+            case SpriteDeletedRecord: {
+                quint64 id = 0;
+                payloadStream >> id;
+                deletedSpriteIds.insert(id);
+                break;
+            }
+            case LevelStateRecord:
+                payloadStream >> level.sceneSize >> level.background >> level.tags;
+                break;
+        }
+    }
+
+    // On retire les sprites supprimés
+    if (!deletedSpriteIds.isEmpty()) {
+        level.sprites.removeIf([&deletedSpriteIds](const LevelSprite& sprite) {
+            return deletedSpriteIds.contains(sprite.id);
+        });
+    }
+
+    // Les sprites du journal ne référencent pas la table des textures de la sauvegarde complète
+    LevelFile::indexTextures(level);
+    return true;
+}
+
+//! Supprime la sauvegarde automatique
+void AutoSaveManager::removeAutoSave() {
+    QFile::remove(journalFilePath());
+    QFile::remove(levelFilePath());
+}
+
+//! Ajoute l'état des sprites marqués au journal, ou compacte le journal si nécessaire
+void AutoSaveManager::flush() {
+    TRACE_SCOPE("AutoSaveManager::flush");
+
+    m_flushTimer.stop();
+
+    if (m_dirtySpriteIds.isEmpty() && m_deletedSpriteIds.isEmpty() && !m_isLevelDirty) {
+        return;
+    }
+
+    // Sans sauvegarde complète, avec un journal trop grand ou si la majorité des sprites ont été modifiés,
+    // une sauvegarde complète est plus avantageuse
+    qsizetype spriteCount = m_pEditorManager->getEditorSprites().size();
+    if (m_token.isEmpty() || m_journalSize > COMPACTION_SIZE || m_dirtySpriteIds.size() > spriteCount / 2) {
+        compact();
+        return;
+    }
+
+    // Les enregistrements sont préparés ici, puis écrits par le fil d'écriture
+    const QString resourcesPath = QDir::toNativeSeparators(GameFramework::resourcesPath());
+    QByteArray records;
+    for (quint64 id : std::as_const(m_dirtySpriteIds)) {
+        EditorSprite* pSprite = m_pEditorManager->editorSpriteById(id);
+        if (pSprite == nullptr) {
+            continue;
+        }
+        QByteArray payload;
+        QDataStream stream(&payload, QIODevice::WriteOnly);
+        stream.setVersion(QDataStream::Qt_6_0);
+        stream << SaveFileManager::convertSpriteToLevel(pSprite, resourcesPath);
+        appendRecord(records, SpriteStateRecord, payload);
+    }
+    for (quint64 id : std::as_const(m_deletedSpriteIds)) {
+        QByteArray payload;
+        QDataStream stream(&payload, QIODevice::WriteOnly);
+        stream << id;
+        appendRecord(records, SpriteDeletedRecord, payload);
+    }
+    if (m_isLevelDirty) {
+        LevelData level = SaveFileManager::convertEditorToLevelHeader(m_pEditorManager);
+        QByteArray payload;
+        QDataStream stream(&payload, QIODevice::WriteOnly);
+        stream.setVersion(QDataStream::Qt_6_0);
+        stream << level.sceneSize << level.background << level.tags;
+        appendRecord(records, LevelStateRecord, payload);
+    }
+
+    m_dirtySpriteIds.clear();
+    m_deletedSpriteIds.clear();
+    m_isLevelDirty = false;
+    m_journalSize += records.size();
+
+    QString filePath = journalFilePath();
+    m_writerPool.start([filePath, records]() {
+        TRACE_SCOPE("AutoSaveManager::appendJournal");
+
+        QFile file(filePath);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Append) || file.write(records) != records.size()) {
+            qWarning() << "Impossible d'écrire le journal de la sauvegarde automatique" << filePath;
+        }
+    });
+}
+
+//! Écrit une sauvegarde complète de l'éditeur, puis vide le journal
+void AutoSaveManager::compact() {
+    TRACE_SCOPE("AutoSaveManager::compact");
+
+    m_flushTimer.stop();
+    m_dirtySpriteIds.clear();
+    m_deletedSpriteIds.clear();
+    m_isLevelDirty = false;
+
+    // La copie du niveau est prise ici ; sa conversion et son écriture ont lieu sur le fil d'écriture.
+    // Le jeton est écrit à la place du jeton d'historique, qui n'a pas de sens pour une sauvegarde automatique
+    m_token = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    LevelData level = SaveFileManager::convertEditorToLevel(m_pEditorManager);
+    level.historyToken = m_token;
+
+    QByteArray journalHeader;
+    {
+        QDataStream stream(&journalHeader, QIODevice::WriteOnly);
+        stream << MAGIC << VERSION;
+        stream.setVersion(QDataStream::Qt_6_0);
+        stream << m_token;
+    }
+    m_journalSize = journalHeader.size();
+
+    QString directory = autoSaveDirectory();
+    QString levelPath = levelFilePath();
+    QString journalPath = journalFilePath();
+    m_writerPool.start([directory, levelPath, journalPath, level, journalHeader]() {
+        TRACE_SCOPE("AutoSaveManager::writeCompaction");
+
+        QDir().mkpath(directory);
+
+        // La sauvegarde complète est écrite avant le journal : en cas d'arrêt entre les deux,
+        // l'ancien journal ne correspond plus à la sauvegarde complète et sera ignoré
+        QSaveFile levelFile(levelPath);
+        if (!levelFile.open(QIODevice::WriteOnly) || !LevelFile::writeBinary(&levelFile, level) || !levelFile.commit()) {
+            qWarning() << "Impossible d'écrire la sauvegarde automatique" << levelPath;
+            return;
+        }
+
+        QSaveFile journalFile(journalPath);
+        if (!journalFile.open(QIODevice::WriteOnly) || journalFile.write(journalHeader) != journalHeader.size() || !journalFile.commit()) {
+            qWarning() << "Impossible d'écrire le journal de la sauvegarde automatique" << journalPath;
+        }
+    });
+}
+
+//! Ajoute un enregistrement à un tampon : son type, la taille de ses données, puis ses données
+//! \param buffer Le tampon
+//! \param type Le type d'enregistrement
+//! \param payload Les données de l'enregistrement
+void AutoSaveManager::appendRecord(QByteArray& buffer, RecordType type, const QByteArray& payload) {
+    QDataStream stream(&buffer, QIODevice::WriteOnly | QIODevice::Append);
+    stream << static_cast<quint8>(type) << static_cast<quint32>(payload.size());
+    stream.writeRawData(payload.constData(), payload.size());
+}
+
+//! Planifie l'écriture du prochain lot
+void AutoSaveManager::markDirty() {
+    if (!m_flushTimer.isActive()) {
+        m_flushTimer.start();
+    }
+}
+
+//! Slot appelé à l'ajout d'un sprite à l'éditeur : le sprite est suivi et marqué comme modifié
+//! \param pEditSprite Le sprite ajouté
+void AutoSaveManager::onEditorSpriteAdded(EditorSprite* pEditSprite) {
+    connect(pEditSprite, &EditorSprite::editorSpriteModified, this, &AutoSaveManager::onEditorSpriteModified, Qt::UniqueConnection);
+
+    m_deletedSpriteIds.remove(pEditSprite->getId());
+    m_dirtySpriteIds.insert(pEditSprite->getId());
+    markDirty();
+}
+
+//! Slot appelé à la suppression d'un sprite de l'éditeur. Le sprite peut être conservé par l'historique :
+//! il n'est plus suivi jusqu'à ce qu'il soit de nouveau ajouté
+//! \param pEditSprite Le sprite supprimé
+void AutoSaveManager::onEditorSpriteDeleted(EditorSprite* pEditSprite) {
+    disconnect(pEditSprite, &EditorSprite::editorSpriteModified, this, &AutoSaveManager::onEditorSpriteModified);
+
+    m_dirtySpriteIds.remove(pEditSprite->getId());
+    m_deletedSpriteIds.insert(pEditSprite->getId());
+    markDirty();
+}
+
+//! Slot appelé à la modification d'un sprite suivi
+void AutoSaveManager::onEditorSpriteModified() {
+    auto* pEditSprite = qobject_cast<EditorSprite*>(sender());
+    if (pEditSprite == nullptr) {
+        return;
+    }
+
+    m_dirtySpriteIds.insert(pEditSprite->getId());
+    markDirty();
+}
+
+//! Slot appelé à chaque modification de l'historique : les champs du niveau ont pu changer
+void AutoSaveManager::onLevelModified() {
+    m_isLevelDirty = true;
+    markDirty();
+}
@@ -0,0 +1,93 @@
+/**
+ * @file AutoSaveManager.h
+ * @brief Déclaration de la classe AutoSaveManager.
+ * @author Noah Blattner
+ * @date Octobre 2026
+ */
+
+#ifndef WORLDBUILDR_AUTOSAVEMANAGER_H
+#define WORLDBUILDR_AUTOSAVEMANAGER_H
+
+#include <QByteArray>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QThreadPool>
+#include <QTimer>
+
+class EditorManager;
+class EditorSprite;
+struct LevelData;
+
+//! Sauvegarde automatique incrémentale de l'éditeur, permettant de récupérer le niveau après un arrêt brutal.
+//!
+//! La sauvegarde automatique est composée de deux fichiers, dans le dossier autoSaveDirectory() :
+//! - une sauvegarde complète du niveau, au format binaire (voir LevelFile), marquée d'un jeton unique ;
+//! - un journal des modifications faites depuis cette sauvegarde complète, qui commence par le même jeton.
+//!
+//! Les sprites ajoutés, modifiés (EditorSprite::editorSpriteModified()) ou supprimés sont marqués comme modifiés.
+//! Toutes les FLUSH_DELAY millisecondes, seul l'état des sprites marqués est ajouté à la fin du journal :
+//! les écritures sont proportionnelles aux modifications, et non à la taille du niveau.
+//! Les champs du niveau (taille de la scène, arrière-plan, tags) sont ajoutés à chaque lot.
+//!
+//! Lorsque le journal dépasse COMPACTION_SIZE octets, ou qu'un lot concerne la majorité des sprites (après un chargement,
+//! par exemple), le journal est compacté : une nouvelle sauvegarde complète est écrite, puis le journal est vidé.
+//! Un journal dont le jeton ne correspond pas à la sauvegarde complète (arrêt entre ces deux écritures) est ignoré.
+//!
+//! Les enregistrements sont préparés sur le fil principal, puis écrits sur un fil dédié, comme pour EditorJournal.
+//! À la fermeture normale de l'éditeur, la sauvegarde automatique est supprimée. Si elle existe au démarrage,
+//! readAutoSave() relit la sauvegarde complète et rejoue le journal jusqu'au dernier enregistrement complet.
+class AutoSaveManager : public QObject {
+    Q_OBJECT
+
+public:
+    explicit AutoSaveManager(EditorManager* pEditorManager);
+    ~AutoSaveManager() override;
+
+    enum RecordType : quint8 {
+        SpriteStateRecord,
+        SpriteDeletedRecord,
+        LevelStateRecord
+    };
+
+    static QString autoSaveDirectory();
+    static QString levelFilePath();
+    static QString journalFilePath();
+
+    static bool hasAutoSave();
+    static bool readAutoSave(LevelData& level);
+    static void removeAutoSave();
+
+    void flush();
+    void compact();
+
+private:
+    static constexpr quint32 MAGIC = 0x57424153; // "WBAS"
+    static constexpr quint32 VERSION = 1;
+    int const FLUSH_DELAY = 5000; // En millisecondes
+    qint64 const COMPACTION_SIZE = 4 * 1024 * 1024; // En octets
+
+    static void appendRecord(QByteArray& buffer, RecordType type, const QByteArray& payload);
+    void markDirty();
+
+    EditorManager* m_pEditorManager;
+
+    QSet<quint64> m_dirtySpriteIds; // Sprites ajoutés ou modifiés depuis le dernier lot
+    QSet<quint64> m_deletedSpriteIds; // Sprites supprimés depuis le dernier lot
+    bool m_isLevelDirty = false;
+
+    QString m_token; // Jeton de la sauvegarde complète courante, vide si aucune n'a été écrite
+    qint64 m_journalSize = 0;
+
+    QTimer m_flushTimer;
+    QThreadPool m_writerPool; // Un seul fil : les écritures ont lieu dans l'ordre
+
+private slots:
+    void onEditorSpriteAdded(EditorSprite* pEditSprite);
+    void onEditorSpriteDeleted(EditorSprite* pEditSprite);
+    void onEditorSpriteModified();
+    void onLevelModified();
+};
+
+
+#endif //WORLDBUILDR_AUTOSAVEMANAGER_H
@@ -0,0 +1,380 @@
+/**
+ * @file EditorCommand.cpp
+ * @brief Définition des commandes de l'historique de l'éditeur.
+ * @author Noah Blattner
+ * @date Octobre 2026
+ */
+
+#include "EditorCommand.h"
+
+#include <utility>
+#include "EditorManager.h"
+#include "EditorSprite.h"
+
+//! Lit une liste de valeurs écrite avec l'opérateur << de QVector, qui doit contenir une valeur par sprite.
+//! Contrairement à l'opérateur >>, la taille lue n'est utilisée pour l'allocation qu'après vérification
+//! \param stream          Le flux
+//! \param values          Reçoit les valeurs
+//! \param expectedCount   Le nombre de valeurs attendu
+//! \return true si les valeurs ont pu être lues. Sinon, le flux est marqué comme corrompu
+template <typename T>
+static bool readValues(QDataStream& stream, QVector<T>& values, qsizetype expectedCount) {
+    quint32 count = 0;
+    stream >> count;
+    if (stream.status() != QDataStream::Ok) {
+        return false;
+    }
+    if (static_cast<qsizetype>(count) != expectedCount) {
+        stream.setStatus(QDataStream::ReadCorruptData);
+        return false;
+    }
+
+    values.resize(count);
+    for (T& value : values) {
+        stream >> value;
+    }
+    return stream.status() == QDataStream::Ok;
+}
+
+/********************************************
+ * EditorCommand
+ *******************************************/
+
+//! Construit une commande.
+//! \param action   L'action effectuée
+//! \param sprites  Les sprites concernés
+EditorCommand::EditorCommand(EditorHistory::Action action, QList<EditorSprite*> sprites) {
+    m_action = action;
+    m_sprites = std::move(sprites);
+}
+
+//! Estime la mémoire occupée par la commande
+//! \return Nombre d'octets
+qint64 EditorCommand::memoryCost() const {
+    return static_cast<qint64>(sizeof(*this)) + m_sprites.size() * static_cast<qint64>(sizeof(EditorSprite*));
+}
+
+//! Écrit une commande dans un flux : l'action, la représentation compacte de chaque sprite, puis les données propres à la commande
+//! \param stream   Le flux
+//! \param pCommand La commande à écrire
+void EditorCommand::write(QDataStream& stream, const EditorCommand* pCommand) {
+    stream << static_cast<quint8>(pCommand->m_action);
+    stream << static_cast<quint32>(pCommand->m_sprites.size());
+    for (const EditorSprite* sprite : pCommand->m_sprites) {
+        stream << sprite->toRecord();
+    }
+    pCommand->writePayload(stream);
+}
+
+//! Recrée une commande écrite avec write()
+//! \param stream        Le flux
+//! \param resolveSprite Fonction qui retourne le sprite correspondant à une représentation compacte (existant ou recréé)
+//! \return La commande recréée, ou nullptr si le flux est invalide. L'appelant en prend la propriété.
+EditorCommand* EditorCommand::read(QDataStream& stream, const std::function<EditorSprite*(const SpriteRecord&)>& resolveSprite) {
+    quint8 action = 0;
+    quint32 spriteCount = 0;
+    stream >> action >> spriteCount;
+    if (stream.status() != QDataStream::Ok) {
+        return nullptr;
+    }
+    // Le nombre de sprites est lu dans le flux : il ne peut pas dépasser le nombre de représentations
+    // compactes que les données restantes peuvent contenir. Un flux corrompu ne provoque donc pas d'allocation démesurée
+    if (action > EditorHistory::RemoveBackground || spriteCount > stream.device()->bytesAvailable() / MIN_SPRITE_RECORD_SIZE) {
+        stream.setStatus(QDataStream::ReadCorruptData);
+        return nullptr;
+    }
+
+    QList<EditorSprite*> sprites;
+    sprites.reserve(spriteCount);
+    for (quint32 i = 0; i < spriteCount; i++) {
+        SpriteRecord record;
+        stream >> record;
+        if (stream.status() != QDataStream::Ok) {
+            return nullptr;
+        }
+        sprites.append(resolveSprite(record));
+    }
+
+    EditorCommand* command = nullptr;
+    auto commandAction = static_cast<EditorHistory::Action>(action);
+    switch (commandAction) {
+        case EditorHistory::MoveSprite:
+            command = new MoveSpritesCommand(std::move(sprites), QVector<QPointF>(spriteCount), QVector<QPointF>(spriteCount));
+            break;
+        case EditorHistory::ChangeZIndex:
+        case EditorHistory::RotateSprite:
+        case EditorHistory::RescaleSprite:
+        case EditorHistory::ChangeOpacity:
+            command = new SpriteValueCommand(commandAction, std::move(sprites), QVector<qreal>(spriteCount), QVector<qreal>(spriteCount));
+            break;
+        case EditorHistory::AddBackground:
+        case EditorHistory::RemoveBackground:
+            command = new BackgroundCommand(commandAction, QString());
+            break;
+        default:
+            command = new SpriteListCommand(commandAction, std::move(sprites));
+            break;
+    }
+
+    command->readPayload(stream);
+    if (stream.status() != QDataStream::Ok) {
+        delete command;
+        return nullptr;
+    }
+    return command;
+}
+
+/********************************************
+ * SpriteListCommand
+ *******************************************/
+
+//! Construit une commande portant sur une liste de sprites.
+//! \param action   L'action effectuée
+//! \param sprites  Les sprites concernés
+SpriteListCommand::SpriteListCommand(EditorHistory::Action action, QList<EditorSprite*> sprites)
+    : EditorCommand(action, std::move(sprites)) {
+    // Les sprites ajoutés ou supprimés peuvent n'être gardés en vie que par cette commande
+    if (action == EditorHistory::AddSprite || action == EditorHistory::DuplicateSprite || action == EditorHistory::RemoveSprite) {
+        for (const EditorSprite* sprite : m_sprites) {
+            m_spritesMemoryCost += sprite->memoryCost();
+        }
+    }
+}
+
+//! Estime la mémoire occupée par la commande, y compris celle des sprites ajoutés ou supprimés
+qint64 SpriteListCommand::memoryCost() const {
+    return EditorCommand::memoryCost() + m_spritesMemoryCost;
+}
+
+//! Annule la commande en effectuant l'action inverse
+void SpriteListCommand::undo(EditorManager* pEditorManager) {
+    perform(pEditorManager, EditorHistory::inverseAction(m_action));
+}
+
+//! Rétablit la commande
+void SpriteListCommand::redo(EditorManager* pEditorManager) {
+    perform(pEditorManager, m_action);
+}
+
+//! Effectue l'action donnée sur les sprites de la commande
+//! \param pEditorManager   L'éditeur
+//! \param action           L'action à effectuer
+void SpriteListCommand::perform(EditorManager* pEditorManager, EditorHistory::Action action) {
+    switch (action) {
+        case EditorHistory::AddSprite:
+        case EditorHistory::DuplicateSprite: // On fait la même chose pour les deux actions
+            for (EditorSprite* sprite : m_sprites) {
+                pEditorManager->addEditorSprite(sprite);
+            }
+            break;
+        case EditorHistory::RemoveSprite:
+            for (EditorSprite* sprite : m_sprites) {
+                pEditorManager->deleteEditorSprite(sprite);
+            }
+            break;
+        case EditorHistory::SelectAll:
+            pEditorManager->selectAllEditorSprites();
+            break;
+        case EditorHistory::DeselectAll:
+            pEditorManager->unselectAllEditorSprites();
+            break;
+        case EditorHistory::SelectSprite:
+            pEditorManager->selectMultipleEditorSprites(m_sprites);
+            break;
+        case EditorHistory::DeselectSprite:
+            pEditorManager->unselectMultipleEditorSprites(m_sprites);
+            break;
+        default: // Les autres actions ont leur propre commande
+            break;
+    }
+}
+
+/********************************************
+ * MoveSpritesCommand
+ *******************************************/
+
+//! Construit une commande de déplacement.
+//! \param sprites          Les sprites déplacés
+//! \param positionsBefore  La position de chaque sprite avant le déplacement
+//! \param positionsAfter   La position de chaque sprite après le déplacement
+MoveSpritesCommand::MoveSpritesCommand(QList<EditorSprite*> sprites, QVector<QPointF> positionsBefore, QVector<QPointF> positionsAfter)
+    : EditorCommand(EditorHistory::MoveSprite, std::move(sprites)) {
+    m_positionsBefore = std::move(positionsBefore);
+    m_positionsAfter = std::move(positionsAfter);
+
+    Q_ASSERT(m_positionsBefore.size() == m_sprites.size() && m_positionsAfter.size() == m_sprites.size());
+}
+
+//! Replace les sprites à leur position d'avant le déplacement
+void MoveSpritesCommand::undo(EditorManager* pEditorManager) {
+    apply(pEditorManager, m_positionsBefore);
+}
+
+//! Replace les sprites à leur position d'après le déplacement
+void MoveSpritesCommand::redo(EditorManager* pEditorManager) {
+    apply(pEditorManager, m_positionsAfter);
+}
+
+//! Absorbe un déplacement qui suit immédiatement celui-ci, s'il porte sur les mêmes sprites.
+//! La position de départ est conservée, la position d'arrivée devient celle de l'autre commande.
+//! \param pOther La commande suivante
+//! \return Vrai si la commande a été absorbée
+bool MoveSpritesCommand::mergeWith(const EditorCommand* pOther) {
+    if (pOther->action() != m_action || pOther->sprites() != m_sprites) {
+        return false;
+    }
+
+    m_positionsAfter = static_cast<const MoveSpritesCommand*>(pOther)->m_positionsAfter;
+    return true;
+}
+
+//! Estime la mémoire occupée par la commande
+qint64 MoveSpritesCommand::memoryCost() const {
+    return EditorCommand::memoryCost() + (m_positionsBefore.size() + m_positionsAfter.size()) * static_cast<qint64>(sizeof(QPointF));
+}
+
+//! Écrit les positions avant et après le déplacement
+void MoveSpritesCommand::writePayload(QDataStream& stream) const {
+    stream << m_positionsBefore << m_positionsAfter;
+}
+
+//! Lit les positions avant et après le déplacement
+void MoveSpritesCommand::readPayload(QDataStream& stream) {
+    readValues(stream, m_positionsBefore, m_sprites.size()) && readValues(stream, m_positionsAfter, m_sprites.size());
+}
+
+//! Place chaque sprite de la commande à la position correspondante
+//! \param pEditorManager   L'éditeur
+//! \param positions        Les positions, dans l'ordre des sprites
+void MoveSpritesCommand::apply(EditorManager* pEditorManager, const QVector<QPointF>& positions) {
+    for (int i = 0; i < m_sprites.size(); i++) {
+        pEditorManager->setEditorSpritePos(m_sprites[i], positions[i]);
+    }
+}
+
+/********************************************
+ * SpriteValueCommand
+ *******************************************/
+
+//! Construit une commande de modification de valeur.
+//! \param action        ChangeZIndex, RotateSprite, RescaleSprite ou ChangeOpacity
+//! \param sprites       Les sprites modifiés
+//! \param valuesBefore  La valeur de chaque sprite avant la modification
+//! \param valuesAfter   La valeur de chaque sprite après la modification
+SpriteValueCommand::SpriteValueCommand(EditorHistory::Action action, QList<EditorSprite*> sprites, QVector<qreal> valuesBefore, QVector<qreal> valuesAfter)
+    : EditorCommand(action, std::move(sprites)) {
+    m_valuesBefore = std::move(valuesBefore);
+    m_valuesAfter = std::move(valuesAfter);
+
+    Q_ASSERT(m_valuesBefore.size() == m_sprites.size() && m_valuesAfter.size() == m_sprites.size());
+}
+
+//! Rétablit la valeur d'avant la modification
+void SpriteValueCommand::undo(EditorManager* pEditorManager) {
+    apply(pEditorManager, m_valuesBefore);
+}
+
+//! Rétablit la valeur d'après la modification
+void SpriteValueCommand::redo(EditorManager* pEditorManager) {
+    apply(pEditorManager, m_valuesAfter);
+}
+
+//! Absorbe une modification de la même valeur qui suit immédiatement celle-ci, si elle porte sur les mêmes sprites.
+//! La valeur de départ est conservée, la valeur d'arrivée devient celle de l'autre commande.
+//! \param pOther La commande suivante
+//! \return Vrai si la commande a été absorbée
+bool SpriteValueCommand::mergeWith(const EditorCommand* pOther) {
+    if (pOther->action() != m_action || pOther->sprites() != m_sprites) {
+        return false;
+    }
+
+    m_valuesAfter = static_cast<const SpriteValueCommand*>(pOther)->m_valuesAfter;
+    return true;
+}
+
+//! Estime la mémoire occupée par la commande
+qint64 SpriteValueCommand::memoryCost() const {
+    return EditorCommand::memoryCost() + (m_valuesBefore.size() + m_valuesAfter.size()) * static_cast<qint64>(sizeof(qreal));
+}
+
+//! Écrit les valeurs avant et après la modification
+void SpriteValueCommand::writePayload(QDataStream& stream) const {
+    stream << m_valuesBefore << m_valuesAfter;
+}
+
+//! Lit les valeurs avant et après la modification
+void SpriteValueCommand::readPayload(QDataStream& stream) {
+    readValues(stream, m_valuesBefore, m_sprites.size()) && readValues(stream, m_valuesAfter, m_sprites.size());
+}
+
+//! Applique à chaque sprite de la commande la valeur correspondante
+//! \param pEditorManager   L'éditeur
+//! \param values           Les valeurs, dans l'ordre des sprites
+void SpriteValueCommand::apply(EditorManager* pEditorManager, const QVector<qreal>& values) {
+    for (int i = 0; i < m_sprites.size(); i++) {
+        switch (m_action) {
+            case EditorHistory::ChangeZIndex:
+                pEditorManager->setEditorSpriteZIndex(m_sprites[i], static_cast<int>(values[i]));
+                break;
+            case EditorHistory::RotateSprite:
+                pEditorManager->setEditorSpriteRotation(m_sprites[i], values[i]);
+                break;
+            case EditorHistory::RescaleSprite:
+                pEditorManager->rescaleEditorSprite(m_sprites[i], values[i]);
+                break;
+            case EditorHistory::ChangeOpacity:
+                pEditorManager->setEditorSpriteOpacity(m_sprites[i], values[i]);
+                break;
+            default: // Les autres actions ne portent pas sur une valeur
+                break;
+        }
+    }
+}
+
+/********************************************
+ * BackgroundCommand
+ *******************************************/
+
+//! Construit une commande d'image de fond.
+//! \param action     AddBackground ou RemoveBackground
+//! \param imagePath  Le chemin de l'image ajoutée ou supprimée
+BackgroundCommand::BackgroundCommand(EditorHistory::Action action, QString imagePath)
+    : EditorCommand(action) {
+    m_imagePath = std::move(imagePath);
+}
+
+//! Annule la commande en effectuant l'action inverse
+void BackgroundCommand::undo(EditorManager* pEditorManager) {
+    perform(pEditorManager, EditorHistory::inverseAction(m_action));
+}
+
+//! Rétablit la commande
+void BackgroundCommand::redo(EditorManager* pEditorManager) {
+    perform(pEditorManager, m_action);
+}
+
+//! Estime la mémoire occupée par la commande
+qint64 BackgroundCommand::memoryCost() const {
+    return EditorCommand::memoryCost() + m_imagePath.size() * static_cast<qint64>(sizeof(QChar));
+}
+
+//! Écrit le chemin de l'image
+void BackgroundCommand::writePayload(QDataStream& stream) const {
+    stream << m_imagePath;
+}
+
+//! Lit le chemin de l'image
+void BackgroundCommand::readPayload(QDataStream& stream) {
+    stream >> m_imagePath;
+}
+
+//! Effectue l'action donnée sur l'image de fond
+//! \param pEditorManager   L'éditeur
+//! \param action           L'action à effectuer
+void BackgroundCommand::perform(EditorManager* pEditorManager, EditorHistory::Action action) {
+    if (action == EditorHistory::AddBackground) {
+        pEditorManager->setBackGroundImage(m_imagePath);
+    } else {
+        pEditorManager->removeBackGroundImage();
+    }
+}
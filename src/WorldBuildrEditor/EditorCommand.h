@@ -0,0 +1,157 @@
+/**
+ * @file EditorCommand.h
+ * @brief Déclaration des commandes de l'historique de l'éditeur.
+ * @author Noah Blattner
+ * @date Octobre 2026
+ */
+
+#ifndef WORLDBUILDR_EDITORCOMMAND_H
+#define WORLDBUILDR_EDITORCOMMAND_H
+
+#include <functional>
+
+#include <QDataStream>
+#include <QList>
+#include <QPointF>
+#include <QString>
+#include <QVector>
+
+#include "EditorHistory.h"
+
+class EditorManager;
+class EditorSprite;
+struct SpriteRecord;
+
+//! Classe abstraite représentant une action enregistrée dans l'historique de l'éditeur.
+//! Chaque commande conserve, sous forme typée, les données nécessaires à son annulation (undo())
+//! et à son rétablissement (redo()). Aucune donnée n'est formatée lors de l'enregistrement,
+//! ni analysée lors de l'annulation.
+//!
+//! L'appel de undo() et redo() a lieu pendant une transaction de l'historique : les commandes peuvent
+//! donc utiliser les méthodes de l'éditeur sans créer de nouvelle entrée.
+//!
+//! Les sprites concernés par la commande sont accessibles avec sprites(). L'historique s'en sert
+//! pour savoir quels sprites il doit garder en vie.
+//!
+//! Une commande peut absorber une commande compatible qui la suit immédiatement (mergeWith()),
+//! ce qui permet à l'historique de regrouper une suite de petites modifications en une seule entrée.
+//!
+//! Une commande peut être sérialisée (write()) puis recréée (read()) : ses sprites sont alors
+//! écrits sous forme compacte (SpriteRecord) et retrouvés, ou recréés, à la lecture.
+//! La méthode memoryCost() estime la mémoire occupée par la commande.
+class EditorCommand {
+public:
+    explicit EditorCommand(EditorHistory::Action action, QList<EditorSprite*> sprites = QList<EditorSprite*>());
+    virtual ~EditorCommand() = default;
+
+    EditorHistory::Action action() const { return m_action; }
+    const QList<EditorSprite*>& sprites() const { return m_sprites; }
+
+    virtual void undo(EditorManager* pEditorManager) = 0;
+    virtual void redo(EditorManager* pEditorManager) = 0;
+
+    virtual bool mergeWith(const EditorCommand* pOther) { Q_UNUSED(pOther); return false; }
+
+    virtual qint64 memoryCost() const;
+
+    static void write(QDataStream& stream, const EditorCommand* pCommand);
+    static EditorCommand* read(QDataStream& stream, const std::function<EditorSprite*(const SpriteRecord&)>& resolveSprite);
+
+protected:
+    virtual void writePayload(QDataStream& stream) const { Q_UNUSED(stream); }
+    virtual void readPayload(QDataStream& stream) { Q_UNUSED(stream); }
+
+    EditorHistory::Action m_action;
+    QList<EditorSprite*> m_sprites;
+
+private:
+    // Taille minimale d'un SpriteRecord écrit dans un flux (chaînes vides) : identifiant, deux chaînes,
+    // position, z-index, rotation, échelle, opacité et sélection
+    static constexpr qint64 MIN_SPRITE_RECORD_SIZE = 8 + 4 + 16 + 4 * 8 + 4 + 1;
+};
+
+//! Commande portant uniquement sur une liste de sprites : ajout, suppression, duplication et sélection.
+//! L'annulation effectue l'action inverse (EditorHistory::inverseAction()).
+class SpriteListCommand : public EditorCommand {
+public:
+    SpriteListCommand(EditorHistory::Action action, QList<EditorSprite*> sprites);
+
+    void undo(EditorManager* pEditorManager) override;
+    void redo(EditorManager* pEditorManager) override;
+
+    qint64 memoryCost() const override;
+
+private:
+    void perform(EditorManager* pEditorManager, EditorHistory::Action action);
+
+    qint64 m_spritesMemoryCost = 0; // Mémoire des sprites que la commande peut garder en vie
+};
+
+//! Commande de déplacement : conserve la position de chaque sprite avant et après le déplacement.
+class MoveSpritesCommand : public EditorCommand {
+public:
+    MoveSpritesCommand(QList<EditorSprite*> sprites, QVector<QPointF> positionsBefore, QVector<QPointF> positionsAfter);
+
+    void undo(EditorManager* pEditorManager) override;
+    void redo(EditorManager* pEditorManager) override;
+
+    bool mergeWith(const EditorCommand* pOther) override;
+
+    qint64 memoryCost() const override;
+
+protected:
+    void writePayload(QDataStream& stream) const override;
+    void readPayload(QDataStream& stream) override;
+
+private:
+    void apply(EditorManager* pEditorManager, const QVector<QPointF>& positions);
+
+    QVector<QPointF> m_positionsBefore;
+    QVector<QPointF> m_positionsAfter;
+};
+
+//! Commande de modification d'une valeur des sprites : z-index, rotation, échelle ou opacité,
+//! selon l'action. Conserve la valeur de chaque sprite avant et après la modification.
+class SpriteValueCommand : public EditorCommand {
+public:
+    SpriteValueCommand(EditorHistory::Action action, QList<EditorSprite*> sprites, QVector<qreal> valuesBefore, QVector<qreal> valuesAfter);
+
+    void undo(EditorManager* pEditorManager) override;
+    void redo(EditorManager* pEditorManager) override;
+
+    bool mergeWith(const EditorCommand* pOther) override;
+
+    qint64 memoryCost() const override;
+
+protected:
+    void writePayload(QDataStream& stream) const override;
+    void readPayload(QDataStream& stream) override;
+
+private:
+    void apply(EditorManager* pEditorManager, const QVector<qreal>& values);
+
+    QVector<qreal> m_valuesBefore;
+    QVector<qreal> m_valuesAfter;
+};
+
+//! Commande d'ajout ou de suppression de l'image de fond.
+class BackgroundCommand : public EditorCommand {
+public:
+    BackgroundCommand(EditorHistory::Action action, QString imagePath);
+
+    void undo(EditorManager* pEditorManager) override;
+    void redo(EditorManager* pEditorManager) override;
+
+    qint64 memoryCost() const override;
+
+protected:
+    void writePayload(QDataStream& stream) const override;
+    void readPayload(QDataStream& stream) override;
+
+private:
+    void perform(EditorManager* pEditorManager, EditorHistory::Action action);
+
+    QString m_imagePath;
+};
+
+#endif //WORLDBUILDR_EDITORCOMMAND_H
@@ -7,26 +7,34 @@
 
 #include "EditorHistory.h"
 
+#include <iterator>
 #include <utility>
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QTimer>
+#include "EditorCommand.h"
+#include "EditorJournal.h"
 #include "EditorManager.h"
 #include "EditorSprite.h"
+#include "tracing.h"
 
 EditorHistory::EditorHistory(EditorManager *editorManager) {
     m_pEditorManager = editorManager;
+    m_pJournal = new EditorJournal(this);
+
+    m_journalAmendTimer.setSingleShot(true);
+    m_journalAmendTimer.setInterval(COALESCING_WINDOW);
+    connect(&m_journalAmendTimer, &QTimer::timeout, this, &EditorHistory::flushJournalAmend);
 }
 
 EditorHistory::~EditorHistory() {
+    // L'éditeur est en cours de destruction : on ne signale plus rien, et le journal est conservé tel quel
+    blockSignals(true);
+    detachJournal();
     clearHistory();
 }
 
-//! Ajoute une action simple à l'historique
-//! \param action L'action effectuée
-//! \param additionalData Les données supplémentaires
-void EditorHistory::addAction(EditorHistory::Action action, QString additionalData) {
-    QList<EditorSprite*> sprites;
-    addSpriteAction(action, sprites, std::move(additionalData));
-}
-
 //! Ajoute un état à l'historique qui contient une seule sprite
 //! \param action L'action effectuée
 //! \param sprite La sprite concernée
@@ -40,248 +48,825 @@ void EditorHistory::addSpriteAction(EditorHistory::Action action, EditorSprite*
 //! \param action L'action effectuée
 //! \param sprites Les sprites concernées
 void EditorHistory::addSpriteAction(EditorHistory::Action action, QList<EditorSprite*> sprites) {
-    addSpriteAction(action, std::move(sprites), "");
+    if (m_transactionDepth > 0) { // Pendant une transaction, on ne fait rien
+        return;
+    }
+
+    addCommand(new SpriteListCommand(action, std::move(sprites)));
 }
 
-//! Ajoute un état à l'historique concernant un seul sprite avec des données supplémentaires
-//! \param action L'action effectuée
-//! \param sprite La sprite concernée
-//! \param additionalData Les données supplémentaires
-void EditorHistory::addSpriteAction(EditorHistory::Action action, EditorSprite *sprite, QString additionalData) {
-    QList<EditorSprite*> sprites;
-    sprites.append(sprite);
-    addSpriteAction(action, sprites, std::move(additionalData));
+//! Ajoute un déplacement à l'historique
+//! \param sprites Les sprites déplacées
+//! \param positionsBefore La position de chaque sprite avant le déplacement
+//! \param positionsAfter La position de chaque sprite après le déplacement
+void EditorHistory::addMoveAction(QList<EditorSprite*> sprites, QVector<QPointF> positionsBefore, QVector<QPointF> positionsAfter) {
+    if (m_transactionDepth > 0) { // Pendant une transaction, on ne fait rien
+        return;
+    }
+
+    addCommand(new MoveSpritesCommand(std::move(sprites), std::move(positionsBefore), std::move(positionsAfter)));
 }
 
-//! Ajoute un état à l'historique avec des données supplémentaires
-//! \param action L'action effectuée
-//! \param sprites Les sprites concernées
-//! \param additionalData Les données supplémentaires
-void EditorHistory::addSpriteAction(EditorHistory::Action action, QList<EditorSprite *> sprites, QString additionalData) {
-    if (m_paused) { // Si l'historique est en pause, on ne fait rien
+//! Ajoute le déplacement d'une seule sprite à l'historique
+//! \param sprite La sprite déplacée
+//! \param positionBefore La position avant le déplacement
+//! \param positionAfter La position après le déplacement
+void EditorHistory::addMoveAction(EditorSprite* sprite, QPointF positionBefore, QPointF positionAfter) {
+    if (m_transactionDepth > 0) { // Pendant une transaction, on ne fait rien
         return;
     }
 
-    State state;
-    state.action = action;
-    state.sprites = std::move(sprites);
-    state.additionalData = std::move(additionalData);
+    addCommand(new MoveSpritesCommand({sprite}, {positionBefore}, {positionAfter}));
+}
+
+//! Ajoute un changement de valeur à l'historique
+//! \param action ChangeZIndex, RotateSprite, RescaleSprite ou ChangeOpacity
+//! \param sprites Les sprites modifiées
+//! \param valuesBefore La valeur de chaque sprite avant la modification
+//! \param valuesAfter La valeur de chaque sprite après la modification
+void EditorHistory::addValueAction(EditorHistory::Action action, QList<EditorSprite*> sprites, QVector<qreal> valuesBefore, QVector<qreal> valuesAfter) {
+    if (m_transactionDepth > 0) { // Pendant une transaction, on ne fait rien
+        return;
+    }
+
+    addCommand(new SpriteValueCommand(action, std::move(sprites), std::move(valuesBefore), std::move(valuesAfter)));
+}
+
+//! Ajoute le changement de valeur d'une seule sprite à l'historique
+//! \param action ChangeZIndex, RotateSprite, RescaleSprite ou ChangeOpacity
+//! \param sprite La sprite modifiée
+//! \param valueBefore La valeur avant la modification
+//! \param valueAfter La valeur après la modification
+void EditorHistory::addValueAction(EditorHistory::Action action, EditorSprite* sprite, qreal valueBefore, qreal valueAfter) {
+    if (m_transactionDepth > 0) { // Pendant une transaction, on ne fait rien
+        return;
+    }
+
+    addCommand(new SpriteValueCommand(action, {sprite}, {valueBefore}, {valueAfter}));
+}
+
+//! Ajoute l'ajout ou la suppression de l'image de fond à l'historique
+//! \param action AddBackground ou RemoveBackground
+//! \param imagePath Le chemin de l'image ajoutée ou supprimée
+void EditorHistory::addBackgroundAction(EditorHistory::Action action, QString imagePath) {
+    if (m_transactionDepth > 0) { // Pendant une transaction, on ne fait rien
+        return;
+    }
+
+    addCommand(new BackgroundCommand(action, std::move(imagePath)));
+}
+
+//! Ajoute une commande à l'historique. L'historique en prend la propriété
+//! \param command La commande à ajouter
+void EditorHistory::addCommand(EditorCommand* command) {
+    // On regroupe la commande avec la précédente si possible
+    if (m_canCoalesce && m_currentCommandIndex >= 0 && m_currentCommandIndex == m_commands.size() - 1
+        && m_lastCommandTimer.elapsed() < COALESCING_WINDOW) {
+        EditorCommand* lastCommand = m_commands.last();
+        qint64 lastCommandCost = lastCommand->memoryCost();
+        if (lastCommand->mergeWith(command)) {
+            m_residentMemory += lastCommand->memoryCost() - lastCommandCost;
+            delete command;
+            m_lastCommandTimer.restart();
+
+            // L'action n'est réécrite dans le journal qu'à la fin du regroupement : la sérialiser à chaque
+            // action absorbée coûterait une représentation compacte par sprite, à chaque déplacement
+            if (m_pJournal->isOpen()) {
+                m_pendingJournalAmend = m_currentCommandIndex;
+                m_journalAmendTimer.start();
+            }
+
+            // Le point de restauration de l'état courant n'est plus à jour
+            removeCheckpointsFrom(m_firstCommandNumber + m_currentCommandIndex);
+            scheduleCheckpoint();
+            return;
+        }
+    }
+
+    // L'action regroupée précédente est réécrite dans le journal avant que la liste des actions change
+    flushJournalAmend();
 
-    if (m_currentStateIndex < m_states.size() - 1) { // Si CTRL+Z -> Action
+    if (m_currentCommandIndex < m_commands.size() - 1) { // Si CTRL+Z -> Action
         // On supprime les états après l'état ajouté
-        deleteActionsFrom(m_currentStateIndex + 1);
+        deleteActionsFrom(m_currentCommandIndex + 1);
     }
 
-    // On ajoute l'état
-    m_states.append(state);
+    // On ajoute l'état et on compte les références à ses sprites
+    m_commands.append(command);
+    m_spillOffsets.append(-1);
+    retainSprites(command);
+    m_residentMemory += command->memoryCost();
 
     // On supprime les états en trop
-    if (m_states.size() > MAX_HISTORY_SIZE) {
-        // On supprime les états en trop
-        deleteActionsTo(m_states.size() - MAX_HISTORY_SIZE);
+    if (m_commands.size() > MAX_HISTORY_SIZE) {
+        deleteActionsTo(m_commands.size() - MAX_HISTORY_SIZE - 1);
     }
 
     // On met à jour l'index de l'état courant
-    m_currentStateIndex = m_states.size()-1;
+    m_currentCommandIndex = m_commands.size()-1;
+
+    if (m_pJournal->isOpen()) {
+        m_pJournal->appendCommand(m_currentCommandIndex, serializeCommand(command));
+    }
+
+    // La prochaine commande pourra être regroupée avec celle-ci
+    m_canCoalesce = true;
+    m_lastCommandTimer.restart();
+
+    // On écrit les états les plus anciens sur le disque si le budget mémoire est dépassé
+    spillOldCommands();
+
+    notifyHistoryChanged();
 }
 
-//! Mettre en pause l'historique pour qu'il n'accepte plus d'état
-//! Un niveau de pause est associé à chaque pause
-//! \param level Le niveau de pause
-void EditorHistory::pauseHistory(int level) {
-    if (level > MAX_PAUSE_LEVEL) {
-        level = MAX_PAUSE_LEVEL;
+//! Ajoute une référence à chaque sprite de la commande
+//! \param command La commande
+void EditorHistory::retainSprites(const EditorCommand* command) {
+    for (EditorSprite* sprite : command->sprites()) {
+        if (m_spriteReferenceCounts[sprite]++ == 0) {
+            m_heldSpritesById.insert(sprite->getId(), sprite);
+        }
     }
-    m_paused = true;
+}
 
-    if (level > m_pauseLevel) {
-        m_pauseLevel = level;
+//! Retire une référence à chaque sprite de la commande
+//! Les sprites qui ne sont plus référencés ni par l'éditeur ni par l'historique sont supprimés
+//! \param command La commande
+void EditorHistory::releaseSprites(const EditorCommand* command) {
+    for (EditorSprite* currentSprite : command->sprites()) {
+        auto referenceCountIt = m_spriteReferenceCounts.find(currentSprite);
+        if (referenceCountIt == m_spriteReferenceCounts.end() || --referenceCountIt.value() > 0) {
+            // Le sprite est encore référencé par une autre action de l'historique
+            continue;
+        }
+        m_spriteReferenceCounts.erase(referenceCountIt);
+        m_heldSpritesById.remove(currentSprite->getId());
+
+        if (!m_pEditorManager->containsEditorSprite(currentSprite)) { // Si le sprite n'est référencé ni dans l'éditeur, ni dans l'historique
+            delete currentSprite;
+        }
     }
 }
 
-//! Réactiver l'historique pour qu'il accepte à nouveau des états
-//! Ne réactive l'historique que si le niveau de pause est inférieur ou égal au niveau passé en paramètre
-//! \param level Le niveau de pause à réactiver
-void EditorHistory::requestResumeHistory(int level) {
-    if (level >= m_pauseLevel) {
-        m_pauseLevel = 1;
-        m_paused = false;
+//! Associe l'historique à un journal. Le journal est réécrit à partir de l'historique courant,
+//! puis chaque modification de l'historique y est ajoutée
+//! \param journalFilePath Le chemin du journal
+void EditorHistory::attachJournal(const QString& journalFilePath) {
+    TRACE_SCOPE("EditorHistory::attachJournal");
+
+    QList<QByteArray> commands;
+    commands.reserve(m_commands.size());
+    for (int i = 0; i < m_commands.size(); i++) {
+        commands.append(commandData(i));
     }
+
+    m_pJournal->open(journalFilePath, commands, m_currentCommandIndex);
+    m_pendingJournalAmend = -1; // Le journal vient d'être réécrit à partir des actions courantes
 }
 
-//! Supprime les sprites non référencés dans l'historique autre que dans l'état passé en paramètre
-//! \param stateIndex L'index de l'état dont on veut supprimer les sprites non référencés
-void EditorHistory::deleteActionAndUnreferencedSprites(int stateIndex) {
-    if (stateIndex < 0 || stateIndex >= m_states.size()) { // Si l'état n'existe pas
+//! Termine l'écriture du journal. Les modifications suivantes de l'historique n'y sont plus ajoutées
+void EditorHistory::detachJournal() {
+    flushJournalAmend();
+    m_pJournal->close();
+}
+
+//! Retourne le chemin du journal associé à l'historique, ou une chaîne vide si aucun
+QString EditorHistory::journalFilePath() const {
+    return m_pJournal->filePath();
+}
+
+//! Indique au journal que le niveau a été sauvegardé dans l'état courant
+//! \param token Le jeton unique écrit dans le niveau
+void EditorHistory::markSaved(const QString& token) {
+    flushJournalAmend();
+    m_pJournal->markSaved(token, EditorSprite::nextId());
+}
+
+//! Remplace l'historique par celui qui correspond, dans un journal, à la sauvegarde du jeton donné
+//! L'éditeur doit contenir le niveau tel qu'il a été sauvegardé : les sprites des actions relues sont retrouvés
+//! grâce à leur identifiant. Les actions sont placées dans le fichier temporaire et chargées à la demande
+//! \param journalFilePath Le chemin du journal
+//! \param token Le jeton lu dans le niveau
+//! \return true si l'historique a été restauré
+bool EditorHistory::restoreFromJournal(const QString& journalFilePath, const QString& token) {
+    TRACE_SCOPE("EditorHistory::restoreFromJournal");
+
+    QList<QByteArray> commands;
+    int cursor = -1;
+    quint64 nextSpriteId = 0;
+    if (!EditorJournal::readSavedState(journalFilePath, token, commands, cursor, nextSpriteId)) {
+        return false;
+    }
+
+    clearHistory();
+
+    // Les sprites créés à partir de maintenant ne doivent pas réutiliser les identifiants des sprites de l'historique
+    EditorSprite::reserveIds(nextSpriteId);
+
+    for (const QByteArray& command : std::as_const(commands)) {
+        qint64 offset = spillCommandData(command);
+        if (offset < 0) {
+            clearHistory();
+            return false;
+        }
+
+        m_commands.append(nullptr);
+        m_spillOffsets.append(offset);
+        m_firstResidentIndex++;
+    }
+    m_currentCommandIndex = cursor;
+
+    notifyHistoryChanged();
+    return true;
+}
+
+//! Modifie le budget mémoire de l'historique
+//! Les états les plus anciens sont immédiatement écrits sur le disque si le nouveau budget est dépassé
+//! \param memoryBudget Le budget, en octets
+void EditorHistory::setMemoryBudget(qint64 memoryBudget) {
+    m_memoryBudget = qMax(memoryBudget, qint64(0));
+    spillOldCommands();
+}
+
+//! Écrit les états les plus anciens dans le fichier temporaire, puis les libère, jusqu'à ce que
+//! la mémoire occupée respecte le budget. Les MIN_RESIDENT_COMMANDS états précédant l'état courant restent en mémoire
+void EditorHistory::spillOldCommands() {
+    if (m_residentMemory <= m_memoryBudget) {
         return;
     }
 
-    // On récupère les spritesToCheckForDelete de l'état
-    auto spritesToCheckForDelete = m_states[stateIndex].sprites;
+    TRACE_SCOPE("EditorHistory::spillOldCommands");
+
+    while (m_residentMemory > m_memoryBudget && m_firstResidentIndex < m_currentCommandIndex - MIN_RESIDENT_COMMANDS) {
+        EditorCommand* command = m_commands[m_firstResidentIndex];
+        qint64 offset = spillCommandData(serializeCommand(command));
+        if (offset < 0) {
+            return;
+        }
 
-    // On supprime l'action de l'historique
-    m_states.removeAt(stateIndex);
+        m_commands[m_firstResidentIndex] = nullptr;
+        m_spillOffsets[m_firstResidentIndex] = offset;
+        m_firstResidentIndex++;
 
-    for (EditorSprite* currentSprite : spritesToCheckForDelete) { // Pour chaque sprite de l'état supprimé
-        bool deleteSprite = true;
-        if (m_pEditorManager->containsEditorSprite(currentSprite)) { // Si le sprite est référencé dans l'éditeur
-            // On ne le supprime pas
-            deleteSprite = false;
-        } else {
-            // On regarde s'il est référencé dans une autre action de l'historique
-            for (const State& state : m_states) { // Pour chaque action de l'historique
-                if (state.sprites.contains(currentSprite)) {
-                    // On le supprime pas
-                    deleteSprite = false;
-                    break;
+        m_residentMemory -= command->memoryCost();
+        releaseSprites(command);
+        delete command;
+    }
+}
+
+//! Ouvre le fichier temporaire dans lequel sont écrits les états les plus anciens, s'il ne l'est pas déjà
+//! \return true si le fichier est ouvert
+bool EditorHistory::openSpillFile() {
+    if (m_spillFile.isOpen()) {
+        return true;
+    }
+
+    m_spillFile.setFileTemplate(QDir::tempPath() + "/worldbuildr_history_XXXXXX.bin");
+    if (!m_spillFile.open()) {
+        qWarning() << "Impossible de créer le fichier temporaire de l'historique";
+        return false;
+    }
+    return true;
+}
+
+//! Ajoute un état sérialisé à la fin du fichier temporaire. Le fichier n'est jamais réécrit
+//! \param commandData L'état sérialisé
+//! \return La position de l'état dans le fichier, ou -1 si l'écriture a échoué
+qint64 EditorHistory::spillCommandData(const QByteArray& commandData) {
+    if (!openSpillFile()) {
+        return -1;
+    }
+
+    qint64 offset = m_spillFile.size();
+    m_spillFile.seek(offset);
+
+    QDataStream stream(&m_spillFile);
+    stream << commandData;
+    if (stream.status() != QDataStream::Ok) {
+        qWarning() << "Impossible d'écrire l'historique dans" << m_spillFile.fileName();
+        return -1;
+    }
+    return offset;
+}
+
+//! Sérialise un état
+//! \param command L'état
+//! \return L'état sérialisé (EditorCommand::write())
+QByteArray EditorHistory::serializeCommand(const EditorCommand* command) {
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_6_0);
+    EditorCommand::write(stream, command);
+    return data;
+}
+
+//! Retourne l'état à l'index donné sous forme sérialisée, qu'il soit en mémoire ou écrit sur le disque
+//! \param index L'index de l'état
+QByteArray EditorHistory::commandData(int index) {
+    if (m_commands[index] != nullptr) {
+        return serializeCommand(m_commands[index]);
+    }
+
+    QByteArray data;
+    if (m_spillFile.seek(m_spillOffsets[index])) {
+        QDataStream stream(&m_spillFile);
+        stream >> data;
+    }
+    return data;
+}
+
+//! Relit depuis le fichier temporaire l'état à l'index donné, ainsi que tous les états suivants écrits sur le disque
+//! Si la lecture échoue, les états écrits sur le disque sont oubliés
+//! \param index L'index de l'état qui doit être en mémoire
+//! \return true si l'état est en mémoire
+bool EditorHistory::ensureResident(int index) {
+    if (index >= m_firstResidentIndex) {
+        return true;
+    }
+
+    TRACE_SCOPE("EditorHistory::ensureResident");
+
+    // Les sprites recréés lors de la relecture, pour ne les recréer qu'une seule fois
+    QHash<quint64, EditorSprite*> recreatedSprites;
+
+    while (m_firstResidentIndex > index) {
+        int spilledIndex = m_firstResidentIndex - 1;
+        EditorCommand* command = reloadCommand(spilledIndex, recreatedSprites);
+
+        if (command == nullptr) {
+            qWarning() << "Impossible de relire l'historique depuis" << m_spillFile.fileName();
+
+            // On supprime les sprites recréés qui ne sont référencés par aucun état
+            for (EditorSprite* sprite : std::as_const(recreatedSprites)) {
+                if (!m_spriteReferenceCounts.contains(sprite)) {
+                    delete sprite;
                 }
             }
+            dropSpilledCommands();
+            return false;
         }
 
-        if (deleteSprite) { // Si le sprite n'est pas référencé dans l'éditeur et dans l'historique
-            delete currentSprite;
+        m_commands[spilledIndex] = command;
+        m_spillOffsets[spilledIndex] = -1;
+        m_firstResidentIndex--;
+
+        retainSprites(command);
+        m_residentMemory += command->memoryCost();
+    }
+
+    return true;
+}
+
+//! Relit un état depuis le fichier temporaire
+//! Chaque sprite de l'état est retrouvé dans l'éditeur ou dans l'historique grâce à son identifiant,
+//! ou recréé à partir de sa représentation compacte s'il n'existe plus
+//! \param index L'index de l'état
+//! \param recreatedSprites Les sprites déjà recréés, complétée par les sprites recréés pour cet état
+//! \return L'état relu, ou nullptr si la lecture a échoué
+EditorCommand* EditorHistory::reloadCommand(int index, QHash<quint64, EditorSprite*>& recreatedSprites) {
+    if (!m_spillFile.isOpen() || !m_spillFile.seek(m_spillOffsets[index])) {
+        return nullptr;
+    }
+
+    QByteArray data;
+    QDataStream fileStream(&m_spillFile);
+    fileStream >> data;
+    if (fileStream.status() != QDataStream::Ok) {
+        return nullptr;
+    }
+
+    QDataStream stream(data);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    return EditorCommand::read(stream, [this, &recreatedSprites](const SpriteRecord& record) {
+        EditorSprite* sprite = m_pEditorManager->editorSpriteById(record.id);
+        if (sprite == nullptr) {
+            sprite = m_heldSpritesById.value(record.id);
+        }
+        if (sprite == nullptr) {
+            sprite = recreatedSprites.value(record.id);
+        }
+        if (sprite == nullptr) {
+            sprite = EditorSprite::fromRecord(record);
+            recreatedSprites.insert(record.id, sprite);
         }
+        return sprite;
+    });
+}
+
+//! Oublie tous les états écrits sur le disque
+void EditorHistory::dropSpilledCommands() {
+    int spilledCommandCount = m_firstResidentIndex;
+    deleteActionsTo(spilledCommandCount - 1);
+    m_currentCommandIndex = qMax(m_currentCommandIndex - spilledCommandCount, -1);
+}
+
+//! Termine le regroupement en cours : la prochaine action sera enregistrée dans une nouvelle entrée
+void EditorHistory::endCoalescing() {
+    m_canCoalesce = false;
+    flushJournalAmend();
+}
+
+//! Réécrit dans le journal l'action qui a absorbé d'autres actions depuis son dernier enregistrement
+void EditorHistory::flushJournalAmend() {
+    m_journalAmendTimer.stop();
+    if (m_pendingJournalAmend < 0) {
+        return;
+    }
+
+    int index = m_pendingJournalAmend;
+    m_pendingJournalAmend = -1;
+    if (m_pJournal->isOpen() && index < m_commands.size()) {
+        m_pJournal->amendCommand(index, commandData(index));
+    }
+}
+
+//! Ouvre une transaction : les actions ne sont plus enregistrées jusqu'à sa destruction
+//! \param pHistory L'historique
+EditorHistory::Transaction::Transaction(EditorHistory* pHistory) {
+    m_pHistory = pHistory;
+    m_isOutermost = m_pHistory->m_transactionDepth == 0;
+    m_pHistory->m_transactionDepth++;
+}
+
+//! Ferme la transaction. Si elle est la plus externe, son action est ajoutée à l'historique
+//! et la modification de l'historique est signalée
+EditorHistory::Transaction::~Transaction() {
+    m_pHistory->m_transactionDepth--;
+
+    if (m_pCommand != nullptr) {
+        m_pHistory->addCommand(m_pCommand);
+    }
+
+    if (m_isOutermost && m_pHistory->m_changedInTransaction) {
+        m_pHistory->notifyHistoryChanged();
     }
 }
 
+//! Indique l'action portant sur des sprites à enregistrer à la fin de la transaction
+//! Ne fait rien si la transaction n'est pas la plus externe
+//! \param action L'action effectuée
+//! \param sprites Les sprites concernées
+void EditorHistory::Transaction::recordSpriteAction(EditorHistory::Action action, QList<EditorSprite*> sprites) {
+    if (!m_isOutermost) {
+        return;
+    }
+
+    delete m_pCommand;
+    m_pCommand = new SpriteListCommand(action, std::move(sprites));
+}
+
+//! Indique le déplacement à enregistrer à la fin de la transaction
+//! Ne fait rien si la transaction n'est pas la plus externe
+//! \param sprites Les sprites déplacées
+//! \param positionsBefore La position de chaque sprite avant le déplacement
+//! \param positionsAfter La position de chaque sprite après le déplacement
+void EditorHistory::Transaction::recordMoveAction(QList<EditorSprite*> sprites, QVector<QPointF> positionsBefore, QVector<QPointF> positionsAfter) {
+    if (!m_isOutermost) {
+        return;
+    }
+
+    delete m_pCommand;
+    m_pCommand = new MoveSpritesCommand(std::move(sprites), std::move(positionsBefore), std::move(positionsAfter));
+}
+
+//! Supprime l'état à l'index donné, ainsi que les sprites qui ne sont plus référencés ni par l'éditeur ni par l'historique
+//! \param stateIndex L'index de l'état à supprimer
+void EditorHistory::deleteActionAndUnreferencedSprites(int stateIndex) {
+    if (stateIndex < 0 || stateIndex >= m_commands.size()) { // Si l'état n'existe pas
+        return;
+    }
+
+    // On retire la commande de l'historique
+    EditorCommand* command = m_commands.takeAt(stateIndex);
+    m_spillOffsets.removeAt(stateIndex);
+
+    if (command == nullptr) { // L'état est écrit sur le disque : ses sprites ont déjà été libérés
+        m_firstResidentIndex--;
+        return;
+    }
+
+    m_residentMemory -= command->memoryCost();
+    releaseSprites(command);
+    delete command;
+}
+
 //! Supprime les états suivants l'état à l'index donné (Incluant cet état)
 //! \param index L'index de l'état à partir duquel on supprime
 void EditorHistory::deleteActionsFrom(int index) {
-    for (int i = index; i < m_states.size(); i++) {
-        deleteAction(i);
+    for (int i = m_commands.size() - 1; i >= index; i--) {
+        deleteActionAndUnreferencedSprites(i);
     }
+
+    // Les états qui suivaient ces actions ne peuvent plus être atteints
+    removeCheckpointsFrom(m_firstCommandNumber + index);
 }
 
 //! Supprime les états précédents l'état à l'index donné (Incluant cet état)
 //! \param index L'index de l'état à jusqu'auquel on supprime
 void EditorHistory::deleteActionsTo(int index) {
+    if (index < 0) {
+        return;
+    }
+
+    // Les index du journal sont décalés : l'action regroupée en attente y est réécrite avant
+    flushJournalAmend();
+
     for (int i = index; i >= 0; i--) {
-        deleteAction(i);
+        deleteActionAndUnreferencedSprites(i);
+    }
+    m_firstCommandNumber += index + 1;
+    m_pJournal->evictCommands(index + 1);
+
+    // Seul l'état précédant la première action restante peut encore être atteint
+    while (!m_checkpoints.isEmpty() && m_checkpoints.firstKey() < m_firstCommandNumber - 1) {
+        m_checkpointMemory -= m_checkpoints.first().spriteRecords.size();
+        m_checkpoints.erase(m_checkpoints.begin());
     }
 }
 
 //! Supprime tout l'historique
 void EditorHistory::clearHistory() {
+    // Le journal est vidé : l'action regroupée en attente n'a pas à y être réécrite
+    m_pendingJournalAmend = -1;
+    m_journalAmendTimer.stop();
+
     // Supprime tout l'historique
-    deleteActionsTo(m_states.size()-1);
-    m_currentStateIndex = -1;
+    deleteActionsTo(m_commands.size()-1);
+    m_currentCommandIndex = -1;
+    m_canCoalesce = false;
+
+    // Les états écrits sur le disque ne sont plus nécessaires
+    if (m_spillFile.isOpen()) {
+        m_spillFile.resize(0);
+    }
+
+    m_checkpoints.clear();
+    m_checkpointMemory = 0;
+    m_firstCommandNumber = 0;
+
+    m_pJournal->clearCommands();
+
+    notifyHistoryChanged();
 }
 
 //! Annule la dernière action effectuée
 void EditorHistory::undo() {
-    if (m_currentStateIndex > 0) {
-        State state = m_states[m_currentStateIndex];
+    TRACE_SCOPE("EditorHistory::undo");
 
-        // On effectue l'action inverse
-        performAction(state, true);
+    endCoalescing();
 
-        // On décrémente l'index de l'état courant
-        m_currentStateIndex--;
+    if (m_currentCommandIndex >= 0) {
+        // Les actions effectuées par la commande ne sont pas enregistrées
+        Transaction transaction(this);
+        stepTo(m_currentCommandIndex - 1);
+
+        notifyHistoryChanged();
     }
 }
 
 //! Rétablit la dernière action annulée
 void EditorHistory::redo() {
-    if (m_currentStateIndex < m_states.size()-1) {
-        m_currentStateIndex++;
-        State state = m_states[m_currentStateIndex];
+    TRACE_SCOPE("EditorHistory::redo");
+
+    endCoalescing();
 
-        // On effectue l'action inverse
-        performAction(state);
+    if (m_currentCommandIndex < m_commands.size()-1) {
+        // Les actions effectuées par la commande ne sont pas enregistrées
+        Transaction transaction(this);
+        stepTo(m_currentCommandIndex + 1);
+
+        notifyHistoryChanged();
     }
 }
 
-//! Effectue l'action de l'état passé en paramètre
-//! \param state L'état dont on veut effectuer l'action
-void EditorHistory::performAction(EditorHistory::State &state, bool inverse) {
-    // On met en pause l'historique
-    pauseHistory(MAX_PAUSE_LEVEL);
+//! Atteint directement l'état qui suit l'action à l'index donné (-1 pour l'état précédant toutes les actions)
+//! Si un point de restauration est plus proche de cet état que l'état courant, il est restauré,
+//! puis seules les actions qui l'en séparent sont annulées ou rétablies
+//! \param index L'index de l'action
+void EditorHistory::jumpTo(int index) {
+    index = qBound(-1, index, m_commands.size() - 1);
+    if (index == m_currentCommandIndex) {
+        return;
+    }
+
+    TRACE_SCOPE("EditorHistory::jumpTo");
 
-    if (inverse) { // Si on veut effectuer l'action inverse
-        // On inverse l'action
-        state.action = inverseAction(state.action);
+    endCoalescing();
+
+    // On cherche le point de restauration le plus proche de l'état demandé, juste avant ou juste après celui-ci
+    qint64 targetNumber = m_firstCommandNumber + index;
+    const QMap<qint64, Checkpoint>& checkpoints = m_checkpoints;
+    auto bestCheckpoint = checkpoints.constEnd();
+    qint64 bestStepCount = qAbs(index - m_currentCommandIndex) - MIN_STEPS_SAVED_BY_CHECKPOINT;
+
+    auto nextCheckpoint = checkpoints.lowerBound(targetNumber);
+    if (nextCheckpoint != checkpoints.constEnd() && nextCheckpoint.key() - targetNumber < bestStepCount) {
+        bestCheckpoint = nextCheckpoint;
+        bestStepCount = nextCheckpoint.key() - targetNumber;
+    }
+    if (nextCheckpoint != checkpoints.constBegin()) {
+        auto previousCheckpoint = std::prev(nextCheckpoint);
+        if (targetNumber - previousCheckpoint.key() < bestStepCount) {
+            bestCheckpoint = previousCheckpoint;
+        }
     }
 
-    switch (state.action) {
-        case AddSprite:
-        case DuplicateSprite: // On fait la même chose pour les deux actions
-            for (EditorSprite* sprite : state.sprites) {
-                m_pEditorManager->addEditorSprite(sprite);
-            }
-            break;
-        case RemoveSprite:
-            for (EditorSprite* sprite : state.sprites) {
-                m_pEditorManager->deleteEditorSprite(sprite);
-            }
-            break;
-        case MoveSprite:
-            for (EditorSprite* sprite : state.sprites) {
-                // On récupère le vecteur de déplacement depuis les données additionnelles
-                QList<QString> data = state.additionalData.split(";");
-                QPointF moveVector(data[0].toDouble(), data[1].toDouble());
-                // Si on veut effectuer l'action inverse, on inverse le vecteur de déplacement
-                m_pEditorManager->moveEditorSprite(sprite, (inverse) ? -moveVector : moveVector);
-            }
-            break;
-        case ChangeZIndex:
-            for (EditorSprite* sprite : state.sprites) {
-                // On récupère le nouveau z-index depuis les données additionnelles
-                int newZIndex = state.additionalData.toInt() * (inverse ? -1 : 1) + sprite->zValue();
-                // Si on veut effectuer l'action inverse, on inverse le z-index
-                m_pEditorManager->setEditorSpriteZIndex(sprite, newZIndex);
-            }
-            break;
-        case RotateSprite:
-            for (EditorSprite* sprite : state.sprites) {
-                // On récupère l'angle de rotation depuis les données additionnelles
-                qreal newAngle = state.additionalData.toDouble() * (inverse ? -1 : 1) + sprite->rotation();
-                // Si on veut effectuer l'action inverse, on inverse l'angle de rotation
-                m_pEditorManager->setEditorSpriteRotation(sprite, newAngle);
-            }
-            break;
-        case RescaleSprite:
-            for (EditorSprite* sprite : state.sprites) {
-                // On récupère le facteur d'échelle depuis les données additionnelles
-                qreal scale = state.additionalData.toDouble();
-                // Si on veut effectuer l'action inverse, on inverse le facteur d'échelle
-                double newScale = state.additionalData.toDouble() * ((inverse) ? -1 : 1) + sprite->scale();
-                m_pEditorManager->rescaleEditorSprite(sprite, newScale);
-            }
-            break;
-        case ChangeOpacity:
-            for (EditorSprite* sprite : state.sprites) {
-                // On récupère le nouveau niveau d'opacité depuis les données additionnelles
-                qreal newOpacity = state.additionalData.toDouble() * (inverse ? -1 : 1) + sprite->opacity();
-                // Si on veut effectuer l'action inverse, on inverse le niveau d'opacité
-                 m_pEditorManager->setEditorSpriteOpacity(sprite, newOpacity);
+    // Les actions effectuées ne sont pas enregistrées
+    Transaction transaction(this);
+
+    if (bestCheckpoint != checkpoints.constEnd()) {
+        int checkpointIndex = static_cast<int>(bestCheckpoint.key() - m_firstCommandNumber);
+        restoreCheckpoint(bestCheckpoint.value());
+        m_currentCommandIndex = checkpointIndex;
+    }
+    stepTo(index);
+
+    notifyHistoryChanged();
+}
+
+//! Annule ou rétablit les actions une à une jusqu'à atteindre l'état qui suit l'action à l'index donné
+//! Doit être appelée pendant une transaction
+//! \param index L'index de l'action
+//! \return false si une action n'a pas pu être relue depuis le disque
+bool EditorHistory::stepTo(int index) {
+    while (m_currentCommandIndex > index) {
+        if (!ensureResident(m_currentCommandIndex)) {
+            return false;
+        }
+        m_commands[m_currentCommandIndex]->undo(m_pEditorManager);
+        m_currentCommandIndex--;
+    }
+
+    while (m_currentCommandIndex < index) {
+        if (!ensureResident(m_currentCommandIndex + 1)) {
+            return false;
+        }
+        m_currentCommandIndex++;
+        m_commands[m_currentCommandIndex]->redo(m_pEditorManager);
+    }
+
+    return true;
+}
+
+//! Planifie la capture d'un point de restauration si l'état courant en nécessite un
+//! La capture est différée au retour dans la boucle d'événements, lorsque l'action en cours est entièrement effectuée
+void EditorHistory::scheduleCheckpoint() {
+    if (m_checkpointScheduled || m_currentCommandIndex < 0) {
+        return;
+    }
+
+    qint64 commandNumber = m_firstCommandNumber + m_currentCommandIndex;
+    if ((commandNumber + 1) % CHECKPOINT_INTERVAL != 0 || m_checkpoints.contains(commandNumber)) {
+        return;
+    }
+
+    m_checkpointScheduled = true;
+    QTimer::singleShot(0, this, &EditorHistory::captureCheckpoint);
+}
+
+//! Mémorise l'état courant de l'éditeur comme point de restauration
+void EditorHistory::captureCheckpoint() {
+    m_checkpointScheduled = false;
+
+    if (m_transactionDepth > 0 || m_currentCommandIndex < 0) {
+        return;
+    }
+
+    qint64 commandNumber = m_firstCommandNumber + m_currentCommandIndex;
+    if ((commandNumber + 1) % CHECKPOINT_INTERVAL != 0 || m_checkpoints.contains(commandNumber)) {
+        return;
+    }
+
+    TRACE_SCOPE("EditorHistory::captureCheckpoint");
+
+    Checkpoint checkpoint;
+    QDataStream stream(&checkpoint.spriteRecords, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    const QList<EditorSprite*> editorSprites = m_pEditorManager->getEditorSprites();
+    stream << static_cast<quint32>(editorSprites.size());
+    for (const EditorSprite* sprite : editorSprites) {
+        stream << sprite->toRecord();
+    }
+    checkpoint.backgroundImagePath = m_pEditorManager->getBackgroundImagePath();
+
+    m_checkpoints.insert(commandNumber, checkpoint);
+    m_checkpointMemory += checkpoint.spriteRecords.size();
+
+    // On oublie les points de restauration les plus anciens si ceux-ci occupent trop de mémoire
+    while (m_checkpointMemory > m_memoryBudget / 4 && m_checkpoints.firstKey() != commandNumber) {
+        m_checkpointMemory -= m_checkpoints.first().spriteRecords.size();
+        m_checkpoints.erase(m_checkpoints.begin());
+    }
+}
+
+//! Remet l'éditeur dans l'état mémorisé par un point de restauration
+//! Les sprites sont retrouvés dans l'éditeur ou dans l'historique grâce à leur identifiant, ou recréés.
+//! Doit être appelée pendant une transaction
+//! \param checkpoint Le point de restauration
+void EditorHistory::restoreCheckpoint(const Checkpoint& checkpoint) {
+    TRACE_SCOPE("EditorHistory::restoreCheckpoint");
+
+    QDataStream stream(checkpoint.spriteRecords);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    quint32 spriteCount = 0;
+    stream >> spriteCount;
+    QVector<SpriteRecord> records(spriteCount);
+    QHash<quint64, int> recordIndexById;
+    recordIndexById.reserve(spriteCount);
+    for (quint32 i = 0; i < spriteCount; i++) {
+        stream >> records[i];
+        recordIndexById.insert(records[i].id, i);
+    }
+
+    // On retire de l'éditeur les sprites absents du point de restauration
+    QList<EditorSprite*> removedSprites;
+    const QList<EditorSprite*> editorSprites = m_pEditorManager->getEditorSprites();
+    for (EditorSprite* sprite : editorSprites) {
+        if (!recordIndexById.contains(sprite->getId())) {
+            m_pEditorManager->deleteEditorSprite(sprite);
+            removedSprites.append(sprite);
+        }
+    }
+
+    // On ajoute les sprites manquants et on rétablit l'état de chaque sprite
+    // La sélection est rétablie en une seule fois, à la fin
+    QList<EditorSprite*> selectedSprites;
+    QList<EditorSprite*> unselectedSprites;
+    for (const SpriteRecord& record : std::as_const(records)) {
+        EditorSprite* sprite = m_pEditorManager->editorSpriteById(record.id);
+        if (sprite == nullptr) {
+            sprite = m_heldSpritesById.value(record.id);
+            if (sprite == nullptr) {
+                sprite = EditorSprite::fromRecord(record);
             }
-            break;
-        case AddBackground:
-            m_pEditorManager->setBackGroundImage(state.additionalData);
-            break;
-        case RemoveBackground:
+            m_pEditorManager->addEditorSprite(sprite);
+        }
+
+        if (sprite->pos() != record.pos) {
+            m_pEditorManager->setEditorSpritePos(sprite, record.pos);
+        }
+        if (sprite->zValue() != record.zValue) {
+            m_pEditorManager->setEditorSpriteZIndex(sprite, static_cast<int>(record.zValue));
+        }
+        if (sprite->rotation() != record.rotation) {
+            m_pEditorManager->setEditorSpriteRotation(sprite, record.rotation);
+        }
+        if (sprite->scale() != record.scale) {
+            m_pEditorManager->rescaleEditorSprite(sprite, record.scale);
+        }
+        if (sprite->opacity() != record.opacity) {
+            m_pEditorManager->setEditorSpriteOpacity(sprite, record.opacity);
+        }
+        if (record.selected) {
+            selectedSprites.append(sprite);
+        } else {
+            unselectedSprites.append(sprite);
+        }
+    }
+    m_pEditorManager->unselectMultipleEditorSprites(unselectedSprites);
+    m_pEditorManager->selectMultipleEditorSprites(selectedSprites);
+
+    // Les sprites retirés qui ne sont référencés par aucune action ne seront plus jamais utilisés
+    for (EditorSprite* sprite : std::as_const(removedSprites)) {
+        if (!m_spriteReferenceCounts.contains(sprite)) {
+            delete sprite;
+        }
+    }
+
+    // Image de fond
+    if (checkpoint.backgroundImagePath != m_pEditorManager->getBackgroundImagePath()) {
+        if (checkpoint.backgroundImagePath.isEmpty()) {
             m_pEditorManager->removeBackGroundImage();
-            break;
-        case SelectAll:
-            m_pEditorManager->selectAllEditorSprites();
-            break;
-        case DeselectAll:
-            m_pEditorManager->unselectAllEditorSprites();
-            break;
-        case SelectSprite:
-            for (EditorSprite* sprite : state.sprites) {
-                m_pEditorManager->selectEditorSprite(sprite);
-            }
-            break;
-        case DeselectSprite:
-            for (EditorSprite* sprite : state.sprites) {
-                m_pEditorManager->unselectEditorSprite(sprite);
-            }
-            break;
+        } else {
+            m_pEditorManager->setBackGroundImage(checkpoint.backgroundImagePath);
+        }
+    }
+}
+
+//! Oublie les points de restauration des actions à partir du numéro donné (inclus)
+//! \param commandNumber Le numéro de la première action concernée
+void EditorHistory::removeCheckpointsFrom(qint64 commandNumber) {
+    auto checkpointIt = m_checkpoints.lowerBound(commandNumber);
+    while (checkpointIt != m_checkpoints.end()) {
+        m_checkpointMemory -= checkpointIt.value().spriteRecords.size();
+        checkpointIt = m_checkpoints.erase(checkpointIt);
+    }
+}
+
+//! Signale la modification de l'historique ou de l'état courant
+void EditorHistory::notifyHistoryChanged() {
+    if (m_transactionDepth > 0) { // Le signal sera émis à la fin de la transaction
+        m_changedInTransaction = true;
+        return;
     }
+    m_changedInTransaction = false;
 
-    // On réactive l'historique
-    requestResumeHistory(MAX_PAUSE_LEVEL);
+    m_pJournal->setCursor(m_currentCommandIndex);
+    scheduleCheckpoint();
+    emit historyChanged(m_currentCommandIndex, m_commands.size());
 }
 
 //! Retourne l'action inverse de l'action passée en paramètre
@@ -8,41 +8,87 @@
 #ifndef WORLDBUILDR_EDITORHISTORY_H
 #define WORLDBUILDR_EDITORHISTORY_H
 
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
 #include <QList>
-
+#include <QMap>
+#include <QObject>
+#include <QPointF>
+#include <QString>
+#include <QTemporaryFile>
+#include <QTimer>
+#include <QVector>
+
+class EditorCommand;
+class EditorJournal;
 class EditorManager;
 class EditorSprite;
+struct SpriteRecord;
 
 //! Classe permettant de gérer l'historique des actions de l'éditeur
 //! Cette classe peut être utilisée pour annuler et rétablir des actions d'un éditeur
 //!
-//! Pour utiliser cette classe, il faut passer les actions de l'éditeur à la méthode addSpriteAction()
-//! Cette méthode permet de sauvegarder l'action effectuée, ainsi que les données nécessaires à son annulation et rétablissement
-//! Ces données sont : l'action effectué, les sprites concernés par l'action, ainsi que des données supplémentaires en format QString
-//! Il est possible d'omettre les 2 paramètres derniers, mais il ne faut faire cela que si l'action ne nécessite pas de données supplémentaires
-//! Par exemple, l'action AddBackground ne nécessite pas de sprite, et l'action SelectAll ne nécessite pas de données supplémentaires
-//! Lorsque aucun sprite n'est passé en paramètre, la méthode addAction() peut être utilisée pour simplifier l'appel
+//! Chaque action est enregistrée sous la forme d'une commande typée (EditorCommand), qui conserve les données
+//! nécessaires à son annulation et à son rétablissement sans les formater en texte :
+//! La méthode addSpriteAction() enregistre une action portant uniquement sur des sprites (ajout, suppression, sélection...)
+//! La méthode addMoveAction() enregistre un déplacement, avec la position de chaque sprite avant et après
+//! La méthode addValueAction() enregistre un changement de z-index, de rotation, d'échelle ou d'opacité, avec la valeur
+//! de chaque sprite avant et après
+//! La méthode addBackgroundAction() enregistre l'ajout ou la suppression de l'image de fond
+//!
+//! Pendant une transaction, les actions sont ignorées. Les appelants peuvent tester isRecording() avant
+//! de rassembler des données coûteuses à préparer
 //!
 //! Pour annuler une action, il faut appeler la méthode undo()
 //! Pour rétablir une action précédemment annulé, il faut appeler la méthode redo()
 //! Pour vider l'historique, il faut appeler la méthode clearHistory()
 //! Ceci est utile lorsque on initialise un nouveau projet, ou lorsque l'on ouvre un projet existant
 //!
-//! Il est parfois nécessaire de mettre en pause l'historique, notamment lorsqu'on effectue une action s'appliquant à plusieurs sprites
-//! Dans ce cas, on ne veut pas sauvegarder une action par sprite, mais une seule action pour tous les sprites concernés
-//! Pour cela, on appelle la méthode pauseHistory() avant d'effectuer l'action, et la méthode requestResumeHistory() après l'action
-//! Si on fait face à plus de 1 niveau de pause, on peut utiliser la méthode pauseHistory(int level) et requestResumeHistory(int level)
-//! Le niveau de pause permet de mettre un pause l'historique à un niveau donné. Pour le réactiver, un niveau de pause égal ou supérieur est nécessaire
-//! La méthode pauseHistory(int level = 1) permet de mettre en pause l'historique
-//! La méthode requestResumeHistory(int level = 1) permet de demander la reprise de l'historique
+//! Lorsqu'on effectue une action s'appliquant à plusieurs sprites, on ne veut pas sauvegarder une action par sprite,
+//! mais une seule action pour tous les sprites concernés. Pour cela, on ouvre une transaction (EditorHistory::Transaction) :
+//! tant qu'elle existe, les actions effectuées ne sont pas enregistrées. L'action à enregistrer est donnée à la transaction
+//! (Transaction::recordSpriteAction(), Transaction::recordMoveAction()), qui l'ajoute à l'historique lorsqu'elle est détruite
+//! Les transactions peuvent être imbriquées : seule la transaction la plus externe enregistre son action,
+//! et l'action d'une transaction imbriquée n'est même pas créée (Transaction::isRecording())
+//! Le signal historyChanged() n'est émis qu'une fois, à la fin de la transaction la plus externe
+//!
+//! Les actions successives et compatibles (déplacement, rotation, échelle, opacité ou z-index des mêmes sprites)
+//! sont regroupées en une seule entrée si elles surviennent à moins de COALESCING_WINDOW millisecondes l'une de l'autre.
+//! La méthode endCoalescing() termine le regroupement en cours, par exemple à la fin d'un geste de l'utilisateur
+//! Une action qui en absorbe d'autres n'est réécrite dans le journal qu'une fois le regroupement terminé
+//! (endCoalescing(), ou COALESCING_WINDOW millisecondes sans nouvelle action), et non à chaque action absorbée
 //!
 //! L'historique sauvegarde les actions dans une liste. Cette liste est limitée à MAX_HISTORY_SIZE actions
+//! La mémoire occupée par les actions est limitée par un budget (setMemoryBudget(), DEFAULT_MEMORY_BUDGET par défaut) :
+//! lorsqu'il est dépassé, les actions les plus anciennes sont écrites dans un fichier temporaire, puis libérées.
+//! Leurs sprites y sont écrits sous forme compacte (SpriteRecord). Une action écrite sur le disque est relue
+//! lorsque undo() l'atteint, et les sprites qui n'existent plus sont alors recréés à partir de leur représentation compacte
+//! Les MIN_RESIDENT_COMMANDS dernières actions restent toujours en mémoire
+//!
+//! Toutes les CHECKPOINT_INTERVAL actions, l'historique mémorise un point de restauration : une copie compacte de l'état
+//! de l'éditeur (sprites et image de fond). La méthode jumpTo() permet d'atteindre directement n'importe quel état :
+//! elle restaure le point de restauration le plus proche, puis annule ou rétablit les quelques actions restantes.
+//! Les points de restauration occupent au plus un quart du budget mémoire ; les plus anciens sont oubliés au-delà
+//! Le signal historyChanged() est émis à chaque modification de l'historique ou de l'état courant
+//!
+//! L'historique peut être conservé d'une session à l'autre dans un journal (EditorJournal) écrit à côté du niveau :
+//! La méthode attachJournal() associe l'historique à un journal, qui est réécrit à partir de l'historique courant.
+//! Chaque modification de l'historique y est ensuite ajoutée, par lots et sans bloquer l'interface
+//! La méthode markSaved() indique au journal que le niveau a été sauvegardé avec le jeton donné
+//! La méthode restoreFromJournal() remplace l'historique par celui qui correspond à la sauvegarde du jeton donné.
+//! Les actions relues sont placées dans le fichier temporaire, et ne sont chargées que lorsqu'elles sont atteintes
+//! La méthode detachJournal() termine l'écriture du journal
 //! Lorsqu'on annule une action, et qu'on effectue une nouvelle action, toutes les actions suivantes sont supprimées
 //! Par exemple, si on effectue la séquence suivante : "Action -> Action 2 -> Undo -> Action 3", l'historique sera : Action -> Action 3
 //!
 //! L'historique gardera une référence sur les sprites concernés par les actions pour pouvoir les annuler et les rétablir
 //! L'historique se chargera de supprimer les sprites qui ne sont plus référencés par aucune action et ne se trouvent plus dans l'éditeur
-class EditorHistory {
+//! Pour cela, il tient à jour le nombre de références de chaque sprite : la suppression d'une action ne coûte que
+//! le nombre de sprites qu'elle concerne
+class EditorHistory : public QObject {
+    Q_OBJECT
+
 public:
     explicit EditorHistory(EditorManager* editorManager);
     ~EditorHistory();
@@ -66,46 +112,132 @@ public:
 
     static Action inverseAction(Action action);
 
-    void addAction(Action action, QString additionalData);
     void addSpriteAction(Action action, QList<EditorSprite*> sprites);
     void addSpriteAction(Action action, EditorSprite* sprite);
-    void addSpriteAction(Action action, QList<EditorSprite*> sprites, QString additionalData);
-    void addSpriteAction(Action action, EditorSprite* sprite, QString additionalData);
+    void addMoveAction(QList<EditorSprite*> sprites, QVector<QPointF> positionsBefore, QVector<QPointF> positionsAfter);
+    void addMoveAction(EditorSprite* sprite, QPointF positionBefore, QPointF positionAfter);
+    void addValueAction(Action action, QList<EditorSprite*> sprites, QVector<qreal> valuesBefore, QVector<qreal> valuesAfter);
+    void addValueAction(Action action, EditorSprite* sprite, qreal valueBefore, qreal valueAfter);
+    void addBackgroundAction(Action action, QString imagePath);
 
     void undo();
     void redo();
 
     void clearHistory();
 
-    void pauseHistory(int level = 1);
-    void requestResumeHistory(int level = 1);
+    bool isRecording() const { return m_transactionDepth == 0; }
 
-private:
-    int const MAX_HISTORY_SIZE = 100;
-    int const MAX_PAUSE_LEVEL = 100;
+    //! Transaction regroupant toutes les modifications effectuées pendant sa durée de vie en une seule action.
+    //! L'action est ajoutée à l'historique à la destruction de la transaction, si celle-ci est la plus externe.
+    class Transaction {
+    public:
+        explicit Transaction(EditorHistory* pHistory);
+        ~Transaction();
 
-    bool m_paused = false;
+        Transaction(const Transaction&) = delete;
+        Transaction& operator=(const Transaction&) = delete;
 
-    int m_pauseLevel = 1;
+        bool isRecording() const { return m_isOutermost; }
 
-    EditorManager* m_pEditorManager = nullptr;
+        void recordSpriteAction(Action action, QList<EditorSprite*> sprites);
+        void recordMoveAction(QList<EditorSprite*> sprites, QVector<QPointF> positionsBefore, QVector<QPointF> positionsAfter);
 
-    struct State {
-        Action action;
-        QList<EditorSprite*> sprites;
-        QString additionalData;
+    private:
+        EditorHistory* m_pHistory = nullptr;
+        bool m_isOutermost = false;
+        EditorCommand* m_pCommand = nullptr; // L'action à enregistrer
     };
 
-    QList<State> m_states;
-    int m_currentStateIndex = -1;
+    void endCoalescing();
+
+    void setMemoryBudget(qint64 memoryBudget);
+    qint64 memoryBudget() const { return m_memoryBudget; }
+    qint64 residentMemory() const { return m_residentMemory; }
+
+    void attachJournal(const QString& journalFilePath);
+    void detachJournal();
+    QString journalFilePath() const;
+    void markSaved(const QString& token);
+    bool restoreFromJournal(const QString& journalFilePath, const QString& token);
+
+    void jumpTo(int index);
+    int currentIndex() const { return m_currentCommandIndex; }
+    int commandCount() const { return m_commands.size(); }
+
+    static constexpr qint64 DEFAULT_MEMORY_BUDGET = 64 * 1024 * 1024; // En octets
+
+signals:
+    void historyChanged(int currentIndex, int commandCount);
+
+private:
+    int const MAX_HISTORY_SIZE = 10000;
+    int const MIN_RESIDENT_COMMANDS = 10;
+    int const COALESCING_WINDOW = 1000; // En millisecondes
+    int const CHECKPOINT_INTERVAL = 20;
+    int const MIN_STEPS_SAVED_BY_CHECKPOINT = 5;
+
+    //! Copie compacte de l'état de l'éditeur
+    struct Checkpoint {
+        QByteArray spriteRecords; // Les SpriteRecord de tous les sprites de l'éditeur, sérialisés
+        QString backgroundImagePath;
+    };
+
+    int m_transactionDepth = 0; // Nombre de transactions en cours
+    bool m_changedInTransaction = false; // L'historique a été modifié pendant la transaction en cours
+
+    EditorManager* m_pEditorManager = nullptr;
+
+    QList<EditorCommand*> m_commands; // nullptr pour les actions écrites sur le disque
+    QList<qint64> m_spillOffsets; // Position de chaque action dans le fichier temporaire, -1 si elle est en mémoire
+    int m_currentCommandIndex = -1;
+    int m_firstResidentIndex = 0; // Les actions précédentes sont écrites sur le disque
+
+    qint64 m_memoryBudget = DEFAULT_MEMORY_BUDGET;
+    qint64 m_residentMemory = 0;
+    QTemporaryFile m_spillFile;
+
+    qint64 m_firstCommandNumber = 0; // Numéro de la première action de la liste depuis le début de l'historique
+    QMap<qint64, Checkpoint> m_checkpoints; // État de l'éditeur après l'action de ce numéro
+    qint64 m_checkpointMemory = 0;
+    bool m_checkpointScheduled = false;
+
+    EditorJournal* m_pJournal = nullptr;
+
+    bool m_canCoalesce = false;
+    QElapsedTimer m_lastCommandTimer;
+    int m_pendingJournalAmend = -1; // Index de l'action regroupée pas encore réécrite dans le journal, -1 si aucune
+    QTimer m_journalAmendTimer; // Réécrit l'action regroupée lorsque le regroupement prend fin
+
+    QHash<EditorSprite*, int> m_spriteReferenceCounts; // Nombre de références de chaque sprite dans les commandes
+    QHash<quint64, EditorSprite*> m_heldSpritesById; // Sprites référencés par les commandes, par identifiant
+
+    void addCommand(EditorCommand* command);
+
+    void retainSprites(const EditorCommand* command);
+    void releaseSprites(const EditorCommand* command);
+
+    void spillOldCommands();
+    bool openSpillFile();
+    qint64 spillCommandData(const QByteArray& commandData);
+    bool ensureResident(int index);
+    EditorCommand* reloadCommand(int index, QHash<quint64, EditorSprite*>& recreatedSprites);
+    void dropSpilledCommands();
+
+    void scheduleCheckpoint();
+    void captureCheckpoint();
+    void restoreCheckpoint(const Checkpoint& checkpoint);
+    void removeCheckpointsFrom(qint64 commandNumber);
+    bool stepTo(int index);
+    void notifyHistoryChanged();
+    void flushJournalAmend();
+
+    static QByteArray serializeCommand(const EditorCommand* command);
+    QByteArray commandData(int index);
 
-    void deleteAction(int i);
     void deleteActionsFrom(int index);
     void deleteActionsTo(int index);
 
     void deleteActionAndUnreferencedSprites(int i);
-
-    void performAction(State &state, bool inverse = false);
 };
 
 
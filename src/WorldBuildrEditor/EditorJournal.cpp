@@ -0,0 +1,311 @@
+/**
+ * @file EditorJournal.cpp
+ * @brief Définition de la classe EditorJournal.
+ * @author Noah Blattner
+ * @date Octobre 2026
+ */
+
+#include "EditorJournal.h"
+
+#include <QDataStream>
+#include <QDebug>
+#include <QFile>
+#include <QIODevice>
+#include <QSaveFile>
+
+#include "tracing.h"
+
+EditorJournal::EditorJournal(QObject* pParent) : QObject(pParent) {
+    m_writerPool.setMaxThreadCount(1);
+
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(FLUSH_DELAY);
+    connect(&m_flushTimer, &QTimer::timeout, this, &EditorJournal::flush);
+}
+
+EditorJournal::~EditorJournal() {
+    // On écrit les derniers enregistrements et on attend la fin de l'écriture
+    close();
+}
+
+//! Retourne le chemin du journal associé à un fichier de niveau
+//! \param levelFilePath Le chemin du fichier de niveau
+QString EditorJournal::journalFilePath(const QString& levelFilePath) {
+    return levelFilePath + ".history";
+}
+
+//! Ouvre le journal en le réécrivant entièrement à partir de l'historique donné
+//! \param filePath Le chemin du journal
+//! \param commands Les actions de l'historique, sérialisées
+//! \param cursor L'index de l'action courante
+void EditorJournal::open(const QString& filePath, const QList<QByteArray>& commands, int cursor) {
+    close();
+
+    m_filePath = filePath;
+
+    // Le contenu du journal est préparé ici, puis écrit par le fil d'écriture
+    QByteArray content;
+    {
+        QDataStream stream(&content, QIODevice::WriteOnly);
+        stream << MAGIC << VERSION;
+    }
+    for (int i = 0; i < commands.size(); i++) {
+        QByteArray payload;
+        QDataStream stream(&payload, QIODevice::WriteOnly);
+        stream.setVersion(QDataStream::Qt_6_0);
+        stream << static_cast<qint32>(i) << commands[i];
+        appendRecord(content, CommandRecord, payload);
+    }
+    m_cursor = commands.size() - 1;
+    setCursor(cursor);
+    content += m_pendingRecords;
+    m_pendingRecords.clear();
+    m_flushTimer.stop();
+
+    m_writerPool.start([filePath, content]() {
+        TRACE_SCOPE("EditorJournal::rewrite");
+
+        QSaveFile file(filePath);
+        if (!file.open(QIODevice::WriteOnly) || file.write(content) != content.size() || !file.commit()) {
+            qWarning() << "Impossible d'écrire le journal de l'historique" << filePath;
+        }
+    });
+}
+
+//! Ferme le journal, après avoir écrit les derniers enregistrements
+void EditorJournal::close() {
+    m_flushTimer.stop();
+    flush();
+    m_writerPool.waitForDone();
+
+    m_filePath.clear();
+    m_cursor = -1;
+}
+
+//! Enregistre l'ajout d'une action. Les actions suivant l'index donné sont supprimées
+//! \param index L'index de l'action
+//! \param command L'action sérialisée
+void EditorJournal::appendCommand(int index, const QByteArray& command) {
+    if (!isOpen()) {
+        return;
+    }
+
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << static_cast<qint32>(index) << command;
+    addRecord(CommandRecord, payload);
+
+    m_cursor = index;
+}
+
+//! Enregistre le remplacement d'une action
+//! \param index L'index de l'action
+//! \param command La nouvelle action sérialisée
+void EditorJournal::amendCommand(int index, const QByteArray& command) {
+    if (!isOpen()) {
+        return;
+    }
+
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << static_cast<qint32>(index) << command;
+    addRecord(AmendRecord, payload);
+}
+
+//! Enregistre le changement de l'action courante
+//! \param index L'index de l'action courante, -1 si aucune
+void EditorJournal::setCursor(int index) {
+    if (!isOpen() || index == m_cursor) {
+        return;
+    }
+
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream << static_cast<qint32>(index);
+    addRecord(CursorRecord, payload);
+
+    m_cursor = index;
+}
+
+//! Enregistre la suppression des actions les plus anciennes
+//! \param count Le nombre d'actions supprimées
+void EditorJournal::evictCommands(int count) {
+    if (!isOpen() || count <= 0) {
+        return;
+    }
+
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream << static_cast<qint32>(count);
+    addRecord(EvictRecord, payload);
+
+    m_cursor = qMax(m_cursor - count, -1);
+}
+
+//! Enregistre la suppression de toutes les actions
+void EditorJournal::clearCommands() {
+    if (!isOpen()) {
+        return;
+    }
+
+    addRecord(ClearRecord, QByteArray());
+    m_cursor = -1;
+}
+
+//! Enregistre la sauvegarde du niveau dans l'état courant, puis écrit immédiatement le journal
+//! \param token Le jeton unique écrit dans le niveau lors de la sauvegarde
+//! \param nextSpriteId Le prochain identifiant de sprite, pour que les sprites créés après réouverture ne réutilisent
+//!                     pas les identifiants des sprites de l'historique
+void EditorJournal::markSaved(const QString& token, quint64 nextSpriteId) {
+    if (!isOpen()) {
+        return;
+    }
+
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << token << nextSpriteId;
+    addRecord(SavedRecord, payload);
+
+    flush();
+}
+
+//! Confie les enregistrements en attente au fil d'écriture
+void EditorJournal::flush() {
+    m_flushTimer.stop();
+
+    if (!isOpen() || m_pendingRecords.isEmpty()) {
+        return;
+    }
+
+    QString filePath = m_filePath;
+    QByteArray records = std::move(m_pendingRecords);
+    m_pendingRecords = QByteArray();
+
+    m_writerPool.start([filePath, records]() {
+        TRACE_SCOPE("EditorJournal::flush");
+
+        QFile file(filePath);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Append) || file.write(records) != records.size()) {
+            qWarning() << "Impossible d'écrire le journal de l'historique" << filePath;
+        }
+    });
+}
+
+//! Ajoute un enregistrement aux enregistrements en attente, et planifie leur écriture
+//! \param type Le type d'enregistrement
+//! \param payload Les données de l'enregistrement
+void EditorJournal::addRecord(RecordType type, const QByteArray& payload) {
+    appendRecord(m_pendingRecords, type, payload);
+
+    if (!m_flushTimer.isActive()) {
+        m_flushTimer.start();
+    }
+}
+
+//! Ajoute un enregistrement à un tampon : son type, la taille de ses données, puis ses données
+//! \param buffer Le tampon
+//! \param type Le type d'enregistrement
+//! \param payload Les données de l'enregistrement
+void EditorJournal::appendRecord(QByteArray& buffer, RecordType type, const QByteArray& payload) {
+    QDataStream stream(&buffer, QIODevice::WriteOnly | QIODevice::Append);
+    stream << static_cast<quint8>(type) << static_cast<quint32>(payload.size());
+    stream.writeRawData(payload.constData(), payload.size());
+}
+
+//! Relit un journal et retourne l'historique tel qu'il était lors de la sauvegarde correspondant au jeton donné
+//! \param filePath Le chemin du journal
+//! \param token Le jeton écrit dans le niveau lors de sa sauvegarde
+//! \param commands Reçoit les actions de l'historique, sérialisées
+//! \param cursor Reçoit l'index de l'action courante
+//! \param nextSpriteId Reçoit le prochain identifiant de sprite
+//! \return true si une sauvegarde correspondant au jeton a été trouvée
+bool EditorJournal::readSavedState(const QString& filePath, const QString& token,
+                                   QList<QByteArray>& commands, int& cursor, quint64& nextSpriteId) {
+    TRACE_SCOPE("EditorJournal::readSavedState");
+
+    QFile file(filePath);
+    if (token.isEmpty() || !file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    quint32 magic = 0;
+    quint32 version = 0;
+    stream >> magic >> version;
+    if (stream.status() != QDataStream::Ok || magic != MAGIC || version != VERSION) {
+        return false;
+    }
+
+    QList<QByteArray> journalCommands;
+    int journalCursor = -1;
+    bool found = false;
+
+    while (!stream.atEnd()) {
+        quint8 type = 0;
+        quint32 payloadSize = 0;
+        stream >> type >> payloadSize;
+        // La taille est lue dans le fichier : elle est vérifiée avant d'allouer l'enregistrement
+        if (stream.status() != QDataStream::Ok || payloadSize > file.bytesAvailable()) {
+            break; // Enregistrement incomplet : le journal a été tronqué
+        }
+        QByteArray payload(static_cast<qsizetype>(payloadSize), Qt::Uninitialized);
+        if (stream.readRawData(payload.data(), payload.size()) != payload.size()) {
+            break;
+        }
+
+        QDataStream payloadStream(payload);
+        payloadStream.setVersion(QDataStream::Qt_6_0);
+        qint32 index = 0;
+        QByteArray command;
+
+        switch (static_cast<RecordType>(type)) {
+            case CommandRecord:
+                payloadStream >> index >> command;
+                if (index < 0 || index > journalCommands.size()) {
+                    return found;
+                }
+                journalCommands.resize(index);
+                journalCommands.append(command);
+                journalCursor = index;
+                break;
+            case AmendRecord:
+                payloadStream >> index >> command;
+                if (index < 0 || index >= journalCommands.size()) {
+                    return found;
+                }
+                journalCommands[index] = command;
+                break;
+            case CursorRecord:
+                payloadStream >> index;
+                journalCursor = qBound(-1, static_cast<int>(index), journalCommands.size() - 1);
+                break;
+            case EvictRecord:
+                payloadStream >> index;
+                index = qMin(static_cast<int>(index), journalCommands.size());
+                journalCommands.remove(0, index);
+                journalCursor = qMax(journalCursor - index, -1);
+                break;
+            case ClearRecord:
+                journalCommands.clear();
+                journalCursor = -1;
+                break;
+            case SavedRecord: {
+                QString savedToken;
+                quint64 savedNextSpriteId = 0;
+                payloadStream >> savedToken >> savedNextSpriteId;
+                if (savedToken == token) {
+                    commands = journalCommands;
+                    cursor = journalCursor;
+                    nextSpriteId = savedNextSpriteId;
+                    found = true;
+                }
+                break;
+            }
+        }
+    }
+
+    return found;
+}
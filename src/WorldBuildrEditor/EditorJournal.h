@@ -0,0 +1,90 @@
+/**
+ * @file EditorJournal.h
+ * @brief Déclaration de la classe EditorJournal.
+ * @author Noah Blattner
+ * @date Octobre 2026
+ */
+
+#ifndef WORLDBUILDR_EDITORJOURNAL_H
+#define WORLDBUILDR_EDITORJOURNAL_H
+
+#include <QByteArray>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+#include <QTimer>
+
+//! Journal binaire de l'historique de l'éditeur, écrit à côté du fichier du niveau (journalFilePath()).
+//! Il permet de retrouver l'historique d'un niveau lorsqu'on le rouvre dans une nouvelle session.
+//!
+//! Le journal est une suite d'enregistrements qui décrivent les modifications de la liste des actions de l'historique,
+//! chaque action étant conservée sous sa forme sérialisée (EditorCommand::write()) :
+//! appendCommand() ajoute une action à un index donné (les actions suivantes sont supprimées)
+//! amendCommand() remplace une action, par exemple lorsqu'elle a absorbé une autre action
+//! setCursor() change l'index de l'action courante (annulation, rétablissement)
+//! evictCommands() supprime les actions les plus anciennes
+//! clearCommands() vide l'historique
+//! markSaved() indique que le niveau a été sauvegardé dans l'état courant, avec un jeton unique écrit dans le niveau
+//!
+//! Les enregistrements sont regroupés en mémoire, puis écrits par lots sur un fil d'exécution dédié :
+//! l'enregistrement d'une action ne bloque jamais l'interface. Un lot est écrit FLUSH_DELAY millisecondes
+//! après le premier enregistrement, ou immédiatement lors d'une sauvegarde (markSaved()).
+//!
+//! La méthode open() réécrit entièrement le journal à partir de l'historique courant, ce qui le compacte.
+//! La méthode statique readSavedState() relit un journal et retourne l'historique tel qu'il était lors de la sauvegarde
+//! correspondant au jeton donné. Un journal tronqué (par exemple après un arrêt brutal) est lu jusqu'au dernier
+//! enregistrement complet.
+class EditorJournal : public QObject {
+    Q_OBJECT
+
+public:
+    explicit EditorJournal(QObject* pParent = nullptr);
+    ~EditorJournal() override;
+
+    enum RecordType : quint8 {
+        CommandRecord,
+        AmendRecord,
+        CursorRecord,
+        EvictRecord,
+        ClearRecord,
+        SavedRecord
+    };
+
+    static QString journalFilePath(const QString& levelFilePath);
+
+    void open(const QString& filePath, const QList<QByteArray>& commands, int cursor);
+    void close();
+    bool isOpen() const { return !m_filePath.isEmpty(); }
+    QString filePath() const { return m_filePath; }
+
+    void appendCommand(int index, const QByteArray& command);
+    void amendCommand(int index, const QByteArray& command);
+    void setCursor(int index);
+    void evictCommands(int count);
+    void clearCommands();
+    void markSaved(const QString& token, quint64 nextSpriteId);
+
+    void flush();
+
+    static bool readSavedState(const QString& filePath, const QString& token,
+                               QList<QByteArray>& commands, int& cursor, quint64& nextSpriteId);
+
+private:
+    static constexpr quint32 MAGIC = 0x57424a4e; // "WBJN"
+    static constexpr quint32 VERSION = 1;
+    int const FLUSH_DELAY = 250; // En millisecondes
+
+    static void appendRecord(QByteArray& buffer, RecordType type, const QByteArray& payload);
+    void addRecord(RecordType type, const QByteArray& payload);
+
+    QString m_filePath;
+    QByteArray m_pendingRecords; // Enregistrements pas encore écrits
+    int m_cursor = -1; // Index de l'action courante, tel qu'écrit dans le journal
+
+    QTimer m_flushTimer;
+    QThreadPool m_writerPool; // Un seul fil : les lots sont écrits dans l'ordre
+};
+
+
+#endif //WORLDBUILDR_EDITORJOURNAL_H
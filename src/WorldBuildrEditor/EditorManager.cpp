@@ -5,14 +5,19 @@
  * @date Janvier 2023
  */
 
+#include <QFile>
 #include <QFileDialog>
 #include <QMessageBox>
 #include <utility>
+#include "AutoSaveManager.h"
 #include "EditorManager.h"
 #include "EditorHistory.h"
+#include "EditorJournal.h"
 #include "GameCore.h"
 #include "GameScene.h"
 #include "EditorSprite.h"
+#include "LevelFile.h"
+#include "LevelSaver.h"
 #include "SelectionZone.h"
 #include "resources.h"
 #include "SaveFileManager.h"
@@ -22,6 +27,13 @@
 EditorManager::EditorManager(GameCore* core) {
     m_pScene = core->getScene();
     m_editorHistory = new EditorHistory(this);
+    connect(m_editorHistory, &EditorHistory::historyChanged, this, &EditorManager::historyChanged);
+
+    m_pLevelSaver = new LevelSaver(this);
+    connect(m_pLevelSaver, &LevelSaver::saveProgress, this, &EditorManager::saveProgress);
+    connect(m_pLevelSaver, &LevelSaver::saveFinished, this, &EditorManager::onLevelSaveFinished);
+
+    m_pAutoSaveManager = new AutoSaveManager(this);
 
     // Connecte les signaux d'input aux fonctions de traitement
     connect(core, &GameCore::notifyKeyPressed, this, &EditorManager::onKeyPressed);
@@ -32,11 +44,16 @@ EditorManager::EditorManager(GameCore* core) {
 }
 
 EditorManager::~EditorManager() {
-    // Supprime l'historique
+    // Termine les sauvegardes en cours. La sauvegarde automatique n'est plus nécessaire
+    m_pLevelSaver->waitForDone();
+    delete m_pAutoSaveManager;
+
+    // Ferme la transaction d'un éventuel drag and drop en cours, puis supprime l'historique
+    m_pDragTransaction.reset();
     delete m_editorHistory;
 
     // Supprime les sprites
-    for (auto* sprite : m_pEditorSprites) {
+    for (auto* sprite : m_editorSprites) {
         delete sprite;
     }
 
@@ -76,7 +93,7 @@ void EditorManager::onKeyPressed(int key) {
         case Qt::Key_A:
             if (m_isCtrlHeld) {
                 // On sélectionne tous les sprites
-                selectMultipleEditorSprites(m_pEditorSprites);
+                selectMultipleEditorSprites(m_editorSprites.toList());
             }
             break;
         case Qt::Key_N:
@@ -190,18 +207,23 @@ void EditorManager::onMouseMoved(QPointF newMousePosition, QPointF oldMousePosit
                 if (mouseDownEditorSprite->getEditSelected()) { // Si le sprite est sélectionné
                     // On fait du drag and drop
                     if (!m_isDragging) { // Si c'est le premier mouvement du drag and drop
-                        // On met en pause l'historique
-                        m_editorHistory->pauseHistory(2);
+                        // On ouvre une transaction : le déplacement sera enregistré en une seule action
+                        m_pDragTransaction = std::make_unique<EditorHistory::Transaction>(m_editorHistory);
 
                         // On commence le drag and drop
                         m_isDragging = true;
                         m_startDragPosition = oldMousePosition;
+
+                        // On retient la position de départ des sprites déplacés
+                        m_draggedEditorSprites = m_selectedEditorSprites.toList();
+                        m_dragStartSpritePositions.clear();
+                        m_dragStartSpritePositions.reserve(m_draggedEditorSprites.size());
+                        for (EditorSprite* pSprite : m_draggedEditorSprites) {
+                            m_dragStartSpritePositions.append(pSprite->pos());
+                        }
                     }
 
                     if (m_isGridEnabled) { // Si la grille est activée
-                        // Activer l'historique
-                        m_editorHistory->requestResumeHistory(2);
-
                         int prevGridX = oldMousePosition.x() / m_gridCellSize;
                         int prevGridY = oldMousePosition.y() / m_gridCellSize;
 
@@ -218,9 +240,6 @@ void EditorManager::onMouseMoved(QPointF newMousePosition, QPointF oldMousePosit
                             setEditorSpriteY(mouseDownEditorSprite, newGridY * m_gridCellSize);
                         }
 
-                        // On met en pause l'historique
-                        m_editorHistory->pauseHistory(2);
-
                     } else if (m_isSpriteSnappingEnabled) { // Sinon si le snap est activé
                         // Prévoir le déplacement du sprite
                         QRectF spriteRectPredict = mouseDownEditorSprite->sceneBoundingRect();
@@ -256,11 +275,20 @@ void EditorManager::onMouseButtonReleased(QPointF mousePosition, Qt::MouseButton
             mouseUpSprite = dynamic_cast<EditorSprite *>(m_pScene->spriteAt(mousePosition));
 
             if (m_isDragging) { // Si on a fait un drag and drop
-                // On reprend l'historique
-                m_editorHistory->requestResumeHistory(2);
-                // On enregistre l'action
-                QPointF delta = mousePosition - m_startDragPosition;
-                m_editorHistory->addSpriteAction(EditorHistory::Action::MoveSprite, m_pSelectedEditorSprites, QString::number(delta.x()) + ";" + QString::number(delta.y()));
+                // On enregistre l'action : position de départ et d'arrivée de chaque sprite déplacé
+                QVector<QPointF> dragEndSpritePositions;
+                dragEndSpritePositions.reserve(m_draggedEditorSprites.size());
+                for (EditorSprite* pSprite : m_draggedEditorSprites) {
+                    dragEndSpritePositions.append(pSprite->pos());
+                }
+                m_pDragTransaction->recordMoveAction(m_draggedEditorSprites, m_dragStartSpritePositions, dragEndSpritePositions);
+
+                // On ferme la transaction, ce qui ajoute l'action à l'historique
+                m_pDragTransaction.reset();
+                m_editorHistory->endCoalescing();
+
+                m_draggedEditorSprites.clear();
+                m_dragStartSpritePositions.clear();
                 m_isDragging = false;
             } else if (mouseUpSprite != nullptr && mouseUpSprite == mouseDownEditorSprite) { // Si le sprite relâché est le même que le sprite cliqué
                 // On sélectionne le sprite
@@ -268,10 +296,11 @@ void EditorManager::onMouseButtonReleased(QPointF mousePosition, Qt::MouseButton
             } else if (m_pMultiSelectionZone != nullptr) { // Sinon si une zone de sélection est en cours
                 // On récupère tous les sprites qui sont dans la zone de sélection
                 auto sprites = m_pMultiSelectionZone->endSelection();
+                bool selectionChangedDuringZone = m_hasSelectionZoneChanges;
+                m_hasSelectionZoneChanges = false;
 
                 if (!sprites.empty()) {
-                    m_editorHistory->addSpriteAction(EditorHistory::Action::SelectSprite, sprites);
-                    m_editorHistory->pauseHistory(2);
+                    EditorHistory::Transaction transaction(m_editorHistory);
 
                     // On désélectionne tous les sprites
                     unselectAllEditorSprites();
@@ -279,7 +308,10 @@ void EditorManager::onMouseButtonReleased(QPointF mousePosition, Qt::MouseButton
                     // On sélectionne tous les sprites qui sont dans la zone de sélection
                     selectMultipleEditorSprites(sprites);
 
-                    m_editorHistory->requestResumeHistory(2);
+                    // Historique
+                    transaction.recordSpriteAction(EditorHistory::Action::SelectSprite, sprites);
+                } else if (selectionChangedDuringZone) { // Sélection modifiée pendant le déplacement de la souris, pas encore signalée
+                    emit selectionChanged(m_selectedEditorSprites.toList());
                 }
 
                 m_pMultiSelectionZone = nullptr;
@@ -297,24 +329,59 @@ void EditorManager::onMouseButtonReleased(QPointF mousePosition, Qt::MouseButton
 //! Sauvegarde l'éditeur dans un fichier.
 //! \param saveFilePath    Chemin du fichier de sauvegarde.
 void EditorManager::save(QString saveFilePath) {
-    if (saveFilePath.isEmpty()) { // Si le chemin est vide, demander à l'utilisateur de choisir un fichier
-        saveFilePath = QFileDialog::getSaveFileName(nullptr, "Save file", SaveFileManager::DEFAULT_SAVE_DIR, "JSON (*.json)");
+    if (saveFilePath.isEmpty()) { // Si le chemin est vide, demander à l'utilisateur de choisir un fichier et sa compression
+        QString selectedFilter;
+        saveFilePath = QFileDialog::getSaveFileName(nullptr, "Save file", SaveFileManager::DEFAULT_SAVE_DIR, SaveFileManager::SAVE_DIALOG_FILTER, &selectedFilter);
+        if (!saveFilePath.isEmpty()) {
+            m_saveCodec = SaveFileManager::codecFromDialogFilter(selectedFilter);
+        }
     }
 
     if (saveFilePath.isEmpty()) { // Si le chemin est toujours vide, annuler
         return;
     }
 
-    // Ajouter l'extension .json si elle n'est pas présente
-    if (!saveFilePath.endsWith(".json")) {
-        saveFilePath += ".json";
+    // Ajouter l'extension du format binaire si aucune extension de niveau n'est présente
+    if (!saveFilePath.endsWith(LevelFile::BINARY_EXTENSION) && !saveFilePath.endsWith(LevelFile::JSON_EXTENSION)) {
+        saveFilePath += LevelFile::BINARY_EXTENSION;
     }
 
     // On retient le chemin du fichier de sauvegarde
     m_saveFilePath = saveFilePath;
 
-    // Sauvegarde le fichier
-    SaveFileManager::save(this,std::move(saveFilePath));
+    // Sauvegarde le fichier, sur le fil de sauvegarde
+    SaveFileManager::save(this,std::move(saveFilePath), m_saveCodec);
+}
+
+//! Propose de restaurer la sauvegarde automatique laissée par un arrêt brutal de l'éditeur, s'il y en a une.
+//! La sauvegarde automatique est ensuite réécrite à partir de l'état de l'éditeur.
+void EditorManager::recoverAutoSave() {
+    if (!AutoSaveManager::hasAutoSave()) {
+        return;
+    }
+
+    // La sauvegarde automatique est lue avant d'interroger l'utilisateur : elle pourrait être réécrite entre-temps
+    LevelData level;
+    bool recovered = AutoSaveManager::readAutoSave(level);
+
+    if (recovered && QMessageBox::question(nullptr, "Sauvegarde automatique",
+                                           "L'éditeur n'a pas été fermé correctement. Voulez-vous restaurer la sauvegarde automatique ?")
+                     == QMessageBox::Yes) {
+        SaveFileManager::restoreLevel(this, level);
+    }
+
+    m_pAutoSaveManager->compact();
+}
+
+//! Slot appelé à la fin d'une sauvegarde. Affiche une erreur si la sauvegarde a échoué.
+//! \param filePath    Chemin du fichier de sauvegarde.
+//! \param success     Indique si la sauvegarde a réussi.
+//! \param error       Description de l'erreur.
+void EditorManager::onLevelSaveFinished(const QString& filePath, bool success, const QString& error) {
+    if (!success) {
+        QMessageBox::critical(nullptr, "Erreur", error);
+    }
+    emit saveFinished(filePath, success);
 }
 
 //! Charge un fichier de sauvegarde dans l'éditeur.
@@ -326,18 +393,21 @@ void EditorManager::load(QString saveFilePath) {
     }
 
     if (saveFilePath.isEmpty()) { // Si le chemin est vide, demander à l'utilisateur de choisir un fichier
-        saveFilePath = QFileDialog::getOpenFileName(nullptr, "Load file", SaveFileManager::DEFAULT_SAVE_DIR, "JSON (*.json)");
+        saveFilePath = QFileDialog::getOpenFileName(nullptr, "Load file", SaveFileManager::DEFAULT_SAVE_DIR, SaveFileManager::FILE_DIALOG_FILTER);
     }
 
     if (saveFilePath.isEmpty()) { // Si le chemin est toujours vide, annuler
         return;
     }
 
-    // Ajouter l'extension .json si elle n'est pas présente
-    if (!saveFilePath.endsWith(".json")) {
-        saveFilePath += ".json";
+    // Ajouter l'extension si elle n'est pas présente : format binaire s'il existe, JSON sinon
+    if (!saveFilePath.endsWith(LevelFile::BINARY_EXTENSION) && !saveFilePath.endsWith(LevelFile::JSON_EXTENSION)) {
+        saveFilePath += QFile::exists(saveFilePath + LevelFile::BINARY_EXTENSION) ? LevelFile::BINARY_EXTENSION : LevelFile::JSON_EXTENSION;
     }
 
+    // Attend la fin des sauvegardes en cours, qui peuvent concerner ce fichier
+    m_pLevelSaver->waitForDone();
+
     SaveFileManager::load(this,std::move(saveFilePath));
 }
 
@@ -345,28 +415,35 @@ void EditorManager::load(QString saveFilePath) {
 //! \param saveFilePath    Chemin du fichier de sauvegarde.
 void EditorManager::import(QString saveFilePath) {
     if (saveFilePath.isEmpty()) { // Si le chemin est vide, demander à l'utilisateur de choisir un fichier
-        saveFilePath = QFileDialog::getOpenFileName(nullptr, "Load file", SaveFileManager::DEFAULT_SAVE_DIR, "JSON (*.json)");
+        saveFilePath = QFileDialog::getOpenFileName(nullptr, "Load file", SaveFileManager::DEFAULT_SAVE_DIR, SaveFileManager::FILE_DIALOG_FILTER);
     }
 
     if (saveFilePath.isEmpty()) { // Si le chemin est toujours vide, annuler
         return;
     }
 
-    // Ajouter l'extension .json si elle n'est pas présente
-    if (!saveFilePath.endsWith(".json")) {
-        saveFilePath += ".json";
+    // Ajouter l'extension si elle n'est pas présente : format binaire s'il existe, JSON sinon
+    if (!saveFilePath.endsWith(LevelFile::BINARY_EXTENSION) && !saveFilePath.endsWith(LevelFile::JSON_EXTENSION)) {
+        saveFilePath += QFile::exists(saveFilePath + LevelFile::BINARY_EXTENSION) ? LevelFile::BINARY_EXTENSION : LevelFile::JSON_EXTENSION;
     }
 
+    // Attend la fin des sauvegardes en cours, qui peuvent concerner ce fichier
+    m_pLevelSaver->waitForDone();
+
     SaveFileManager::import(this,std::move(saveFilePath));
 }
 
 //! Réinitialise l'éditeur. Supprime tous les sprites d'éditeur.
 void EditorManager::resetEditor() {
+    // L'historique ne correspond plus au niveau : on termine l'écriture de son journal
+    m_editorHistory->detachJournal();
+
     // Supprimer les tags
     TagsManager::clearTags();
 
-    // Réinitialise le chemin de sauvegarde
+    // Réinitialise le chemin de sauvegarde et sa compression
     m_saveFilePath = "";
+    m_saveCodec = LevelCompression::NoCodec;
 
     // Supprime l'image de fond
     removeBackGroundImage();
@@ -408,8 +485,15 @@ void EditorManager::setSceneSize(QSize size) {
 
 //! Indique si l'éditeur contient le sprite donné.
 //! \param pEditSprite    Sprite d'éditeur à chercher.
-bool EditorManager::containsEditorSprite(EditorSprite *pEditSprite) const {
-    return m_pEditorSprites.contains(pEditSprite);
+bool EditorManager::containsEditorSprite(const EditorSprite *pEditSprite) const {
+    return pEditSprite != nullptr && m_editorSpritesById.value(pEditSprite->getId()) == pEditSprite;
+}
+
+//! Retrouve un sprite de l'éditeur à partir de son identifiant.
+//! \param id    Identifiant du sprite.
+//! \return      Le sprite, ou nullptr si l'éditeur ne contient pas de sprite avec cet identifiant.
+EditorSprite* EditorManager::editorSpriteById(quint64 id) const {
+    return m_editorSpritesById.value(id, nullptr);
 }
 
 //! Réinitialise l'historique de l'éditeur
@@ -417,6 +501,62 @@ void EditorManager::resetHistory() {
     m_editorHistory->clearHistory();
 }
 
+//! Termine le geste en cours : l'action suivante ne sera pas regroupée avec les précédentes
+void EditorManager::endHistoryGesture() {
+    m_editorHistory->endCoalescing();
+}
+
+//! Modifie le budget mémoire de l'historique
+//! \param memoryBudget Le budget, en octets
+void EditorManager::setHistoryMemoryBudget(qint64 memoryBudget) {
+    m_editorHistory->setMemoryBudget(memoryBudget);
+}
+
+//! Indique que le niveau a été sauvegardé dans l'état courant
+//! L'historique est alors conservé dans un journal à côté du niveau, pour être restauré à sa réouverture
+//! \param levelFilePath Le chemin du niveau
+//! \param token Le jeton unique écrit dans le niveau
+void EditorManager::markHistorySaved(const QString& levelFilePath, const QString& token) {
+    QString journalFilePath = EditorJournal::journalFilePath(levelFilePath);
+    if (m_editorHistory->journalFilePath() != journalFilePath) {
+        m_editorHistory->attachJournal(journalFilePath);
+    }
+    m_editorHistory->markSaved(token);
+}
+
+//! Restaure l'historique d'un niveau qui vient d'être chargé, à partir de son journal
+//! Les modifications suivantes de l'historique sont ajoutées au journal
+//! \param levelFilePath Le chemin du niveau
+//! \param token Le jeton lu dans le niveau
+//! \return true si l'historique a été restauré
+bool EditorManager::restoreHistory(const QString& levelFilePath, const QString& token) {
+    QString journalFilePath = EditorJournal::journalFilePath(levelFilePath);
+    bool restored = m_editorHistory->restoreFromJournal(journalFilePath, token);
+
+    // Le journal est réécrit à partir de l'historique courant, ce qui le compacte
+    m_editorHistory->attachJournal(journalFilePath);
+    if (!token.isEmpty()) {
+        m_editorHistory->markSaved(token);
+    }
+    return restored;
+}
+
+//! Atteint directement un état de l'historique
+//! \param index L'index de la dernière action effectuée dans cet état (-1 pour l'état précédant toutes les actions)
+void EditorManager::jumpToHistoryIndex(int index) {
+    m_editorHistory->jumpTo(index);
+}
+
+//! Retourne l'index de la dernière action effectuée, -1 si aucune
+int EditorManager::historyIndex() const {
+    return m_editorHistory->currentIndex();
+}
+
+//! Retourne le nombre d'actions de l'historique
+int EditorManager::historyCount() const {
+    return m_editorHistory->commandCount();
+}
+
 //! Annule la dernière action de l'historique
 void EditorManager::undo() {
     m_editorHistory->undo();
@@ -510,23 +650,44 @@ void EditorManager::createSelectionZone(QPointF startPositon) {
     m_pMultiSelectionZone = new SelectionZone(m_pScene, startPositon);
 }
 
-//! Cherche le z-index le plus élevé parmi tous les sprites d'éditeur.
+//! Retourne le z-index le plus élevé parmi tous les sprites d'éditeur, 0 au minimum.
+//! Les z-index sont tenus à jour dans m_zIndexCounts : le plus élevé est obtenu sans parcourir les sprites.
 //! \return Le z-index le plus élevé.
 int EditorManager::getHighestZIndex() const {
-    if (m_pEditorSprites.isEmpty()) { // Si il n'y a pas de sprite
+    if (m_zIndexCounts.isEmpty()) { // Si il n'y a pas de sprite
         return 0;
     }
 
-    // Cherche le sprite avec le z-index le plus élevé
-    int maxZIndex = 0;
-    for (EditorSprite* pEditSprite : m_pEditorSprites) {
-        if (pEditSprite->zValue() > maxZIndex) {
-            maxZIndex = pEditSprite->zValue();
-        }
+    return qMax(0, static_cast<int>(m_zIndexCounts.lastKey()));
+}
+
+//! Retourne le z-index le plus bas parmi tous les sprites d'éditeur, 0 au maximum.
+//! \return Le z-index le plus bas.
+int EditorManager::getLowestZIndex() const {
+    if (m_zIndexCounts.isEmpty()) { // Si il n'y a pas de sprite
+        return 0;
     }
 
-    // Retourne le z-index suivant
-    return maxZIndex;
+    return qMin(0, static_cast<int>(m_zIndexCounts.firstKey()));
+}
+
+//! Compte un sprite d'éditeur ayant le z-index donné.
+//! \param zIndex    Le z-index du sprite.
+void EditorManager::trackZIndex(qreal zIndex) {
+    m_zIndexCounts[zIndex]++;
+}
+
+//! Décompte un sprite d'éditeur ayant le z-index donné.
+//! \param zIndex    Le z-index du sprite.
+void EditorManager::untrackZIndex(qreal zIndex) {
+    auto it = m_zIndexCounts.find(zIndex);
+    if (it == m_zIndexCounts.end()) {
+        return;
+    }
+
+    if (--it.value() == 0) { // Plus aucun sprite n'a ce z-index
+        m_zIndexCounts.erase(it);
+    }
 }
 
 /********************************************
@@ -557,12 +718,16 @@ void EditorManager::createNewEditorSprite(QString imageFileName, QPointF positio
 //! \param pEditorSprite    Pointeur vers le sprite d'éditeur à ajouter.
 //! \param position         Position du sprite. Défaut : QPointF(0, 0)
 void EditorManager::addEditorSprite(EditorSprite *pEditorSprite, const QPointF &position) {
-    // On ajoute le sprite à la liste des sprites d'éditeur
-    m_pEditorSprites.append(pEditorSprite);
+    // On ajoute le sprite à l'ensemble des sprites d'éditeur
+    if (!m_editorSprites.insert(pEditorSprite)) { // Si le sprite est déjà dans l'éditeur
+        return;
+    }
+    m_editorSpritesById.insert(pEditorSprite->getId(), pEditorSprite);
+    trackZIndex(pEditorSprite->zValue());
 
     if (pEditorSprite->getEditSelected()) { // Si le sprite est sélectionné
-        // On ajoute le sprite à la liste des sprites sélectionnés
-        m_pSelectedEditorSprites.append(pEditorSprite);
+        // On ajoute le sprite à l'ensemble des sprites sélectionnés
+        m_selectedEditorSprites.insert(pEditorSprite);
     }
 
     if (position != QPointF(0, 0)) { // Si la position est différente de 0
@@ -578,12 +743,14 @@ void EditorManager::addEditorSprite(EditorSprite *pEditorSprite, const QPointF &
 
     // Historique
     m_editorHistory->addSpriteAction(EditorHistory::Action::AddSprite, pEditorSprite);
+
+    emit editorSpriteAdded(pEditorSprite);
 }
 
 //! Duplique un sprite d'éditeur.
 EditorSprite* EditorManager::duplicateEditorSprite(EditorSprite* pEditSprite) {
-    // Désactive l'historique pour éviter de créer un historique pour chaque sprite dupliqué
-    m_editorHistory->pauseHistory();
+    // Une seule action est enregistrée pour la duplication
+    EditorHistory::Transaction transaction(m_editorHistory);
 
     // On crée un nouveau sprite d'éditeur
     auto* duplicatedSprite = pEditSprite->clone();
@@ -612,19 +779,18 @@ EditorSprite* EditorManager::duplicateEditorSprite(EditorSprite* pEditSprite) {
     }
 
     // Historique
-    m_editorHistory->requestResumeHistory();
-    m_editorHistory->addSpriteAction(EditorHistory::Action::DuplicateSprite, pEditSprite);
+    transaction.recordSpriteAction(EditorHistory::Action::DuplicateSprite, {duplicatedSprite});
 
     return duplicatedSprite;
 }
 
 //! Duplique tous les sprites d'éditeur sélectionnés.
 void EditorManager::duplicateSelectedEditorSprites() {
-    // Désactive l'historique pour éviter de créer un historique pour chaque sprite dupliqué
-    m_editorHistory->pauseHistory(2);
+    // Une seule action est enregistrée pour tous les sprites dupliqués
+    EditorHistory::Transaction transaction(m_editorHistory);
 
     // Dupliquer la liste des sprites sélectionnés
-    auto spritesToDuplicate = m_pSelectedEditorSprites;
+    auto spritesToDuplicate = m_selectedEditorSprites.toList();
 
     // On désélectionne tous les sprites
     unselectAllEditorSprites();
@@ -638,8 +804,7 @@ void EditorManager::duplicateSelectedEditorSprites() {
     }
 
     // Historique
-    m_editorHistory->requestResumeHistory(2);
-    m_editorHistory->addSpriteAction(EditorHistory::Action::DuplicateSprite, duplicatedSprites);
+    transaction.recordSpriteAction(EditorHistory::Action::DuplicateSprite, duplicatedSprites);
 }
 
 /********************************************
@@ -649,10 +814,9 @@ void EditorManager::duplicateSelectedEditorSprites() {
 //! Sélectionne un sprite d'éditeur.
 //! \param pEditSprite    Sprite d'éditeur à sélectionner.
 void EditorManager::selectEditorSprite(EditorSprite *pEditSprite) {
-    // Ajoute le sprite cliqué à la liste des sprites sélectionnés
-    if (!m_pSelectedEditorSprites.contains(pEditSprite)) {
+    // Ajoute le sprite cliqué à l'ensemble des sprites sélectionnés
+    if (m_selectedEditorSprites.insert(pEditSprite)) {
         emit editorSpriteSelected(pEditSprite);
-        m_pSelectedEditorSprites.append(pEditSprite);
 
         // Indique au sprite qu'il est sélectionné
         pEditSprite->setEditSelected(true);
@@ -664,6 +828,9 @@ void EditorManager::selectEditorSprite(EditorSprite *pEditSprite) {
 
 //! Sélectionne un sprite d'éditeur en désélectionnant tout les autres.
 void EditorManager::selectSingleEditorSprite(EditorSprite *pEditSprite) {
+    // Une seule action de sélection est enregistrée
+    EditorHistory::Transaction transaction(m_editorHistory);
+
     // Désélectionne tous les sprites
     unselectAllEditorSprites();
 
@@ -671,54 +838,105 @@ void EditorManager::selectSingleEditorSprite(EditorSprite *pEditSprite) {
     selectEditorSprite(pEditSprite);
 
     // Historique
-    m_editorHistory->addSpriteAction(EditorHistory::Action::SelectSprite, pEditSprite);
+    transaction.recordSpriteAction(EditorHistory::Action::SelectSprite, {pEditSprite});
 }
 
 //! Désélectionne tous les sprites d'éditeur.
+//! L'action enregistrée ne contient que les sprites qui étaient sélectionnés : son annulation rétablit exactement la sélection
 void EditorManager::unselectAllEditorSprites() {
-    // Désactive l'historique pour éviter de créer un historique pour chaque sprite désélectionné
-    m_editorHistory->pauseHistory();
-
-    // Indique à tous les sprites qu'ils ne sont plus sélectionnés
-    for (EditorSprite* pSprite : m_pSelectedEditorSprites) {
-        pSprite->setEditSelected(false);
+    if (m_selectedEditorSprites.isEmpty()) { // Rien à désélectionner
+        return;
     }
 
-    // Vide la liste des sprites sélectionnés
-    m_pSelectedEditorSprites.clear();
+    // Vide l'ensemble des sprites sélectionnés
+    QList<EditorSprite*> previouslySelected = m_selectedEditorSprites.toList();
+    m_selectedEditorSprites.clear();
+
+    // Indique à tous les sprites qu'ils ne sont plus sélectionnés, puis met à jour la scène une seule fois
+    for (EditorSprite* pSprite : previouslySelected) {
+        pSprite->setEditSelected(false, false);
+    }
+    m_pScene->update();
 
     // Historique
-    m_editorHistory->requestResumeHistory();
-    m_editorHistory->addSpriteAction(EditorHistory::Action::DeselectAll, m_pEditorSprites);
+    m_editorHistory->addSpriteAction(EditorHistory::Action::DeselectSprite, previouslySelected);
+
+    emit selectionChanged(m_selectedEditorSprites.toList());
 }
 
 //! Change la sélection d'un sprite d'éditeur.
 void EditorManager::toggleSelectEditorSprite(EditorSprite* pEditSprite) {
-    if (m_pSelectedEditorSprites.contains(pEditSprite)) {
+    if (m_selectedEditorSprites.contains(pEditSprite)) {
         unselectEditorSprite(pEditSprite);
     } else {
         selectEditorSprite(pEditSprite);
     }
 }
 
-//! Sélectionne plusieurs sprites d'éditeur.
+//! Sélectionne plusieurs sprites d'éditeur en une seule passe.
+//! Contrairement à selectEditorSprite(), aucun signal n'est émis par sprite : le signal selectionChanged() est émis une seule fois,
+//! et une seule action, ne contenant que les sprites nouvellement sélectionnés, est enregistrée dans l'historique.
 void EditorManager::selectMultipleEditorSprites(const QList<EditorSprite*> &pEditSprites) {
-    // Desactive l'historique pour éviter de créer un historique pour chaque sprite sélectionné
-    m_editorHistory->pauseHistory();
+    m_selectedEditorSprites.reserve(m_selectedEditorSprites.size() + pEditSprites.size());
+
+    QList<EditorSprite*> newlySelected;
+    newlySelected.reserve(pEditSprites.size());
+    for (EditorSprite* pSprite : pEditSprites) {
+        if (m_selectedEditorSprites.insert(pSprite)) {
+            newlySelected.append(pSprite);
+
+            // La scène est mise à jour une seule fois, à la fin
+            pSprite->setEditSelected(true, false);
+        }
+    }
+
+    if (newlySelected.isEmpty()) { // Rien n'a changé
+        return;
+    }
+
+    m_pScene->update();
+
+    // Historique
+    m_editorHistory->addSpriteAction(EditorHistory::Action::SelectSprite, newlySelected);
 
+    if (m_isSelectionZoneUpdating) { // Signalé au relâchement de la souris
+        m_hasSelectionZoneChanges = true;
+        return;
+    }
+    emit selectionChanged(m_selectedEditorSprites.toList());
+}
+
+//! Désélectionne plusieurs sprites d'éditeur en une seule passe.
+//! Le signal selectionChanged() est émis une seule fois, et une seule action est enregistrée dans l'historique.
+void EditorManager::unselectMultipleEditorSprites(const QList<EditorSprite*> &pEditSprites) {
+    if (m_selectedEditorSprites.isEmpty() || pEditSprites.isEmpty()) { // Rien à désélectionner
+        return;
+    }
+
+    QList<EditorSprite*> unselectedSprites;
     for (EditorSprite* pSprite : pEditSprites) {
-        selectEditorSprite(pSprite);
+        if (m_selectedEditorSprites.remove(pSprite)) {
+            unselectedSprites.append(pSprite);
+            pSprite->setEditSelected(false, false);
+        }
     }
 
+    if (unselectedSprites.isEmpty()) { // Rien n'a changé
+        return;
+    }
+
+    m_pScene->update();
+
     // Historique
-    m_editorHistory->requestResumeHistory();
-    m_editorHistory->addSpriteAction(EditorHistory::Action::SelectSprite, pEditSprites);
+    m_editorHistory->addSpriteAction(EditorHistory::Action::DeselectSprite, unselectedSprites);
+
+    emit selectionChanged(m_selectedEditorSprites.toList());
 }
 
 //! Désélectionne un sprite d'éditeur.
 void EditorManager::unselectEditorSprite(EditorSprite* pEditSprite) {
-    // Enlève le sprite de la liste des sprites sélectionnés
-    m_pSelectedEditorSprites.removeOne(pEditSprite);
+    // Enlève le sprite de l'ensemble des sprites sélectionnés
+    m_selectedEditorSprites.remove(pEditSprite);
 
     // Indique au sprite qu'il n'est plus sélectionné
     pEditSprite->setEditSelected(false);
@@ -729,26 +947,25 @@ void EditorManager::unselectEditorSprite(EditorSprite* pEditSprite) {
 
 //! Sélectionne tous les sprites d'éditeur.
 void EditorManager::selectAllEditorSprites() {
-    // Désactive l'historique pour éviter de créer un historique pour chaque sprite sélectionné
-    m_editorHistory->pauseHistory(2);
+    // Une seule action est enregistrée pour tous les sprites sélectionnés
+    EditorHistory::Transaction transaction(m_editorHistory);
 
-    selectMultipleEditorSprites(m_pEditorSprites);
+    selectMultipleEditorSprites(m_editorSprites.toList());
 
-    // Historique
-    m_editorHistory->requestResumeHistory(2);
-    m_editorHistory->addSpriteAction(EditorHistory::Action::SelectAll, m_pEditorSprites);
+    // Historique : l'annulation et le rétablissement n'ont pas besoin de la liste des sprites
+    transaction.recordSpriteAction(EditorHistory::Action::SelectAll, QList<EditorSprite*>());
 }
 
 //! Met à jour la multi-sélection.
 void EditorManager::updateMultiSelect(QPointF &newMousePosition) {// On met à jour la zone de
-    // Désactive l'historique pour éviter de créer un historique pour chaque sprite sélectionné
-    m_editorHistory->pauseHistory(2);
+    // La sélection n'est enregistrée qu'au relâchement de la souris
+    EditorHistory::Transaction transaction(m_editorHistory);
 
+    // La sélection complète n'est signalée qu'au relâchement de la souris, et non à chaque mouvement
     m_pMultiSelectionZone->updateSelection(newMousePosition);
+    m_isSelectionZoneUpdating = true;
     selectMultipleEditorSprites(m_pMultiSelectionZone->getCollidingEditorSprites());
-
-    // Historique
-    m_editorHistory->requestResumeHistory(2);
+    m_isSelectionZoneUpdating = false;
 }
 
 /********************************************
@@ -759,8 +976,11 @@ void EditorManager::updateMultiSelect(QPointF &newMousePosition) {// On met à j
 void EditorManager::deleteEditorSprite(EditorSprite* pEditSprite) {
     emit editorSpriteDeleted(pEditSprite);
 
-    m_pEditorSprites.removeOne(pEditSprite);
-    m_pSelectedEditorSprites.removeOne(pEditSprite);
+    if (m_editorSprites.remove(pEditSprite)) {
+        untrackZIndex(pEditSprite->zValue());
+    }
+    m_editorSpritesById.remove(pEditSprite->getId());
+    m_selectedEditorSprites.remove(pEditSprite);
     m_pScene->removeSpriteFromScene(pEditSprite);
 
     // Historique
@@ -769,16 +989,17 @@ void EditorManager::deleteEditorSprite(EditorSprite* pEditSprite) {
 
 //! Supprime tous les sprites sélectionnés.
 void EditorManager::deleteSelectedEditorSprites() {
-    // Désactive l'historique pour éviter de créer un historique pour chaque sprite supprimé
-    m_editorHistory->addSpriteAction(EditorHistory::Action::RemoveSprite, m_pSelectedEditorSprites);
-    m_editorHistory->pauseHistory();
+    // Une seule action est enregistrée pour tous les sprites supprimés
+    EditorHistory::Transaction transaction(m_editorHistory);
 
-    for (auto* pSprite : m_pSelectedEditorSprites) {
+    // deleteEditorSprite() retire le sprite de la sélection : on parcourt une copie
+    const QList<EditorSprite*> spritesToDelete = m_selectedEditorSprites.toList();
+    for (auto* pSprite : spritesToDelete) {
         deleteEditorSprite(pSprite);
     }
 
     // Historique
-    m_editorHistory->requestResumeHistory();
+    transaction.recordSpriteAction(EditorHistory::Action::RemoveSprite, spritesToDelete);
 }
 
 /********************************************
@@ -796,7 +1017,7 @@ void EditorManager::setEditorSpriteX(EditorSprite* pEditSprite, qreal x) {
         return;
     }
 
-    m_editorHistory->addSpriteAction(EditorHistory::Action::MoveSprite, pEditSprite, QString::number(x - pEditSprite->x()) + ";0");
+    m_editorHistory->addMoveAction(pEditSprite, pEditSprite->pos(), QPointF(x, pEditSprite->y()));
     pEditSprite->setX(x);
 }
 
@@ -811,10 +1032,23 @@ void EditorManager::setEditorSpriteY(EditorSprite* pEditSprite, qreal y) {
         return;
     }
 
-    m_editorHistory->addSpriteAction(EditorHistory::Action::MoveSprite, pEditSprite, "0;" + QString::number(y - pEditSprite->y()));
+    m_editorHistory->addMoveAction(pEditSprite, pEditSprite->pos(), QPointF(pEditSprite->x(), y));
     pEditSprite->setY(y);
 }
 
+//! Place un sprite d'éditeur à une position donnée.
+//! \param pEditSprite    Sprite d'éditeur à déplacer.
+//! \param position    Nouvelle position.
+void EditorManager::setEditorSpritePos(EditorSprite* pEditSprite, QPointF position) {
+    QPointF previousPosition = pEditSprite->pos();
+
+    // Déplace le sprite (moveBy() signale la modification du sprite)
+    pEditSprite->moveBy(position.x() - previousPosition.x(), position.y() - previousPosition.y());
+
+    // Historique
+    m_editorHistory->addMoveAction(pEditSprite, previousPosition, position);
+}
+
 //! Déplace un sprite d'éditeur d'un vecteur donné.
 //! \param pEditSprite    Sprite d'éditeur à déplacer.
 //! \param moveVector    Vecteur de déplacement.
@@ -829,35 +1063,52 @@ void EditorManager::moveEditorSprite(EditorSprite *pEditSprite, QPointF moveVect
     }
 
     // Déplace le sprite
+    QPointF previousPosition = pEditSprite->pos();
     pEditSprite->moveBy(moveVector.x(), moveVector.y());
 
     // Historique
-    m_editorHistory->addSpriteAction(EditorHistory::Action::MoveSprite, pEditSprite, QString::number(moveVector.x()) + ";" + QString::number(moveVector.y()));
+    m_editorHistory->addMoveAction(pEditSprite, previousPosition, pEditSprite->pos());
 }
 
 //! Déplace tous les sprites sélectionnés d'un vecteur donné.
 //! \param moveVector    Vecteur de déplacement.
 void EditorManager::moveSelectedEditorSprites(QPointF moveVector) {
-    // Désactive l'historique pour éviter de créer un historique pour chaque sprite déplacé
-    m_editorHistory->pauseHistory();
+    // Une seule action est enregistrée pour tous les sprites déplacés
+    EditorHistory::Transaction transaction(m_editorHistory);
+
+    // Les positions de départ ne sont rassemblées que si l'action sera enregistrée
+    bool recordHistory = transaction.isRecording();
+    QVector<QPointF> positionsBefore;
+    if (recordHistory) {
+        positionsBefore.reserve(m_selectedEditorSprites.size());
+        for (auto *pSprite: m_selectedEditorSprites) {
+            positionsBefore.append(pSprite->pos());
+        }
+    }
 
-    for (auto *pSprite: m_pSelectedEditorSprites) {
+    for (auto *pSprite: m_selectedEditorSprites) {
         moveEditorSprite(pSprite, moveVector);
     }
 
     // Historique
-    m_editorHistory->requestResumeHistory();
-    m_editorHistory->addSpriteAction(EditorHistory::Action::MoveSprite, m_pSelectedEditorSprites, QString::number(moveVector.x()) + ";" + QString::number(moveVector.y()));
+    if (recordHistory) {
+        QVector<QPointF> positionsAfter;
+        positionsAfter.reserve(m_selectedEditorSprites.size());
+        for (auto *pSprite: m_selectedEditorSprites) {
+            positionsAfter.append(pSprite->pos());
+        }
+        transaction.recordMoveAction(m_selectedEditorSprites.toList(), std::move(positionsBefore), std::move(positionsAfter));
+    }
 }
 
 //! Tourne un sprite d'éditeur d'un angle donné.
 //! \param pEditSprite    Sprite d'éditeur à tourner.
 //! \param angle    Angle de rotation à appliquer.
 void EditorManager::setEditorSpriteRotation(EditorSprite *pEditSprite, qreal angle) {
-    pEditSprite->setRotation(angle);
-
     // Historique
-    m_editorHistory->addSpriteAction(EditorHistory::Action::RotateSprite, pEditSprite, QString::number(angle));
+    m_editorHistory->addValueAction(EditorHistory::Action::RotateSprite, pEditSprite, pEditSprite->rotation(), angle);
+
+    pEditSprite->setRotation(angle);
 }
 
 //! Change l'index de profondeur d'un sprite d'éditeur.
@@ -865,19 +1116,45 @@ void EditorManager::setEditorSpriteRotation(EditorSprite *pEditSprite, qreal ang
 //! \param zIndex    Nouvel index de profondeur.
 void EditorManager::setEditorSpriteZIndex(EditorSprite* pEditSprite, int zIndex) {
     // Historique
-    m_editorHistory->addSpriteAction(EditorHistory::Action::ChangeZIndex, pEditSprite, QString::number(zIndex - pEditSprite->zValue()));
+    m_editorHistory->addValueAction(EditorHistory::Action::ChangeZIndex, pEditSprite, pEditSprite->zValue(), zIndex);
+
+    if (m_editorSprites.contains(pEditSprite)) { // Le sprite est compté dans m_zIndexCounts
+        untrackZIndex(pEditSprite->zValue());
+        trackZIndex(zIndex);
+    }
 
     pEditSprite->setZValue(zIndex);
 }
 
+//! Place un sprite d'éditeur au premier plan, au-dessus de tous les autres sprites.
+//! \param pEditSprite    Sprite d'éditeur à déplacer.
+void EditorManager::bringEditorSpriteToFront(EditorSprite* pEditSprite) {
+    int highestZIndex = getHighestZIndex();
+    if (pEditSprite->zValue() == highestZIndex && m_zIndexCounts.value(highestZIndex) == 1) { // Déjà seul au premier plan
+        return;
+    }
+
+    setEditorSpriteZIndex(pEditSprite, highestZIndex + 1);
+}
+
+//! Place un sprite d'éditeur à l'arrière-plan, en dessous de tous les autres sprites.
+//! \param pEditSprite    Sprite d'éditeur à déplacer.
+void EditorManager::sendEditorSpriteToBack(EditorSprite* pEditSprite) {
+    int lowestZIndex = getLowestZIndex();
+    if (pEditSprite->zValue() == lowestZIndex && m_zIndexCounts.value(lowestZIndex) == 1) { // Déjà seul à l'arrière-plan
+        return;
+    }
+
+    setEditorSpriteZIndex(pEditSprite, lowestZIndex - 1);
+}
+
 //! Change la taille d'un sprite d'éditeur.
 //! \param pEditSprite    Sprite d'éditeur à redimensionner.
 //! \param xScale    Facteur d'agrandissement sur l'axe X.
 //! \param yScale    Facteur d'agrandissement sur l'axe Y.
 void EditorManager::rescaleEditorSprite(EditorSprite *pEditSprite, double scale) {
     // Historique
-    // Les données additionnelles est la différence du scale
-    m_editorHistory->addSpriteAction(EditorHistory::Action::RescaleSprite, pEditSprite, QString::number(scale - pEditSprite->scale()));
+    m_editorHistory->addValueAction(EditorHistory::Action::RescaleSprite, pEditSprite, pEditSprite->scale(), scale);
 
     pEditSprite->setScale(scale);
 }
@@ -886,7 +1163,7 @@ void EditorManager::rescaleEditorSprite(EditorSprite *pEditSprite, double scale)
 //! \param pEditSprite    Sprite d'éditeur à modifier.
 void EditorManager::setEditorSpriteOpacity(EditorSprite* pEditSprite, double opacity) {
     // Historique
-    m_editorHistory->addSpriteAction(EditorHistory::Action::ChangeOpacity, pEditSprite, QString::number(opacity - pEditSprite->opacity()));
+    m_editorHistory->addValueAction(EditorHistory::Action::ChangeOpacity, pEditSprite, pEditSprite->opacity(), opacity);
 
     pEditSprite->setOpacity(opacity);
 }
@@ -921,13 +1198,13 @@ void EditorManager::setBackGroundImage(QString imageFileName) {
     m_backgroundImageFileName = imageFileName;
 
     // Historique
-    m_editorHistory->addAction(EditorHistory::Action::AddBackground, m_backgroundImageFileName);
+    m_editorHistory->addBackgroundAction(EditorHistory::Action::AddBackground, m_backgroundImageFileName);
 }
 
 //! Supprime l'image de fond de l'éditeur.
 void EditorManager::removeBackGroundImage() {
     // Historique
-    m_editorHistory->addAction(EditorHistory::Action::RemoveBackground, m_backgroundImageFileName);
+    m_editorHistory->addBackgroundAction(EditorHistory::Action::RemoveBackground, m_backgroundImageFileName);
     m_backgroundImageFileName = QString();
 
     // On charge une image vide dans la scène
@@ -8,12 +8,22 @@
 #ifndef WORLDBUILDR_EDITORMANAGER_H
 #define WORLDBUILDR_EDITORMANAGER_H
 
+#include <memory>
+
+#include <QHash>
+#include <QMap>
 #include <QWidget>
 #include <QPointF>
+#include <QVector>
 #include <QVector2D>
 
+#include "EditorHistory.h"
+#include "LevelCompression.h"
+#include "EditorSpriteSet.h"
+
+class AutoSaveManager;
 class EditorSprite;
-class EditorHistory;
+class LevelSaver;
 class SelectionZone;
 class GameCore;
 class GameScene;
@@ -35,10 +45,22 @@ class GameScene;
 //! La méthode selectSingleEditorSprite() permet de sélectionner un seul sprite (dé-selection tous les autres)
 //! La méthode selectAllEditorSprites() permet de sélectionner tous les sprites
 //! La méthode toggleSelectEditorSprite() permet de basculer la sélection d'un sprite
-//! La méthode selectMultipleEditorSprites() permet de sélectionner plusieurs sprites
+//! La méthode selectMultipleEditorSprites() permet de sélectionner plusieurs sprites en une seule passe
 //! La méthode unselectEditorSprite() permet de dé-sélectionner un sprite
+//! La méthode unselectMultipleEditorSprites() permet de dé-sélectionner plusieurs sprites en une seule passe
 //! La méthode unselectAllEditorSprites() permet de dé-sélectionner tous les sprites
+//! Le signal editorSpriteSelected() est émis pour chaque sprite sélectionné individuellement ;
+//! les sélections en bloc n'émettent que le signal selectionChanged(), une seule fois
 //! La méthode moveEditorSprite() permet de déplacer un sprite
+//! La méthode setEditorSpritePos() permet de placer un sprite à une position donnée
+//! La méthode setEditorSpriteZIndex() permet de changer l'index de profondeur d'un sprite
+//! Les méthodes bringEditorSpriteToFront() et sendEditorSpriteToBack() placent un sprite au premier plan ou à l'arrière-plan.
+//! Les z-index des sprites sont comptés dans une table triée : le plus élevé et le plus bas sont connus sans parcourir les sprites
+//!
+//! La méthode save() sauvegarde le niveau sans bloquer l'interface (voir LevelSaver) : les signaux saveProgress()
+//! et saveFinished() indiquent la progression et la fin de la sauvegarde
+//! Une sauvegarde automatique incrémentale suit les modifications de l'éditeur (voir AutoSaveManager).
+//! La méthode recoverAutoSave() propose de restaurer la sauvegarde automatique laissée par un arrêt brutal
 //!
 //! Les méthodes de gestion de l'arrière-plan sont :
 //! La méthode setBackGroundImage() permet de définir l'image de fond de la scène
@@ -48,12 +70,19 @@ class GameScene;
 //! La méthode undo() permet d'annuler la dernière action
 //! La méthode redo() permet de refaire la dernière action annulée
 //! La méthode resetHistory() permet de réinitialiser l'historique
-//! Pour l'historique, il faut parfois utiliser les méthodes de pause et de reprise de l'historique.
-//! Cette approche à été préférée à un approche où l'on passe un booléen en paramètre à chaque méthode d'action de sprite
+//! La méthode endHistoryGesture() indique la fin d'un geste : les actions suivantes ne seront pas regroupées avec les précédentes
+//! La méthode jumpToHistoryIndex() permet d'atteindre directement n'importe quel état de l'historique
+//! Le signal historyChanged() est émis à chaque modification de l'historique ou de l'état courant
+//! La méthode markHistorySaved() indique que le niveau a été sauvegardé : l'historique est conservé dans un journal à côté du niveau
+//! La méthode restoreHistory() restaure l'historique d'un niveau qui vient d'être chargé à partir de son journal
+//! La méthode setHistoryMemoryBudget() limite la mémoire occupée par l'historique, au-delà de laquelle les actions anciennes sont écrites sur le disque
+//! Pour l'historique, les méthodes portant sur plusieurs sprites ouvrent une transaction (EditorHistory::Transaction),
+//! afin d'enregistrer une seule action. Cette approche à été préférée à un approche où l'on passe un booléen en paramètre à chaque méthode d'action de sprite
 //! Pour plus d'information, voir la classe EditorHistory
 //!
 //! Les méthodes utilitaires sont :
 //! La méthode containsEditorSprite() permet de savoir si un sprite est géré par l'éditeur
+//! La méthode editorSpriteById() permet de retrouver un sprite de l'éditeur à partir de son identifiant
 //! La méthode createSelectionZone() permet de créer la zone de multi-sélection
 //! La méthode loadImageToEditor() permet de charger une image dans l'éditeur (copie dans le dossier de l'éditeur).
 //! Elle retourne le chemin de l'image dans l'éditeur.
@@ -67,13 +96,16 @@ public:
     void resetEditor();
 
     // Gestion des sprites
-    QList<EditorSprite*> getEditorSprites() const { return m_pEditorSprites; }
-    bool containsEditorSprite(EditorSprite* pEditSprite) const;
+    QList<EditorSprite*> getEditorSprites() const { return m_editorSprites.toList(); }
+    bool containsEditorSprite(const EditorSprite* pEditSprite) const;
+    EditorSprite* editorSpriteById(quint64 id) const;
 
     // Gestion de sauvegarde et chargement
     void save(QString saveFilePath);
     void load(QString saveFilePath);
     void import(QString saveFilePath);
+    LevelSaver* getLevelSaver() const { return m_pLevelSaver; }
+    void recoverAutoSave();
 
     // Gestion du snap et de la grille
     void setGridCellSize(int size);
@@ -84,6 +116,13 @@ public:
     void undo();
     void redo();
     void resetHistory();
+    void endHistoryGesture();
+    void setHistoryMemoryBudget(qint64 memoryBudget);
+    void markHistorySaved(const QString& levelFilePath, const QString& token);
+    bool restoreHistory(const QString& levelFilePath, const QString& token);
+    void jumpToHistoryIndex(int index);
+    int historyIndex() const;
+    int historyCount() const;
 
     // Gestion de création
     void createSelectionZone(QPointF startPositon);
@@ -99,6 +138,7 @@ public:
     void toggleSelectEditorSprite(EditorSprite* pEditSprite);
     void selectMultipleEditorSprites(const QList<EditorSprite*>& pEditSprites);
     void unselectEditorSprite(EditorSprite* pEditSprite);
+    void unselectMultipleEditorSprites(const QList<EditorSprite*>& pEditSprites);
     void unselectAllEditorSprites();
 
     // Gestion de suppression
@@ -108,9 +148,12 @@ public:
     // Gestion de modification de sprites
     void setEditorSpriteX(EditorSprite* pEditSprite, qreal x);
     void setEditorSpriteY(EditorSprite* pEditSprite, qreal y);
+    void setEditorSpritePos(EditorSprite* pEditSprite, QPointF position);
     void moveEditorSprite(EditorSprite* pEditSprite, QPointF moveVector);
     void moveSelectedEditorSprites(QPointF moveVector);
     void setEditorSpriteZIndex(EditorSprite* pEditSprite, int zIndex);
+    void bringEditorSpriteToFront(EditorSprite* pEditSprite);
+    void sendEditorSpriteToBack(EditorSprite* pEditSprite);
     void setEditorSpriteRotation(EditorSprite* pEditSprite, qreal angle);
     void rescaleEditorSprite(EditorSprite *pEditSprite, double scale);
     void setEditorSpriteOpacity(EditorSprite *pEditSprite, double opacity);
@@ -129,7 +172,10 @@ private:
 
     EditorHistory* m_editorHistory = nullptr;
 
+    LevelSaver* m_pLevelSaver = nullptr;
+    AutoSaveManager* m_pAutoSaveManager = nullptr;
     QString m_saveFilePath = QString();
+    LevelCompression::Codec m_saveCodec = LevelCompression::NoCodec; // Compression choisie lors du dernier "Sauvegarder sous"
 
     QString m_backgroundImageFileName = QString();
 
@@ -143,10 +189,15 @@ private:
 
     // Multi selection
     SelectionZone* m_pMultiSelectionZone = nullptr;
+    bool m_isSelectionZoneUpdating = false; // selectionChanged() n'est émis qu'au relâchement de la souris
+    bool m_hasSelectionZoneChanges = false; // La sélection a changé depuis le début de la zone de sélection
 
     // Drag and drop
     QPointF m_startDragPosition;
     bool m_isDragging = false;
+    QList<EditorSprite*> m_draggedEditorSprites;
+    QVector<QPointF> m_dragStartSpritePositions;
+    std::unique_ptr<EditorHistory::Transaction> m_pDragTransaction; // Ouverte pendant toute la durée du drag and drop
     EditorSprite* mouseDownEditorSprite = nullptr;
 
     // Grid and sprite snapping
@@ -155,14 +206,19 @@ private:
     bool m_isSpriteSnappingEnabled = false;
 
     // Liste des sprites
-    QList<EditorSprite*> m_pEditorSprites;
-    QList<EditorSprite*> m_pSelectedEditorSprites;
+    EditorSpriteSet m_editorSprites;
+    QHash<quint64, EditorSprite*> m_editorSpritesById; // Pour containsEditorSprite() et editorSpriteById() en temps constant
+    EditorSpriteSet m_selectedEditorSprites;
 
     bool isInScene(QRectF rectF) const;
 
     QString loadImageToEditor();
 
+    QMap<qreal, int> m_zIndexCounts; // Nombre de sprites d'éditeur par z-index, trié par z-index
+    void trackZIndex(qreal zIndex);
+    void untrackZIndex(qreal zIndex);
     int getHighestZIndex() const;
+    int getLowestZIndex() const;
 
 private slots:
     void editorSpriteClicked(EditorSprite* pEditSprite);
@@ -176,10 +232,21 @@ private slots:
 
     void updateMultiSelect(QPointF &newMousePosition);
 
+    void onLevelSaveFinished(const QString& filePath, bool success, const QString& error);
+
 signals:
+    void editorSpriteAdded(EditorSprite* pEditSprite);
+
     void editorSpriteSelected(EditorSprite* pEditSprite);
 
+    void selectionChanged(const QList<EditorSprite*>& selectedSprites);
+
     void editorSpriteDeleted(EditorSprite* pEditSprite);
+
+    void historyChanged(int currentIndex, int commandCount);
+
+    void saveProgress(const QString& filePath, int percent);
+    void saveFinished(const QString& filePath, bool success);
 };
 
 
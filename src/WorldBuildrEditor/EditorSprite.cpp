@@ -11,7 +11,19 @@
 #include <iostream>
 #include <QPainter>
 
-EditorSprite::EditorSprite(const QString &imageFileName, bool selected, QGraphicsItem *pParent) : Sprite(imageFileName, pParent) {
+quint64 EditorSprite::s_nextId = 1;
+
+EditorSprite::EditorSprite(const QString &imageFileName, bool selected, QGraphicsItem *pParent)
+    : EditorSprite(QPixmap(imageFileName), imageFileName, selected, pParent) {
+}
+
+//! \brief Construit un sprite d'éditeur à partir d'une image déjà décodée, par exemple par un TextureLoader.
+//! \param image            Image du sprite.
+//! \param imageFileName    Chemin de l'image, enregistré avec le sprite.
+//! \param selected         True si le sprite est sélectionné.
+//! \param pParent          Pointeur sur le parent.
+EditorSprite::EditorSprite(const QPixmap &image, const QString &imageFileName, bool selected, QGraphicsItem *pParent) : Sprite(image, pParent) {
+    m_id = s_nextId++;
     m_imagePath = imageFileName;
     m_isEditSelected = selected;
 
@@ -31,7 +43,8 @@ void EditorSprite::paint(QPainter *pPainter, const QStyleOptionGraphicsItem *pOp
 
 //! \brief Set si le sprite est sélectionné et met à jour l'affichage.
 //! \param selected     True si le sprite est sélectionné.
-void EditorSprite::setEditSelected(bool selected) {
+//! \param updateDisplay    False si l'appelant met lui-même à jour la scène, par exemple après une sélection en bloc.
+void EditorSprite::setEditSelected(bool selected, bool updateDisplay) {
     m_isEditSelected = selected;
 
     if (!selected) { // Si le sprite est désélectionné
@@ -39,7 +52,7 @@ void EditorSprite::setEditSelected(bool selected) {
         emit editorSpriteUnselected();
     }
 
-    if (scene() != nullptr) // Si la sprite est dans une scène
+    if (updateDisplay && scene() != nullptr) // Si la sprite est dans une scène
         // On met à jour la scène
         update();
 }
@@ -53,6 +66,8 @@ bool EditorSprite::getEditSelected() const {
 //! \param tag   Tag à ajouter.
 void EditorSprite::setTag(const QString &tag) {
     setData(TAG_KEY, tag);
+
+    emit editorSpriteModified();
 }
 
 //! \brief Retourne le tag de la sprite.
@@ -64,6 +79,81 @@ QString EditorSprite::getTag() {
 //! \brief Supprime le tag de la sprite.
 void EditorSprite::removeTag() {
     setData(TAG_KEY, QVariant());
+
+    emit editorSpriteModified();
+}
+
+//! \brief Force l'identifiant du sprite, par exemple lorsqu'il est recréé.
+//! Les identifiants attribués ensuite aux nouveaux sprites restent uniques.
+//! \param id   Identifiant du sprite.
+void EditorSprite::setId(quint64 id) {
+    m_id = id;
+
+    if (id >= s_nextId) {
+        s_nextId = id + 1;
+    }
+}
+
+//! \brief Réserve les identifiants inférieurs à celui donné : les nouveaux sprites recevront un identifiant supérieur ou égal.
+//! \param nextId   Prochain identifiant à attribuer.
+void EditorSprite::reserveIds(quint64 nextId) {
+    if (nextId > s_nextId) {
+        s_nextId = nextId;
+    }
+}
+
+//! \brief Estime la mémoire occupée par le sprite, image comprise.
+//! \return Nombre d'octets.
+qint64 EditorSprite::memoryCost() const {
+    const QPixmap& image = pixmap();
+    return static_cast<qint64>(sizeof(EditorSprite))
+         + static_cast<qint64>(image.width()) * image.height() * image.depth() / 8;
+}
+
+//! \brief Retourne la représentation compacte du sprite.
+SpriteRecord EditorSprite::toRecord() const {
+    SpriteRecord record;
+    record.id = m_id;
+    record.imagePath = m_imagePath;
+    record.pos = pos();
+    record.zValue = zValue();
+    record.rotation = rotation();
+    record.scale = scale();
+    record.opacity = opacity();
+    record.tag = data(TAG_KEY).toString();
+    record.selected = m_isEditSelected;
+    return record;
+}
+
+//! \brief Recrée un sprite à partir de sa représentation compacte. Le sprite recréé a le même identifiant.
+//! \param record   Représentation compacte du sprite.
+//! \return Le sprite recréé. L'appelant en prend la propriété.
+EditorSprite* EditorSprite::fromRecord(const SpriteRecord& record) {
+    auto* sprite = new EditorSprite(record.imagePath, record.selected);
+    sprite->setId(record.id);
+    sprite->setPos(record.pos);
+    sprite->setZValue(record.zValue);
+    sprite->setRotation(record.rotation);
+    sprite->setScale(record.scale);
+    sprite->setOpacity(record.opacity);
+    if (!record.tag.isEmpty()) {
+        sprite->setTag(record.tag);
+    }
+    return sprite;
+}
+
+//! \brief Écrit la représentation compacte d'un sprite dans un flux.
+QDataStream& operator<<(QDataStream& stream, const SpriteRecord& record) {
+    stream << record.id << record.imagePath << record.pos << record.zValue << record.rotation
+           << record.scale << record.opacity << record.tag << record.selected;
+    return stream;
+}
+
+//! \brief Lit la représentation compacte d'un sprite depuis un flux.
+QDataStream& operator>>(QDataStream& stream, SpriteRecord& record) {
+    stream >> record.id >> record.imagePath >> record.pos >> record.zValue >> record.rotation
+           >> record.scale >> record.opacity >> record.tag >> record.selected;
+    return stream;
 }
 
 //! Crée un clone du sprite d'éditeur.
@@ -94,6 +184,14 @@ void EditorSprite::setY(qreal y) {
     emit editorSpriteModified();
 }
 
+//! \brief Change la position du sprite et émet un signal de modification.
+//! \param pos  Nouvelle position.
+void EditorSprite::setPos(const QPointF& pos) {
+    QGraphicsItem::setPos(pos);
+
+    emit editorSpriteModified();
+}
+
 //! \brief Déplace le sprite et émet un signal de modification.
 //! \param dx   Déplacement en x.
 //! \param dy   Déplacement en y.
@@ -110,3 +208,27 @@ void EditorSprite::setRotation(qreal angle) {
 
     emit editorSpriteModified();
 }
+
+//! \brief Change l'index de profondeur du sprite et émet un signal de modification.
+//! \param z    Index de profondeur.
+void EditorSprite::setZValue(qreal z) {
+    QGraphicsItem::setZValue(z);
+
+    emit editorSpriteModified();
+}
+
+//! \brief Change l'échelle du sprite et émet un signal de modification.
+//! \param scale    Échelle.
+void EditorSprite::setScale(qreal scale) {
+    QGraphicsItem::setScale(scale);
+
+    emit editorSpriteModified();
+}
+
+//! \brief Change l'opacité du sprite et émet un signal de modification.
+//! \param opacity  Opacité, entre 0 et 1.
+void EditorSprite::setOpacity(qreal opacity) {
+    QGraphicsItem::setOpacity(opacity);
+
+    emit editorSpriteModified();
+}
@@ -9,8 +9,29 @@
 #define WORLDBUILDR_EDITORSPRITE_H
 
 
+#include <QDataStream>
+#include <QPointF>
+#include <QString>
+
 #include "sprite.h"
 
+//! Représentation compacte et sérialisable d'un sprite d'éditeur.
+//! Elle contient tout ce qui est nécessaire pour recréer le sprite (EditorSprite::fromRecord()).
+struct SpriteRecord {
+    quint64 id = 0;
+    QString imagePath;
+    QPointF pos;
+    qreal zValue = 0;
+    qreal rotation = 0;
+    qreal scale = 1;
+    qreal opacity = 1;
+    QString tag;
+    bool selected = false;
+};
+
+QDataStream& operator<<(QDataStream& stream, const SpriteRecord& record);
+QDataStream& operator>>(QDataStream& stream, SpriteRecord& record);
+
 //! Classe représentant une sprite dans l'éditeur.
 //! Une fois ajoutée à une scène, elle écoute le clic gauche de la souris pour envoyer un signal.
 //! Elle gère également l'affichage de la sélection.
@@ -22,15 +43,25 @@
 //!
 //! Les méthodes de gestion de l'image sont :
 //! La méthode getImgPath() permet de récupérer le chemin de l'image utilisée par le sprite.
+//!
+//! Chaque sprite possède un identifiant unique et stable (getId()), qui permet de le retrouver
+//! lorsqu'il est recréé à partir de sa représentation compacte :
+//! La méthode toRecord() retourne la représentation compacte du sprite (SpriteRecord).
+//! La méthode fromRecord() recrée un sprite à partir de sa représentation compacte, avec le même identifiant.
+//! La méthode memoryCost() estime la mémoire occupée par le sprite.
+//! La méthode reserveIds() évite qu'un nouveau sprite reçoive un identifiant déjà utilisé, par exemple dans un historique relu.
+//!
+//! Les méthodes de modification (position, rotation, profondeur, échelle, opacité et tag) émettent le signal editorSpriteModified().
 class EditorSprite : public Sprite {
     Q_OBJECT
 
 public:
     explicit EditorSprite(const QString& imageFileName, bool selected = false, QGraphicsItem* pParent = nullptr);
+    EditorSprite(const QPixmap& image, const QString& imageFileName, bool selected = false, QGraphicsItem* pParent = nullptr);
 
     virtual void paint(QPainter* pPainter, const QStyleOptionGraphicsItem* pOption, QWidget* pWidget = nullptr) override;
 
-    void setEditSelected(bool selected);
+    void setEditSelected(bool selected, bool updateDisplay = true);
     bool getEditSelected() const;
 
     void setTag(const QString& tag);
@@ -39,16 +70,36 @@ public:
 
     QString getImgPath() const { return m_imagePath; }
 
+    quint64 getId() const { return m_id; }
+    void setId(quint64 id);
+
+    static quint64 nextId() { return s_nextId; }
+    static void reserveIds(quint64 nextId);
+
+    qint64 memoryCost() const;
+
     EditorSprite* clone() const;
 
+    SpriteRecord toRecord() const;
+    static EditorSprite* fromRecord(const SpriteRecord& record);
+
     void setX(qreal x);
     void setY(qreal y);
+    void setPos(const QPointF& pos);
+    void setPos(qreal x, qreal y) { setPos(QPointF(x, y)); }
     void moveBy(qreal dx, qreal dy);
     void setRotation(qreal angle);
+    void setZValue(qreal z);
+    void setScale(qreal scale);
+    void setOpacity(qreal opacity);
 
 private:
     const int TAG_KEY = 0;
 
+    static quint64 s_nextId;
+
+    quint64 m_id = 0;
+
     QString m_imagePath = "";
 
     bool m_isEditSelected = false;
@@ -0,0 +1,54 @@
+/**
+ * @file EditorSpriteSet.cpp
+ * @brief Définition de la classe EditorSpriteSet.
+ * @author Noah Blattner
+ * @date Octobre 2026
+ */
+
+#include "EditorSpriteSet.h"
+
+//! Ajoute un sprite à l'ensemble.
+//! \param pSprite  Le sprite à ajouter.
+//! \return true si le sprite a été ajouté, false s'il faisait déjà partie de l'ensemble.
+bool EditorSpriteSet::insert(EditorSprite* pSprite) {
+    if (m_indices.contains(pSprite)) {
+        return false;
+    }
+
+    m_indices.insert(pSprite, m_sprites.size());
+    m_sprites.append(pSprite);
+    return true;
+}
+
+//! Retire un sprite de l'ensemble. Le dernier sprite de la liste prend sa place.
+//! \param pSprite  Le sprite à retirer.
+//! \return true si le sprite a été retiré, false s'il ne faisait pas partie de l'ensemble.
+bool EditorSpriteSet::remove(EditorSprite* pSprite) {
+    auto it = m_indices.find(pSprite);
+    if (it == m_indices.end()) {
+        return false;
+    }
+
+    qsizetype index = it.value();
+    m_indices.erase(it);
+
+    EditorSprite* pLastSprite = m_sprites.takeLast();
+    if (pLastSprite != pSprite) { // On comble le trou avec le dernier sprite
+        m_sprites[index] = pLastSprite;
+        m_indices[pLastSprite] = index;
+    }
+    return true;
+}
+
+//! Vide l'ensemble.
+void EditorSpriteSet::clear() {
+    m_sprites.clear();
+    m_indices.clear();
+}
+
+//! Réserve la place pour le nombre de sprites donné.
+//! \param size Le nombre de sprites.
+void EditorSpriteSet::reserve(qsizetype size) {
+    m_sprites.reserve(size);
+    m_indices.reserve(size);
+}
@@ -0,0 +1,44 @@
+/**
+ * @file EditorSpriteSet.h
+ * @brief Déclaration de la classe EditorSpriteSet.
+ * @author Noah Blattner
+ * @date Octobre 2026
+ */
+
+#ifndef WORLDBUILDR_EDITORSPRITESET_H
+#define WORLDBUILDR_EDITORSPRITESET_H
+
+#include <QHash>
+#include <QList>
+
+class EditorSprite;
+
+//! Ensemble de sprites d'éditeur indexé : les sprites sont rangés dans une liste contiguë,
+//! et un index associe chaque sprite à sa position dans la liste.
+//! L'appartenance (contains()), l'ajout (insert()) et le retrait (remove()) se font en temps constant.
+//!
+//! Le retrait déplace le dernier sprite de la liste à la place du sprite retiré : l'ordre des sprites
+//! n'est donc pas conservé. Il ne faut pas modifier l'ensemble pendant qu'on le parcourt.
+//! La méthode toList() retourne la liste des sprites sans la copier (partage implicite de QList).
+class EditorSpriteSet {
+public:
+    bool contains(const EditorSprite* pSprite) const { return m_indices.contains(pSprite); }
+    bool insert(EditorSprite* pSprite);
+    bool remove(EditorSprite* pSprite);
+    void clear();
+    void reserve(qsizetype size);
+
+    qsizetype size() const { return m_sprites.size(); }
+    bool isEmpty() const { return m_sprites.isEmpty(); }
+
+    const QList<EditorSprite*>& toList() const { return m_sprites; }
+    QList<EditorSprite*>::const_iterator begin() const { return m_sprites.cbegin(); }
+    QList<EditorSprite*>::const_iterator end() const { return m_sprites.cend(); }
+
+private:
+    QList<EditorSprite*> m_sprites;
+    QHash<const EditorSprite*, qsizetype> m_indices; // Position de chaque sprite dans m_sprites
+};
+
+
+#endif //WORLDBUILDR_EDITORSPRITESET_H
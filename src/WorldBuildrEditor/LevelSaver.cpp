@@ -0,0 +1,127 @@
+/**
+ * @file LevelSaver.cpp
+ * @brief Définition de la classe LevelSaver.
+ * @author Noah Blattner
+ * @date Octobre 2026
+ */
+
+#include "LevelSaver.h"
+
+#include <QBuffer>
+#include <QSaveFile>
+
+#include "LevelJsonStream.h"
+#include "tracing.h"
+
+LevelSaver::LevelSaver(QObject* pParent) : QObject(pParent) {
+    m_writerPool.setMaxThreadCount(1);
+}
+
+LevelSaver::~LevelSaver() {
+    // On attend la fin des sauvegardes en cours : elles utilisent cet objet
+    waitForDone();
+}
+
+//! Planifie la sauvegarde d'un niveau. La méthode retourne immédiatement
+//! \param filePath Le chemin du fichier. Le niveau est écrit en JSON si le chemin se termine par LevelFile::JSON_EXTENSION, en binaire sinon
+//! \param level La copie du niveau à sauvegarder
+//! \param codec L'algorithme de compression du fichier, NoCodec pour ne pas le compresser
+void LevelSaver::save(const QString& filePath, const LevelData& level, LevelCompression::Codec codec) {
+    m_pendingSaves.ref();
+
+    m_writerPool.start([this, filePath, level, codec]() {
+        TRACE_SCOPE("LevelSaver::save");
+
+        QString error;
+        bool success = writeLevel(filePath, level, codec, error);
+
+        m_pendingSaves.deref();
+        emit saveFinished(filePath, success, error);
+    });
+}
+
+//! Attend la fin de toutes les sauvegardes planifiées
+void LevelSaver::waitForDone() {
+    m_writerPool.waitForDone();
+}
+
+//! Convertit et écrit un niveau. Appelée sur le fil de sauvegarde
+//! \param filePath Le chemin du fichier
+//! \param level Le niveau
+//! \param codec L'algorithme de compression
+//! \param error Reçoit la description de l'erreur
+//! \return true si le niveau a été écrit
+bool LevelSaver::writeLevel(const QString& filePath, const LevelData& level, LevelCompression::Codec codec, QString& error) {
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        error = "Impossible d'ouvrir le fichier " + filePath;
+        return false;
+    }
+
+    int lastPercent = -1;
+    reportProgress(filePath, 0, lastPercent);
+
+    bool written = true;
+    bool isJson = filePath.endsWith(LevelFile::JSON_EXTENSION);
+    if (isJson && codec == LevelCompression::NoCodec) {
+        // Les sprites sont écrits un à un : la progression suit le nombre de sprites écrits
+        LevelJsonWriter writer(&file);
+        writer.writeHeader(level);
+        for (qsizetype i = 0; i < level.sprites.size(); i++) {
+            writer.writeSprite(level.sprites[i]);
+            reportProgress(filePath, static_cast<int>(100 * i / level.sprites.size()), lastPercent);
+        }
+        written = writer.finish();
+    } else if (codec == LevelCompression::NoCodec) {
+        // Les enregistrements sont écrits par blocs : la progression suit le nombre de sprites écrits
+        written = LevelFile::writeBinary(&file, level, LevelFile::DEFAULT_CHUNK_SIZE, [&](qsizetype writtenSprites) {
+            reportProgress(filePath, static_cast<int>(100 * writtenSprites / level.sprites.size()), lastPercent);
+        });
+    } else {
+        // Niveau compressé : le fichier est construit en mémoire, car il est compressé d'un seul bloc.
+        // La conversion et la compression comptent pour la première moitié de la progression, l'écriture pour la seconde
+        QByteArray data;
+        if (isJson) { // Niveau JSON compressé : le JSON est écrit en mémoire avant d'être compressé
+            QBuffer buffer(&data);
+            buffer.open(QIODevice::WriteOnly);
+            LevelJsonWriter writer(&buffer);
+            writer.writeHeader(level);
+            for (const LevelSprite& sprite : level.sprites) {
+                writer.writeSprite(sprite);
+            }
+            writer.finish();
+        } else {
+            data = LevelFile::toBinary(level);
+        }
+        reportProgress(filePath, 25, lastPercent);
+        data = LevelCompression::compress(data, codec);
+        reportProgress(filePath, 50, lastPercent);
+
+        for (qint64 offset = 0; written && offset < data.size(); offset += WRITE_CHUNK_SIZE) {
+            qint64 chunkSize = qMin<qint64>(WRITE_CHUNK_SIZE, data.size() - offset);
+            written = file.write(data.constData() + offset, chunkSize) == chunkSize;
+            reportProgress(filePath, static_cast<int>(50 + 50 * (offset + chunkSize) / data.size()), lastPercent);
+        }
+    }
+
+    if (!written || !file.commit()) { // En cas d'échec, le fichier existant n'est pas modifié
+        file.cancelWriting();
+        error = "Impossible d'écrire le fichier " + filePath;
+        return false;
+    }
+
+    reportProgress(filePath, 100, lastPercent);
+    return true;
+}
+
+//! Signale la progression d'une sauvegarde, uniquement lorsque le pourcentage change
+//! \param filePath Le chemin du fichier
+//! \param percent La progression, en pourcents
+//! \param lastPercent La dernière progression signalée, mise à jour
+void LevelSaver::reportProgress(const QString& filePath, int percent, int& lastPercent) {
+    if (percent == lastPercent) {
+        return;
+    }
+    lastPercent = percent;
+    emit saveProgress(filePath, percent);
+}
@@ -0,0 +1,61 @@
+/**
+ * @file LevelSaver.h
+ * @brief Déclaration de la classe LevelSaver.
+ * @author Noah Blattner
+ * @date Octobre 2026
+ */
+
+#ifndef WORLDBUILDR_LEVELSAVER_H
+#define WORLDBUILDR_LEVELSAVER_H
+
+#include <QAtomicInt>
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+
+#include "LevelCompression.h"
+#include "LevelFile.h"
+
+//! Sauvegarde des niveaux sur un fil d'exécution dédié : l'interface n'est jamais bloquée par une sauvegarde.
+//!
+//! La méthode save() reçoit une copie du niveau (LevelData), prise par l'appelant sur le fil principal.
+//! Cette copie est indépendante de l'éditeur : on peut continuer à modifier le niveau pendant la sauvegarde.
+//! Le niveau est ensuite converti et écrit sur le fil de sauvegarde, au format binaire ou JSON selon l'extension
+//! du fichier. L'écriture passe par un fichier temporaire (QSaveFile) : en cas d'échec, le fichier existant
+//! n'est pas modifié.
+//! Le fichier est compressé si un algorithme de compression est choisi (voir LevelCompression).
+//!
+//! Mémoire : la copie du niveau est conservée jusqu'à la fin de sa sauvegarde. Sans compression, le fichier est écrit
+//! au fil de la conversion (LevelJsonWriter, LevelFile::writeBinary()) et n'est jamais entièrement en mémoire.
+//! Un niveau compressé est en revanche construit entièrement en mémoire avant sa compression, qui traite un seul bloc :
+//! sa sauvegarde demande, en plus de la copie, la taille du fichier non compressé et celle du fichier compressé.
+//!
+//! Les sauvegardes sont effectuées dans l'ordre de leurs demandes. Leur progression et leur fin sont
+//! signalées par saveProgress() et saveFinished(), reçus sur le fil principal.
+class LevelSaver : public QObject {
+    Q_OBJECT
+
+public:
+    explicit LevelSaver(QObject* pParent = nullptr);
+    ~LevelSaver() override;
+
+    void save(const QString& filePath, const LevelData& level, LevelCompression::Codec codec = LevelCompression::NoCodec);
+    bool isSaving() const { return m_pendingSaves.loadAcquire() > 0; }
+    void waitForDone();
+
+signals:
+    void saveProgress(const QString& filePath, int percent);
+    void saveFinished(const QString& filePath, bool success, const QString& error);
+
+private:
+    bool writeLevel(const QString& filePath, const LevelData& level, LevelCompression::Codec codec, QString& error);
+    void reportProgress(const QString& filePath, int percent, int& lastPercent);
+
+    static constexpr qint64 WRITE_CHUNK_SIZE = 1024 * 1024; // Taille des blocs écrits entre deux signalements de progression
+
+    QThreadPool m_writerPool; // Un seul fil : les sauvegardes sont écrites dans l'ordre
+    QAtomicInt m_pendingSaves = 0;
+};
+
+
+#endif //WORLDBUILDR_LEVELSAVER_H
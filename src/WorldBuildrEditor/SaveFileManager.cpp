@@ -7,22 +7,50 @@
 #include <QDir>
 #include <QFileDialog>
 #include <QFile>
-#include <QJsonObject>
-#include <QJsonArray>
-#include <QJsonDocument>
+#include <QUuid>
 
 #include "resources.h"
+#include "tracing.h"
 #include "EditorSprite.h"
 #include "EditorManager.h"
+#include "LevelFile.h"
+#include "LevelSaver.h"
 #include "SaveFileManager.h"
 #include "TagsManager.h"
+#include "TextureLoader.h"
 
 const QString SaveFileManager::DEFAULT_SAVE_DIR = GameFramework::resourcesPath() + "saves";
+const QString SaveFileManager::FILE_DIALOG_FILTER = "Niveau WorldBuildr (*.wbl);;JSON (*.json)";
+const QString SaveFileManager::SAVE_DIALOG_FILTER = "Niveau WorldBuildr (*.wbl);;"
+                                                   "Niveau WorldBuildr compressé LZ4 (*.wbl);;"
+                                                   "Niveau WorldBuildr compressé zlib (*.wbl);;"
+                                                   "JSON (*.json);;"
+                                                   "JSON compressé LZ4 (*.json);;"
+                                                   "JSON compressé zlib (*.json)";
+
+//! Retourne l'algorithme de compression correspondant au filtre choisi dans la boîte de dialogue de sauvegarde
+//! \param selectedFilter Le filtre choisi, parmi ceux de SAVE_DIALOG_FILTER
+LevelCompression::Codec SaveFileManager::codecFromDialogFilter(const QString& selectedFilter) {
+    if (selectedFilter.contains(LevelCompression::codecName(LevelCompression::Lz4Codec))) {
+        return LevelCompression::Lz4Codec;
+    }
+    if (selectedFilter.contains(LevelCompression::codecName(LevelCompression::ZlibCodec))) {
+        return LevelCompression::ZlibCodec;
+    }
+    return LevelCompression::NoCodec;
+}
 
-//! Sauvegarde l'état actuel de l'éditeur dans un fichier JSON
+//! Sauvegarde l'état actuel de l'éditeur dans un fichier de niveau.
+//! Le format est choisi selon l'extension : JSON pour LevelFile::JSON_EXTENSION, binaire sinon.
+//! Le fichier est ensuite compressé si un algorithme de compression est choisi.
+//! Une copie du niveau est prise immédiatement ; sa conversion et son écriture ont lieu sur le fil de sauvegarde
+//! de l'éditeur (voir LevelSaver). On peut donc continuer à modifier le niveau pendant la sauvegarde.
 //! \param editorManager L'éditeur à sauvegarder
 //! \param savePath Le chemin du fichier de sauvegarde
-void SaveFileManager::save(EditorManager *editorManager, QString savePath) {
+//! \param codec L'algorithme de compression du fichier. Si le chemin est demandé à l'utilisateur, il est choisi avec le filtre
+void SaveFileManager::save(EditorManager *editorManager, QString savePath, LevelCompression::Codec codec) {
+    TRACE_SCOPE("SaveFileManager::save");
+
     // Création du dossier de sauvegarde s'il n'existe pas
     QDir dir(DEFAULT_SAVE_DIR);
     if (!dir.exists()) {
@@ -31,153 +59,189 @@ void SaveFileManager::save(EditorManager *editorManager, QString savePath) {
 
     if (savePath.isEmpty()) { // Si le chemin est vide
         // On demande à l'utilisateur de choisir un chemin de sauvegarde (avec un nom de fichier par défaut)
-        savePath = QFileDialog::getSaveFileName(nullptr, "Sauvegarder sous", DEFAULT_SAVE_DIR, "JSON file (*.json)");
+        QString selectedFilter;
+        savePath = QFileDialog::getSaveFileName(nullptr, "Sauvegarder sous", DEFAULT_SAVE_DIR, SAVE_DIALOG_FILTER, &selectedFilter);
         if (savePath.isEmpty()) { // Si le chemin est toujours vide, on annule
             return;
         }
+        codec = codecFromDialogFilter(selectedFilter);
     }
 
-    if (!savePath.endsWith(".json")) { // Si le chemin ne finit pas par .json on l'ajoute
-        savePath += ".json";
+    // Si le chemin n'a pas d'extension de niveau, on utilise le format binaire
+    if (!savePath.endsWith(LevelFile::BINARY_EXTENSION) && !savePath.endsWith(LevelFile::JSON_EXTENSION)) {
+        savePath += LevelFile::BINARY_EXTENSION;
     }
 
-    // On sauvegarde le fichier (on remplace le fichier s'il existe déjà)
-    QFile file(savePath);
-    if (!file.open(QIODevice::WriteOnly)) {
-        QMessageBox::critical(nullptr, "Erreur", "Impossible d'ouvrir le fichier " + savePath);
-        return;
-    }
+    // On copie le niveau, avec un jeton qui permettra de retrouver l'historique correspondant dans le journal
+    LevelData level = convertEditorToLevel(editorManager);
+    level.historyToken = QUuid::createUuid().toString(QUuid::WithoutBraces);
+
+    // On conserve l'historique dans le journal du niveau. Le jeton est associé à l'état copié,
+    // et non à l'état qu'aura l'éditeur à la fin de l'écriture
+    editorManager->markHistorySaved(savePath, level.historyToken);
 
-    // On écrit le fichier
-    QJsonObject json = convertEditorToJsonObject(editorManager);
-    file.write(QJsonDocument(json).toJson());
-    file.close();
+    // On écrit le fichier sur le fil de sauvegarde (on remplace le fichier s'il existe déjà)
+    editorManager->getLevelSaver()->save(savePath, level, codec);
 }
 
-//! Charge un fichier JSON dans l'éditeur. Ceci remplace l'état actuel de l'éditeur.
+//! Charge un fichier de niveau dans l'éditeur. Ceci remplace l'état actuel de l'éditeur.
 //! \param editorManager L'éditeur dans lequel charger le fichier
 //! \param saveFilePath Le chemin du fichier à charger
 void SaveFileManager::load(EditorManager *editorManager, QString saveFilePath) {
+    TRACE_SCOPE("SaveFileManager::load");
 
-    // On charge le JSON depuis le fichier
-    QJsonDocument json = loadJsonDocument(saveFilePath);
-
-    if (json.isEmpty()) { // Si le JSON est vide, on annule
+    // On lit le niveau depuis le fichier
+    LevelData level;
+    if (!readLevelFile(saveFilePath, level)) { // Si le fichier n'a pas pu être lu, on annule
         return;
     }
 
+    // On remplace l'état de l'éditeur par le niveau
+    restoreLevel(editorManager, level);
+
+    // On restaure l'historique du niveau depuis son journal
+    editorManager->restoreHistory(saveFilePath, level.historyToken);
+}
+
+//! Remplace l'état actuel de l'éditeur par un niveau. Les sprites conservent leurs identifiants
+//! \param editorManager L'éditeur dans lequel charger le niveau
+//! \param level Le niveau à charger
+void SaveFileManager::restoreLevel(EditorManager* editorManager, const LevelData& level) {
     editorManager->resetEditor(); // On vide l'éditeur
 
-    // On charge le JSON dans l'éditeur
-    loadJsonIntoEditor(editorManager, json.object());
+    // On charge le niveau dans l'éditeur, en conservant les identifiants des sprites (utilisés par le journal de l'historique)
+    loadLevelIntoEditor(editorManager, level, true);
 
     // On charge le fond
-    QString backgroundPath = QDir::toNativeSeparators(json.object()["background"].toString());
+    QString backgroundPath = QDir::toNativeSeparators(level.background);
     if (!backgroundPath.isEmpty()) {
         editorManager->setBackGroundImage( GameFramework::resourcesPath() + backgroundPath);
     }
 }
 
-//! Importe un fichier JSON dans l'éditeur. Ceci ajoute les sprites du fichier à l'état actuel de l'éditeur.
+//! Importe un fichier de niveau dans l'éditeur. Ceci ajoute les sprites du fichier à l'état actuel de l'éditeur.
 //! \param editorManager L'éditeur dans lequel importer le fichier
 //! \param importFilePath Le chemin du fichier à importer
 void SaveFileManager::import(EditorManager *editorManager, QString importFilePath) {
+    TRACE_SCOPE("SaveFileManager::import");
 
-    // On charge le JSON depuis le fichier
-    QJsonDocument json = loadJsonDocument(importFilePath);
-
-    if (json.isEmpty()) { // Si le JSON est vide, on annule
+    // On lit le niveau depuis le fichier
+    LevelData level;
+    if (!readLevelFile(importFilePath, level)) { // Si le fichier n'a pas pu être lu, on annule
         return;
     }
 
-    // On importe le JSON dans l'éditeur
-    loadJsonIntoEditor(editorManager, json.object());
+    // On importe le niveau dans l'éditeur. Les sprites importés reçoivent de nouveaux identifiants
+    loadLevelIntoEditor(editorManager, level, false);
 }
 
-//! Charge le données depuis un fichier JSON vers un objet QJsonDocument
-//! \param saveFilePath Le chemin du fichier à charger
-//! \return L'objet QJsonDocument contenant les données du fichier
-QJsonDocument SaveFileManager::loadJsonDocument(QString saveFilePath) {
+//! Lit un fichier de niveau, au format binaire ou JSON
+//! \param saveFilePath Le chemin du fichier à charger. Reçoit le chemin choisi par l'utilisateur si le fichier n'existe pas
+//! \param level Reçoit le contenu du niveau
+//! \return true si le fichier a pu être lu
+bool SaveFileManager::readLevelFile(QString& saveFilePath, LevelData& level) {
     if (saveFilePath.isEmpty() || !QFile::exists(saveFilePath)) { // Si le chemin est vide ou que le fichier n'existe pas
-        // On demande à l'utilisateur de choisir un chemin de sauvegarde (avec un nom de fichier par défaut)
-        saveFilePath = QFileDialog::getOpenFileName(nullptr, "Ouvrir", DEFAULT_SAVE_DIR, "JSON file (*.json)");
+        // On demande à l'utilisateur de choisir un fichier (avec un nom de fichier par défaut)
+        saveFilePath = QFileDialog::getOpenFileName(nullptr, "Ouvrir", DEFAULT_SAVE_DIR, FILE_DIALOG_FILTER);
         if (saveFilePath.isEmpty()) { // Si le chemin est toujours vide, on annule
-            return {};
+            return false;
         }
     }
 
-    // On ouvre le fichier
-    QFile file(saveFilePath);
-    if (!file.open(QIODevice::ReadOnly)) { // Si le fichier ne peut pas être ouvert
+    QString error;
+    if (!LevelFile::readFile(saveFilePath, level, &error)) { // Si le fichier ne peut pas être lu
         // On affiche une erreur
-        QMessageBox::critical(nullptr, "Erreur", "Impossible d'ouvrir le fichier " + saveFilePath);
-        return {};
+        QMessageBox::critical(nullptr, "Erreur", error);
+        return false;
     }
 
-    // On lit le JSON depuis le fichier
-    QJsonDocument json = QJsonDocument::fromJson(file.readAll());
-
-    // On ferme le fichier
-    file.close();
-
-    return json;
+    return true;
 }
 
 /*****************
- * Conversions JSON -> Editeur et Editeur -> JSON
+ * Conversions Niveau -> Editeur et Editeur -> Niveau
  *****************/
 
-//! Convertit l'éditeur en objet JSON
+//! Convertit l'éditeur en niveau. Le niveau obtenu est une copie, indépendante de l'éditeur
 //! \param editorManager L'éditeur à convertir
-QJsonObject SaveFileManager::convertEditorToJsonObject(EditorManager* editorManager) {
-    QJsonObject json;
-    json["tags"] = convertTagsToJsonArray(TagsManager::getTags());
-    json["sceneWidth"] = editorManager->getSceneSize().width();
-    json["sceneHeight"] = editorManager->getSceneSize().height();
-    json["background"] = QDir::toNativeSeparators(editorManager->getBackgroundImagePath()).remove(QDir::toNativeSeparators(GameFramework::resourcesPath()));
-    json["sprites"] = convertSpritesToJsonArray(editorManager -> getEditorSprites());
-    return json;
-}
+LevelData SaveFileManager::convertEditorToLevel(EditorManager* editorManager) {
+    // Les chemins sont enregistrés relativement au dossier des ressources
+    const QString resourcesPath = QDir::toNativeSeparators(GameFramework::resourcesPath());
 
-//! Convertit les tags en tableau JSON
-QJsonArray SaveFileManager::convertTagsToJsonArray(const QList<QString> &tags) {
-    QJsonArray json;
-    for (const QString& tag : tags) {
-        json.append(tag);
-    }
-    return json;
-}
+    LevelData level = convertEditorToLevelHeader(editorManager);
+
+    // Table des textures du niveau. Le chemin de chaque image n'est converti qu'une fois, et non pour chaque sprite
+    LevelTextureTable textureTable;
+    QHash<QString, qint32> imageTextures; // Index dans la table des textures, par chemin d'image de l'éditeur
 
-//! Convertit une liste de sprites en tableau JSON
-//! \param sprites La liste de sprites à convertir
-QJsonArray SaveFileManager::convertSpritesToJsonArray(const QList<EditorSprite *>& sprites) {
-    QJsonArray json;
-    qDebug() << QDir::toNativeSeparators(DEFAULT_SAVE_DIR);
+    const QList<EditorSprite*> sprites = editorManager->getEditorSprites();
+    level.sprites.reserve(sprites.size());
     for (EditorSprite *sprite : sprites) { // Pour chaque sprite
-        QJsonObject spriteJson;
-        spriteJson["x"] = sprite->x();
-        spriteJson["y"] = sprite->y();
-        spriteJson["scale"] = sprite->scale();
-        spriteJson["texturePath"] = QDir::toNativeSeparators(sprite->getImgPath()).remove(QDir::toNativeSeparators(GameFramework::resourcesPath()));
-        spriteJson["rotation"] = sprite->rotation();
-        spriteJson["tag"] = sprite->getTag();
-        json.append(spriteJson);
+        const QString imagePath = sprite->getImgPath();
+        auto it = imageTextures.constFind(imagePath);
+        if (it == imageTextures.constEnd()) { // Première utilisation de l'image
+            it = imageTextures.insert(imagePath, textureTable.indexOf(QDir::toNativeSeparators(imagePath).remove(resourcesPath)));
+        }
+        level.sprites.append(convertSpriteToLevel(sprite, textureTable.textures()[it.value()], it.value()));
     }
-    return json;
+    level.textures = textureTable.textures();
+    return level;
 }
 
-//! Charge un fichier JSON et charge son contenu dans un éditeur. Ceci remplace l'état actuel de l'éditeur.
-//! \param editorManager L'éditeur dans lequel charger le fichier
-//! \param path Le chemin du fichier à charger
-void SaveFileManager::loadJsonIntoEditor(EditorManager *editorManager, QJsonObject jsonObject) {
+//! Convertit les champs de l'éditeur, à l'exception des sprites, en niveau
+//! \param editorManager L'éditeur à convertir
+LevelData SaveFileManager::convertEditorToLevelHeader(EditorManager* editorManager) {
+    // Les chemins sont enregistrés relativement au dossier des ressources
+    const QString resourcesPath = QDir::toNativeSeparators(GameFramework::resourcesPath());
+
+    LevelData level;
+    level.tags = TagsManager::getTags();
+    level.sceneSize = editorManager->getSceneSize();
+    level.background = QDir::toNativeSeparators(editorManager->getBackgroundImagePath()).remove(resourcesPath);
+    return level;
+}
+
+//! Convertit un sprite d'éditeur en sprite de niveau
+//! \param sprite Le sprite à convertir
+//! \param resourcesPath Le dossier des ressources, par rapport auquel le chemin de la texture est enregistré
+LevelSprite SaveFileManager::convertSpriteToLevel(EditorSprite* sprite, const QString& resourcesPath) {
+    return convertSpriteToLevel(sprite, QDir::toNativeSeparators(sprite->getImgPath()).remove(resourcesPath), -1);
+}
+
+//! Convertit un sprite d'éditeur en sprite de niveau, dont la texture est déjà connue
+//! \param sprite Le sprite à convertir
+//! \param texturePath Le chemin de la texture, relatif au dossier des ressources
+//! \param textureIndex L'index de la texture dans la table des textures du niveau, -1 s'il n'est pas connu
+LevelSprite SaveFileManager::convertSpriteToLevel(EditorSprite* sprite, const QString& texturePath, qint32 textureIndex) {
+    LevelSprite levelSprite;
+    levelSprite.id = sprite->getId();
+    levelSprite.texturePath = texturePath;
+    levelSprite.textureIndex = textureIndex;
+    levelSprite.tag = sprite->getTag();
+    levelSprite.x = sprite->x();
+    levelSprite.y = sprite->y();
+    levelSprite.rotation = sprite->rotation();
+    levelSprite.scale = sprite->scale();
+    levelSprite.opacity = sprite->opacity();
+    levelSprite.z = sprite->zValue();
+    return levelSprite;
+}
+
+//! Charge un niveau dans un éditeur. Les sprites du niveau sont ajoutés à ceux de l'éditeur.
+//! \param editorManager L'éditeur dans lequel charger le niveau
+//! \param level Le niveau à charger
+//! \param keepSpriteIds Si vrai, les sprites reprennent les identifiants enregistrés dans le niveau
+void SaveFileManager::loadLevelIntoEditor(EditorManager *editorManager, const LevelData& level, bool keepSpriteIds) {
     // On charge les tags
-    loadTagsFromJson(jsonObject["tags"].toArray());
+    for (const QString& tag : level.tags) {
+        TagsManager::addTag(tag);
+    }
 
     // On charge la taille de la scène
-    editorManager->setSceneSize(QSize(jsonObject["sceneWidth"].toInt(), jsonObject["sceneHeight"].toInt()));
+    editorManager->setSceneSize(level.sceneSize);
 
     // On charge les sprites
-    QList<EditorSprite*> sprites = loadSpritesFromJson(jsonObject["sprites"] . toArray());
+    QList<EditorSprite*> sprites = loadSpritesFromLevel(level, keepSpriteIds);
     for (EditorSprite* sprite : sprites) {
         editorManager->addEditorSprite(sprite);
     }
@@ -186,29 +250,57 @@ void SaveFileManager::loadJsonIntoEditor(EditorManager *editorManager, QJsonObje
     editorManager->resetHistory();
 }
 
-//! Charge les tags depuis un tableau JSON
-//! \param jsonArray Le tableau JSON à convertir
-void SaveFileManager::loadTagsFromJson(const QJsonArray &jsonArray) {
-    // On charge les tags
-    for (QJsonValue jsonValue : jsonArray) { // Pour chaque tag
-        TagsManager::addTag(jsonValue.toString());
+//! Crée les sprites d'éditeur d'un niveau
+//! Les textures sont d'abord décodées en parallèle (TextureLoader), chacune une seule fois ;
+//! les sprites sont ensuite créés à partir des textures décodées
+//! \param level Le niveau
+//! \param keepSpriteIds Si vrai, les sprites reprennent les identifiants enregistrés dans le niveau
+QList<EditorSprite*> SaveFileManager::loadSpritesFromLevel(const LevelData& level, bool keepSpriteIds) {
+    TRACE_SCOPE("SaveFileManager::loadSpritesFromLevel");
+
+    const QString resourcesPath = GameFramework::resourcesPath();
+
+    // Première passe : on demande le décodage de chaque texture utilisée. Les sprites font référence à la table
+    // des textures : le chemin de chaque texture n'est construit qu'une fois, à sa première utilisation
+    TextureLoader textureLoader;
+    QVector<int> textureIndices(level.textures.size(), -1); // Index de chaque texture dans le chargeur, par index dans la table
+    QStringList texturePaths(level.textures.size()); // Chemin complet de chaque texture, par index dans la table
+    QVector<int> spriteTextures;
+    spriteTextures.reserve(level.sprites.size());
+    for (const LevelSprite& levelSprite : level.sprites) {
+        if (levelSprite.textureIndex < 0 || levelSprite.textureIndex >= level.textures.size()) { // Sprite hors de la table
+            spriteTextures.append(textureLoader.request(QDir::toNativeSeparators(resourcesPath + levelSprite.texturePath)));
+            continue;
+        }
+        int& textureIndex = textureIndices[levelSprite.textureIndex];
+        if (textureIndex < 0) { // Première utilisation de la texture
+            texturePaths[levelSprite.textureIndex] = QDir::toNativeSeparators(resourcesPath + levelSprite.texturePath);
+            textureIndex = textureLoader.request(texturePaths[levelSprite.textureIndex]);
+        }
+        spriteTextures.append(textureIndex);
     }
-}
+    textureLoader.waitForDone();
 
-//! Convertit un tableau JSON en liste de sprites d'éditeur
-//! \param jsonArray Le tableau JSON à convertir
-QList<EditorSprite*> SaveFileManager::loadSpritesFromJson(const QJsonArray& jsonArray) {
+    // Seconde passe : on crée les sprites à partir des textures décodées
     QList<EditorSprite*> sprites;
-    for (QJsonValue jsonValue: jsonArray) { // Pour chaque sprite
-        QJsonObject spriteJson = jsonValue . toObject();
-        auto* sprite = new EditorSprite(
-                QDir::toNativeSeparators(GameFramework::resourcesPath() + jsonValue["texturePath"] . toString()));
-        sprite -> setX(spriteJson["x"] . toDouble());
-        sprite -> setY(spriteJson["y"] . toDouble());
-        sprite -> setRotation(spriteJson["rotation"] . toInt());
-        sprite -> setScale(spriteJson["scale"] . toDouble());
-        sprite -> setTag(spriteJson["tag"] . toString());
+    sprites.reserve(level.sprites.size());
+    for (qsizetype i = 0; i < level.sprites.size(); i++) { // Pour chaque sprite
+        const LevelSprite& levelSprite = level.sprites[i];
+        bool isIndexed = levelSprite.textureIndex >= 0 && levelSprite.textureIndex < level.textures.size();
+        QString imagePath = isIndexed ? texturePaths[levelSprite.textureIndex]
+                                      : QDir::toNativeSeparators(resourcesPath + levelSprite.texturePath);
+        auto* sprite = new EditorSprite(textureLoader.pixmap(spriteTextures[i]), imagePath);
+        sprite -> setX(levelSprite.x);
+        sprite -> setY(levelSprite.y);
+        sprite -> setRotation(levelSprite.rotation);
+        sprite -> setScale(levelSprite.scale);
+        sprite -> setOpacity(levelSprite.opacity);
+        sprite -> setZValue(levelSprite.z);
+        sprite -> setTag(levelSprite.tag);
+        if (keepSpriteIds && levelSprite.id != 0) { // 0 : le fichier ne contient pas d'identifiant
+            sprite -> setId(levelSprite.id);
+        }
         sprites . append(sprite);
     }
     return sprites;
-}
\ No newline at end of file
+}
@@ -8,9 +8,15 @@
 #ifndef WORLDBUILDR_SAVEFILEMANAGER_H
 #define WORLDBUILDR_SAVEFILEMANAGER_H
 
+#include <QList>
+
+#include "LevelCompression.h"
+
 class QString;
 class EditorManager;
-class QJsonObject;
+class EditorSprite;
+struct LevelData;
+struct LevelSprite;
 
 /**
  * @brief Gestionnaire de sauvegarde.
@@ -22,28 +28,45 @@ class QJsonObject;
  * save() permet de sauvegarder un niveau dans un fichier.
  * load() permet de charger un niveau à partir d'un fichier. (Les sprites générés remplacent les sprites actuels)
  * import() permet d'importer un niveau à partir d'un fichier. (Les sprites générés sont ajoutés aux sprites actuels)
+ * restoreLevel() remplace l'état de l'éditeur par un niveau déjà lu, par exemple une sauvegarde automatique.
  * Ces 3 fonctions nécessitent un EditorManager et un chemin de sauvegarde.
  * Si le chemin de sauvegarde est vide, le fichier sera sauvegardé dans le dossier par défaut.
+ *
+ * Les niveaux sont enregistrés au format binaire (.wbl) par défaut, ou au format JSON (.json) si le chemin
+ * se termine par cette extension. Le chargement reconnaît les deux formats (voir LevelFile).
+ * Les fichiers JSON sont écrits et lus au fil de l'eau (voir LevelJsonWriter et LevelJsonReader).
+ * Les deux formats peuvent être compressés (zlib ou LZ4, voir LevelCompression) : l'algorithme est choisi
+ * avec le filtre de la boîte de dialogue de sauvegarde (SAVE_DIALOG_FILTER) et reconnu au chargement.
+ * La sauvegarde est écrite sur un fil d'exécution dédié, à partir d'une copie du niveau (voir LevelSaver).
+ *
+ * Chaque sauvegarde écrit un jeton unique (historyToken) et les identifiants des sprites. Au chargement,
+ * ils permettent de restaurer l'historique du niveau depuis son journal (voir EditorJournal).
  */
 class SaveFileManager {
 public:
 
     static const QString DEFAULT_SAVE_DIR;
+    static const QString FILE_DIALOG_FILTER;
+    static const QString SAVE_DIALOG_FILTER;
+
+    static LevelCompression::Codec codecFromDialogFilter(const QString& selectedFilter);
 
-    static void save(EditorManager *editorManager, QString savePath);
+    static void save(EditorManager *editorManager, QString savePath, LevelCompression::Codec codec = LevelCompression::NoCodec);
     static void load(EditorManager *editorManager, QString saveFilePath);
     static void import(EditorManager *editorManager, QString saveFilePath);
+    static void restoreLevel(EditorManager* editorManager, const LevelData& level);
+
+    static LevelData convertEditorToLevel(EditorManager* editorManager);
+    static LevelData convertEditorToLevelHeader(EditorManager* editorManager);
+    static LevelSprite convertSpriteToLevel(EditorSprite* sprite, const QString& resourcesPath);
 
 private:
-    static QJsonDocument loadJsonDocument(QString saveFilePath);
+    static bool readLevelFile(QString& saveFilePath, LevelData& level);
 
-    static QJsonObject convertEditorToJsonObject(EditorManager* editorManager);
-    static QJsonArray convertTagsToJsonArray(const QList<QString>& tags);
-    static QJsonArray convertSpritesToJsonArray(const QList<EditorSprite*>& sprites);
+    static LevelSprite convertSpriteToLevel(EditorSprite* sprite, const QString& texturePath, qint32 textureIndex);
 
-    static void loadJsonIntoEditor(EditorManager* editorManager, QJsonObject jsonObject);
-    static void loadTagsFromJson(const QJsonArray& jsonArray);
-    static QList<EditorSprite*> loadSpritesFromJson(const QJsonArray& jsonArray);
+    static void loadLevelIntoEditor(EditorManager* editorManager, const LevelData& level, bool keepSpriteIds);
+    static QList<EditorSprite*> loadSpritesFromLevel(const LevelData& level, bool keepSpriteIds);
 };
 
 
@@ -56,6 +56,9 @@ GameCore::GameCore(GameCanvas* pGameCanvas, QObject* pParent) : QObject(pParent)
     m_pActionPanel->bindEditorManager(m_pEditorManager);
     m_pSpriteDetailsPanel->bindEditorManager(m_pEditorManager);
 
+    // Propose de restaurer la sauvegarde automatique si l'éditeur n'a pas été fermé correctement
+    m_pEditorManager->recoverAutoSave();
+
     // Démarre le tick pour que les animations qui en dépendent fonctionnent correctement.
     // Attention : il est important que l'enclenchement du tick soit fait vers la fin de cette fonction,
     // sinon le temps passé jusqu'au premier tick (ElapsedTime) peut être élevé et provoquer de gros
@@ -13,6 +13,7 @@
 #include <QPushButton>
 #include <QCheckBox>
 #include <QLabel>
+#include <QSlider>
 #include <QSpinBox>
 #include <QVBoxLayout>
 #include <QFileDialog>
@@ -33,6 +34,14 @@ EditorActionPanel::EditorActionPanel(QWidget* pParent) : QWidget(pParent){
 //! \param editorManager Le manager d'éditeur à lier à l'UI
 void EditorActionPanel::bindEditorManager(EditorManager *editorManager) {
     m_pEditorManager = editorManager;
+
+    // La frise de l'historique suit l'état de l'historique
+    connect(m_pEditorManager, &EditorManager::historyChanged, this, &EditorActionPanel::onHistoryChanged);
+    onHistoryChanged(m_pEditorManager->historyIndex(), m_pEditorManager->historyCount());
+
+    // Le bouton de sauvegarde affiche la progression des sauvegardes en cours
+    connect(m_pEditorManager, &EditorManager::saveProgress, this, &EditorActionPanel::onSaveProgress);
+    connect(m_pEditorManager, &EditorManager::saveFinished, this, &EditorActionPanel::onSaveFinished);
 }
 
 /*********************
@@ -49,6 +58,8 @@ void EditorActionPanel::initLayout() {
     auto* layoutActionsHistorique = new QVBoxLayout();
     layoutActionsHistorique->addWidget(undoButton);
     layoutActionsHistorique->addWidget(redoButton);
+    layoutActionsHistorique->addWidget(historySlider);
+    layoutActionsHistorique->addWidget(historyPositionLabel);
 
     auto* layoutActionsSelection = new QVBoxLayout();
     layoutActionsSelection->addWidget(selectAllButton);
@@ -132,6 +143,14 @@ void EditorActionPanel::initInputs() {
     redoButton->setToolTip("Rétablir la dernière action annulée");
     redoButton->setStyleSheet(GameFramework::loadStyleSheetString("buttonStyle.qss"));
 
+    // Création de la frise de l'historique
+    historySlider = new QSlider(Qt::Horizontal);
+    historySlider->setToolTip("Parcourir l'historique");
+    historySlider->setRange(0, 0);
+    historySlider->setEnabled(false);
+    historyPositionLabel = new QLabel("0 / 0");
+    historyPositionLabel->setAlignment(Qt::AlignCenter);
+
     // Création d'un bouton de sélection de tous les sprites
     selectAllButton = new QPushButton(QIcon(GameFramework::imagesPath() + "icons/selectAllIcon.png"), "Sélectionner tous les sprites");
     selectAllButton->setToolTip("Sélectionner tous les sprites");
@@ -202,6 +221,7 @@ void EditorActionPanel::connectSignals() const {
     connect(removeButton, &QPushButton::clicked, this, &EditorActionPanel::deleteButtonClicked);
     connect(undoButton, &QPushButton::clicked, this, &EditorActionPanel::undoButtonClicked);
     connect(redoButton, &QPushButton::clicked, this, &EditorActionPanel::redoButtonClicked);
+    connect(historySlider, &QSlider::valueChanged, this, &EditorActionPanel::historySliderValueChanged);
     connect(selectAllButton, &QPushButton::clicked, this, &EditorActionPanel::selectAllButtonClicked);
     connect(deselectAllButton, &QPushButton::clicked, this, &EditorActionPanel::deselectAllSprites);
     connect(duplicateButton, &QPushButton::clicked, this, &EditorActionPanel::duplicateButtonClicked);
@@ -221,6 +241,23 @@ void EditorActionPanel::saveButtonClicked() {
     m_pEditorManager->save("");
 }
 
+//! Slot appelé lors de la progression d'une sauvegarde
+//! \param filePath Le chemin du fichier sauvegardé
+//! \param percent La progression, en pourcents
+void EditorActionPanel::onSaveProgress(const QString& filePath, int percent) {
+    Q_UNUSED(filePath);
+    saveButton->setText(QString("Sauvegarde... %1 %").arg(percent));
+}
+
+//! Slot appelé à la fin d'une sauvegarde
+//! \param filePath Le chemin du fichier sauvegardé
+//! \param success Indique si la sauvegarde a réussi
+void EditorActionPanel::onSaveFinished(const QString& filePath, bool success) {
+    Q_UNUSED(filePath);
+    Q_UNUSED(success);
+    saveButton->setText("Sauvegarder");
+}
+
 //! Slot appelé lors du clic sur le bouton de chargement
 void EditorActionPanel::loadButtonClicked() {
     m_pEditorManager->load("");
@@ -254,6 +291,26 @@ void EditorActionPanel::redoButtonClicked() {
     m_pEditorManager->redo();
 }
 
+//! Slot appelé lors du déplacement de la frise de l'historique
+//! \param value Le nombre d'actions effectuées dans l'état à atteindre
+void EditorActionPanel::historySliderValueChanged(int value) {
+    m_pEditorManager->jumpToHistoryIndex(value - 1);
+}
+
+//! Slot appelé lors de la modification de l'historique : met à jour la frise
+//! \param currentIndex L'index de la dernière action effectuée, -1 si aucune
+//! \param commandCount Le nombre d'actions de l'historique
+void EditorActionPanel::onHistoryChanged(int currentIndex, int commandCount) {
+    // On ne déclenche pas de déplacement dans l'historique en mettant à jour la frise
+    historySlider->blockSignals(true);
+    historySlider->setRange(0, commandCount);
+    historySlider->setValue(currentIndex + 1);
+    historySlider->blockSignals(false);
+    historySlider->setEnabled(commandCount > 0);
+
+    historyPositionLabel->setText(QString("%1 / %2").arg(currentIndex + 1).arg(commandCount));
+}
+
 //! Slot appelé lors du clic sur le bouton de sélection de tous les sprites
 void EditorActionPanel::selectAllButtonClicked() {
     // Sélectionner tous les sprites
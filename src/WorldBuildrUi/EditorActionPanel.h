@@ -15,6 +15,8 @@
 class EditorManager;
 class QPushButton;
 class QCheckBox;
+class QLabel;
+class QSlider;
 class QSpinBox;
 
 //! Classe affichant le panneau d'actions de l'éditeur.
@@ -22,6 +24,9 @@ class QSpinBox;
 //! Elle est automatiquement instanciée par l'MainFrm.
 //!
 //! Après la création, il faut lier un éditeur avec la méthode bindEditorManager().
+//!
+//! Le groupe "Historique" contient une frise : une glissière qui permet de parcourir directement
+//! les états de l'historique de l'éditeur.
 class EditorActionPanel : public QWidget {
 public:
     explicit EditorActionPanel(QWidget* pParent = nullptr);
@@ -45,6 +50,8 @@ private:
 
     QPushButton* undoButton;
     QPushButton* redoButton;
+    QSlider* historySlider;
+    QLabel* historyPositionLabel;
 
     QPushButton* selectAllButton;
     QPushButton* deselectAllButton;
@@ -69,12 +76,16 @@ private slots:
     void deleteButtonClicked();
     void undoButtonClicked();
     void redoButtonClicked();
+    void historySliderValueChanged(int value);
+    void onHistoryChanged(int currentIndex, int commandCount);
     void selectAllButtonClicked();
     void deselectAllSprites();
     void duplicateButtonClicked();
     void addBackgroundButtonClicked();
     void removeBackgroundButtonClicked();
     void saveButtonClicked();
+    void onSaveProgress(const QString& filePath, int percent);
+    void onSaveFinished(const QString& filePath, bool success);
     void loadButtonClicked();
     void importButtonClicked();
 };
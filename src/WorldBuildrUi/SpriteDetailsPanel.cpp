@@ -41,6 +41,8 @@ void SpriteDetailsPanel::bindEditorManager(EditorManager *pEditorManager) {
     // Connecte les signaux du gestionnaire d'éditeur aux slots du panneau de détails
     connect(m_pEditorManager, &EditorManager::editorSpriteSelected, this,
             &SpriteDetailsPanel::onBindSprite);
+    connect(m_pEditorManager, &EditorManager::selectionChanged, this,
+            &SpriteDetailsPanel::onSelectionChanged);
     connect(m_pEditorManager, &EditorManager::editorSpriteDeleted, this,
             &SpriteDetailsPanel::onUnbindSprite);
 }
@@ -63,6 +65,16 @@ void SpriteDetailsPanel::onBindSprite(EditorSprite *sprite) {
     updatePanel();
 }
 
+//! Appelé lorsque la sélection a été modifiée en bloc : lie le dernier sprite sélectionné.
+void SpriteDetailsPanel::onSelectionChanged(const QList<EditorSprite*>& selectedSprites) {
+    if (selectedSprites.isEmpty()) { // Si plus aucun sprite n'est sélectionné
+        onUnbindSprite();
+        return;
+    }
+
+    onBindSprite(selectedSprites.last());
+}
+
 //! Connecte les signaux du sprite au panneau de détails.
 void SpriteDetailsPanel::connectSpriteSignals() const {// Connecter les signaux de modification du sprite
     connect(m_pSprite, &EditorSprite::editorSpriteModified, this, &SpriteDetailsPanel::onSpriteModified);
@@ -169,6 +181,8 @@ void SpriteDetailsPanel::initLayout() {
     zPosHBox->setAlignment(Qt::AlignCenter);
     zPosHBox->addWidget(new QLabel("Z"));
     zPosHBox->addWidget(m_pZPositionEdit);
+    zPosHBox->addWidget(m_pBringToFrontButton);
+    zPosHBox->addWidget(m_pSendToBackButton);
     positionLayout->addLayout(zPosHBox);
 
     // Taille
@@ -230,9 +244,13 @@ void SpriteDetailsPanel::initInputs() {
     m_pYPositionEdit->setSuffix(" px");
     m_pYPositionEdit->setStyleSheet(GameFramework::loadStyleSheetString("spinboxStyle.qss"));
     m_pZPositionEdit = new QSpinBox();
-    m_pZPositionEdit->setRange(0, 10000);
+    m_pZPositionEdit->setRange(-1000000, 1000000); // Les z-index ne sont pas bornés par le nombre de sprites
     m_pZPositionEdit->setSingleStep(1);
     m_pZPositionEdit->setStyleSheet(GameFramework::loadStyleSheetString("spinboxStyle.qss"));
+    m_pBringToFrontButton = new QPushButton("Premier plan");
+    m_pBringToFrontButton->setStyleSheet(GameFramework::loadStyleSheetString("buttonStyle.qss"));
+    m_pSendToBackButton = new QPushButton("Arrière-plan");
+    m_pSendToBackButton->setStyleSheet(GameFramework::loadStyleSheetString("buttonStyle.qss"));
 
     // Creation et setup des champs de taille
     m_pScaleEdit = new QDoubleSpinBox();
@@ -278,8 +296,18 @@ void SpriteDetailsPanel::connectInputSignals() {
     // Connecter le signal de modification du champ d'opacité
     connect(m_pOpacityEdit, &QSpinBox::valueChanged, this, &SpriteDetailsPanel::onOpacityFieldEdited);
 
+    // La fin d'une édition termine le regroupement des modifications dans l'historique
+    for (QAbstractSpinBox* pSpinBox : QList<QAbstractSpinBox*>{m_pXPositionEdit, m_pYPositionEdit, m_pZPositionEdit, m_pScaleEdit, m_pRotationEdit, m_pOpacityEdit}) {
+        connect(pSpinBox, &QAbstractSpinBox::editingFinished, this, [this]() {
+            if (m_pEditorManager != nullptr)
+                m_pEditorManager->endHistoryGesture();
+        });
+    }
+
     // Connecter le signal de clic de bouton d'édition des tags
     connect(m_pSetTagButton, &QPushButton::clicked, this, &SpriteDetailsPanel::onEditTagsButtonClicked);
+    connect(m_pBringToFrontButton, &QPushButton::clicked, this, &SpriteDetailsPanel::onBringToFrontButtonClicked);
+    connect(m_pSendToBackButton, &QPushButton::clicked, this, &SpriteDetailsPanel::onSendToBackButtonClicked);
 }
 
 /*******************************
@@ -330,6 +358,22 @@ void SpriteDetailsPanel::onZPosFieldEdited(int value) {
     m_pEditorManager->setEditorSpriteZIndex(m_pSprite, value);
 }
 
+//! Appelé lorsque le bouton de premier plan est cliqué.
+void SpriteDetailsPanel::onBringToFrontButtonClicked() {
+    if (m_pSprite == nullptr) // Si le sprite est nul, on ne fait rien
+        return;
+
+    m_pEditorManager->bringEditorSpriteToFront(m_pSprite);
+}
+
+//! Appelé lorsque le bouton d'arrière-plan est cliqué.
+void SpriteDetailsPanel::onSendToBackButtonClicked() {
+    if (m_pSprite == nullptr) // Si le sprite est nul, on ne fait rien
+        return;
+
+    m_pEditorManager->sendEditorSpriteToBack(m_pSprite);
+}
+
 //! Appelé lorsque la taille du sprite est modifiée.
 //! \param newScale La nouvelle valeur de la taille.
 void SpriteDetailsPanel::onScaleFieldEdited(double newScale) {
@@ -45,6 +45,7 @@ class SpriteDetailsPanel : public QWidget {
 public slots:
     void onBindSprite(EditorSprite* sprite);
     void onUnbindSprite();
+    void onSelectionChanged(const QList<EditorSprite*>& selectedSprites);
 
     void onSpriteModified();
 
@@ -54,6 +55,8 @@ public slots:
     void onXPosFieldEdited(int value);
     void onYPosFieldEdited(int value);
     void onZPosFieldEdited(int value);
+    void onBringToFrontButtonClicked();
+    void onSendToBackButtonClicked();
 
     void onScaleFieldEdited(double newScale);
 
@@ -83,6 +86,8 @@ private:
     QSpinBox* m_pXPositionEdit;
     QSpinBox* m_pYPositionEdit;
     QSpinBox* m_pZPositionEdit;
+    QPushButton* m_pBringToFrontButton;
+    QPushButton* m_pSendToBackButton;
 
     QDoubleSpinBox* m_pScaleEdit;
 
@@ -0,0 +1,126 @@
+/*
+ * @file EditorDeleteBenchmark.cpp
+ * @brief Mesure du temps de suppression d'une grande sélection de sprites.
+ * @author Noah Blattner
+ * @date Octobre 2026
+ *
+ * Programme autonome : reproduit le travail de EditorManager::deleteSelectedEditorSprites() sur les conteneurs de
+ * l'éditeur (sprites, index par identifiant et sélection) et mesure la suppression de tous les sprites sélectionnés,
+ * avec EditorSpriteSet puis avec les QList utilisées auparavant (contains() et removeOne() linéaires).
+ * La scène et l'historique ne sont pas mesurés : leur coût ne dépend pas du conteneur.
+ * Utilisation : EditorDeleteBenchmark [nombre de sprites sélectionnés] [nombre de sprites non sélectionnés]
+ */
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QTextStream>
+#include <QVector>
+
+#include "EditorSpriteSet.h"
+
+static constexpr int DEFAULT_SELECTED_COUNT = 20000;
+static constexpr int DEFAULT_UNSELECTED_COUNT = 20000;
+
+//! Les conteneurs de EditorManager, avec EditorSpriteSet
+struct SetEditor {
+    EditorSpriteSet editorSprites;
+    QHash<quint64, EditorSprite*> editorSpritesById;
+    EditorSpriteSet selectedEditorSprites;
+};
+
+//! Les conteneurs de EditorManager, avec les anciennes QList
+struct ListEditor {
+    QList<EditorSprite*> editorSprites;
+    QHash<quint64, EditorSprite*> editorSpritesById;
+    QList<EditorSprite*> selectedEditorSprites;
+};
+
+//! Retourne la liste des sprites sélectionnés
+static QList<EditorSprite*> selection(const SetEditor& editor) { return editor.selectedEditorSprites.toList(); }
+static QList<EditorSprite*> selection(const ListEditor& editor) { return editor.selectedEditorSprites; }
+
+//! Retourne l'identifiant d'un sprite, déduit de son adresse (les sprites ne sont jamais déréférencés)
+static quint64 spriteId(const QVector<char>& storage, const EditorSprite* pSprite) {
+    return reinterpret_cast<const char*>(pSprite) - storage.constData() + 1;
+}
+
+//! Remplit les conteneurs de l'éditeur puis sélectionne les premiers sprites, comme selectMultipleEditorSprites()
+template<typename Editor, typename Insert>
+static void fillEditor(Editor& editor, const QList<EditorSprite*>& sprites, const QVector<char>& storage,
+                       int selectedCount, Insert insert) {
+    for (EditorSprite* pSprite : sprites) {
+        insert(editor.editorSprites, pSprite);
+        editor.editorSpritesById.insert(spriteId(storage, pSprite), pSprite);
+    }
+    for (int i = 0; i < selectedCount; i++) {
+        insert(editor.selectedEditorSprites, sprites[i]);
+    }
+}
+
+//! Supprime les sprites sélectionnés, comme deleteSelectedEditorSprites(), et retourne la durée en millisecondes
+template<typename Editor, typename Remove>
+static double deleteSelection(Editor& editor, const QVector<char>& storage, Remove remove) {
+    QElapsedTimer timer;
+    timer.start();
+
+    // deleteEditorSprite() retire le sprite de la sélection : on parcourt une copie
+    const QList<EditorSprite*> spritesToDelete = selection(editor);
+    for (EditorSprite* pSprite : spritesToDelete) {
+        remove(editor.editorSprites, pSprite);
+        editor.editorSpritesById.remove(spriteId(storage, pSprite));
+        remove(editor.selectedEditorSprites, pSprite);
+    }
+    return timer.nsecsElapsed() / 1e6;
+}
+
+int main(int argc, char* argv[]) {
+    QTextStream out(stdout);
+
+    int selectedCount = argc > 1 ? QString(argv[1]).toInt() : DEFAULT_SELECTED_COUNT;
+    int unselectedCount = argc > 2 ? QString(argv[2]).toInt() : DEFAULT_UNSELECTED_COUNT;
+    if (selectedCount <= 0 || unselectedCount < 0) {
+        out << "Utilisation : EditorDeleteBenchmark [nombre de sprites sélectionnés] [nombre de sprites non sélectionnés]"
+            << Qt::endl;
+        return 1;
+    }
+
+    // Des adresses distinctes tiennent lieu de sprites : seuls les conteneurs sont mesurés
+    const int spriteCount = selectedCount + unselectedCount;
+    const QVector<char> storage(spriteCount);
+    QList<EditorSprite*> sprites;
+    sprites.reserve(spriteCount);
+    for (int i = 0; i < spriteCount; i++) {
+        sprites.append(reinterpret_cast<EditorSprite*>(const_cast<char*>(storage.constData()) + i));
+    }
+
+    SetEditor setEditor;
+    fillEditor(setEditor, sprites, storage, selectedCount, [](EditorSpriteSet& set, EditorSprite* pSprite) {
+        set.insert(pSprite);
+    });
+    double setDuration = deleteSelection(setEditor, storage, [](EditorSpriteSet& set, EditorSprite* pSprite) {
+        set.remove(pSprite);
+    });
+
+    ListEditor listEditor;
+    fillEditor(listEditor, sprites, storage, selectedCount, [](QList<EditorSprite*>& list, EditorSprite* pSprite) {
+        list.append(pSprite);
+    });
+    double listDuration = deleteSelection(listEditor, storage, [](QList<EditorSprite*>& list, EditorSprite* pSprite) {
+        list.removeOne(pSprite);
+    });
+
+    out << selectedCount << " sprites sélectionnés supprimés sur " << spriteCount << Qt::endl;
+    out << QString("%1 %2").arg("Conteneur", -16).arg("Suppression (ms)", 18) << Qt::endl;
+    out << QString("%1 %2").arg("EditorSpriteSet", -16).arg(setDuration, 18, 'f', 2) << Qt::endl;
+    out << QString("%1 %2").arg("QList", -16).arg(listDuration, 18, 'f', 2) << Qt::endl;
+
+    // Seuls les sprites non sélectionnés doivent rester
+    if (setEditor.editorSprites.size() != unselectedCount || listEditor.editorSprites.size() != unselectedCount
+        || !setEditor.selectedEditorSprites.isEmpty() || !listEditor.selectedEditorSprites.isEmpty()
+        || setEditor.editorSpritesById.size() != unselectedCount) {
+        out << "Suppression incorrecte" << Qt::endl;
+        return 1;
+    }
+    return 0;
+}
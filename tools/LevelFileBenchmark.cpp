@@ -0,0 +1,159 @@
+/*
+ * @file LevelFileBenchmark.cpp
+ * @brief Mesure du temps de lecture des fichiers de niveau.
+ * @author Noah Blattner
+ * @date Octobre 2026
+ *
+ * Programme autonome : génère un niveau, l'enregistre dans chaque format, sans compression puis avec chaque
+ * algorithme de compression, et mesure le temps de lecture de chaque fichier avec LevelFile::readFile().
+ * Le temps de compression est mesuré une fois par fichier.
+ * Utilisation : LevelFileBenchmark [nombre de sprites] [nombre de lectures]
+ */
+
+#include <algorithm>
+
+#include <QBuffer>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QVector>
+
+#include "LevelCompression.h"
+#include "LevelFile.h"
+#include "LevelJsonStream.h"
+
+static constexpr int DEFAULT_SPRITE_COUNT = 100000;
+static constexpr int DEFAULT_RUN_COUNT = 5;
+
+//! Génère un niveau de la taille donnée. Les textures et les tags sont partagés entre les sprites,
+//! comme dans un niveau réel
+//! \param spriteCount Le nombre de sprites
+static LevelData generateLevel(int spriteCount) {
+    LevelData level;
+    level.sceneSize = QSize(20000, 20000);
+    level.background = "images/fond.png";
+    level.tags = QStringList({"sol", "mur", "décor"});
+    for (int i = 0; i < spriteCount; i++) {
+        LevelSprite sprite;
+        sprite.id = i + 1;
+        sprite.texturePath = QString("images/texture%1.png").arg(i % 64);
+        sprite.tag = level.tags[i % level.tags.size()];
+        sprite.x = (static_cast<qint64>(i) * 7919) % 20000 + 0.5;
+        sprite.y = (static_cast<qint64>(i) * 104729) % 20000 + 0.25;
+        sprite.rotation = i % 360;
+        sprite.scale = 1 + (i % 4) * 0.25;
+        sprite.opacity = 1;
+        sprite.z = i % 10;
+        level.sprites.append(sprite);
+    }
+    LevelFile::indexTextures(level);
+    return level;
+}
+
+//! Convertit un niveau au format JSON
+//! \param level Le niveau
+static QByteArray toJson(const LevelData& level) {
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    LevelJsonWriter writer(&buffer);
+    writer.writeHeader(level);
+    for (const LevelSprite& sprite : level.sprites) {
+        writer.writeSprite(sprite);
+    }
+    writer.finish();
+    return buffer.data();
+}
+
+//! Un fichier de niveau à mesurer
+struct BenchmarkFile {
+    QString name;
+    QByteArray data;
+    double compressDuration = 0; // En millisecondes, 0 sans compression
+};
+
+//! Lit plusieurs fois un fichier de niveau et retourne la durée médiane d'une lecture, en millisecondes
+//! \param filePath Le chemin du fichier
+//! \param expectedSprites Le nombre de sprites attendu
+//! \param runCount Le nombre de lectures
+//! \return La durée médiane, négative si le fichier n'a pas pu être lu
+static double measureRead(const QString& filePath, int expectedSprites, int runCount) {
+    QVector<double> durations;
+    durations.reserve(runCount);
+    for (int run = 0; run < runCount; run++) {
+        LevelData level;
+        QElapsedTimer timer;
+        timer.start();
+        bool ok = LevelFile::readFile(filePath, level);
+        qint64 elapsed = timer.nsecsElapsed();
+        if (!ok || level.sprites.size() != expectedSprites) {
+            return -1;
+        }
+        durations.append(elapsed / 1e6);
+    }
+    std::sort(durations.begin(), durations.end());
+    return durations[durations.size() / 2];
+}
+
+int main(int argc, char* argv[]) {
+    QTextStream out(stdout);
+
+    int spriteCount = argc > 1 ? QString(argv[1]).toInt() : DEFAULT_SPRITE_COUNT;
+    int runCount = argc > 2 ? QString(argv[2]).toInt() : DEFAULT_RUN_COUNT;
+    if (spriteCount <= 0 || runCount <= 0) {
+        out << "Utilisation : LevelFileBenchmark [nombre de sprites] [nombre de lectures]" << Qt::endl;
+        return 1;
+    }
+
+    QTemporaryDir directory;
+    if (!directory.isValid()) {
+        out << "Impossible de créer le dossier temporaire" << Qt::endl;
+        return 1;
+    }
+
+    const LevelData level = generateLevel(spriteCount);
+    const QVector<BenchmarkFile> formats = {
+        {"binaire", LevelFile::toBinary(level)},
+        {"JSON", toJson(level)},
+    };
+    QVector<BenchmarkFile> files;
+    for (const BenchmarkFile& format : formats) {
+        for (LevelCompression::Codec codec : {LevelCompression::NoCodec, LevelCompression::ZlibCodec, LevelCompression::Lz4Codec}) {
+            BenchmarkFile benchmarkFile;
+            benchmarkFile.name = format.name + " (" + LevelCompression::codecName(codec) + ")";
+            QElapsedTimer timer;
+            timer.start();
+            benchmarkFile.data = LevelCompression::compress(format.data, codec);
+            benchmarkFile.compressDuration = codec == LevelCompression::NoCodec ? 0 : timer.nsecsElapsed() / 1e6;
+            files.append(benchmarkFile);
+        }
+    }
+
+    out << spriteCount << " sprites, médiane de " << runCount << " lectures" << Qt::endl;
+    out << QString("%1 %2 %3 %4").arg("Format", -20).arg("Taille (Kio)", 14).arg("Compression (ms)", 18)
+               .arg("Lecture (ms)", 14) << Qt::endl;
+
+    int failures = 0;
+    for (qsizetype i = 0; i < files.size(); i++) {
+        const BenchmarkFile& benchmarkFile = files[i];
+        QString filePath = directory.filePath(QString("niveau%1").arg(i));
+        QFile file(filePath);
+        if (!file.open(QIODevice::WriteOnly) || file.write(benchmarkFile.data) != benchmarkFile.data.size()) {
+            out << "Impossible d'écrire " << filePath << Qt::endl;
+            return 1;
+        }
+        file.close();
+
+        double duration = measureRead(filePath, spriteCount, runCount);
+        out << QString("%1 %2 %3 ").arg(benchmarkFile.name, -20).arg(benchmarkFile.data.size() / 1024.0, 14, 'f', 1)
+                   .arg(benchmarkFile.compressDuration, 18, 'f', 2);
+        if (duration < 0) {
+            out << "échec de la lecture" << Qt::endl;
+            failures++;
+        } else {
+            out << QString("%1").arg(duration, 14, 'f', 2) << Qt::endl;
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
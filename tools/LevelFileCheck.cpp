@@ -0,0 +1,512 @@
+/*
+ * @file LevelFileCheck.cpp
+ * @brief Vérification de la lecture des fichiers de niveau.
+ * @author Noah Blattner
+ * @date Octobre 2026
+ *
+ * Programme autonome : retourne 0 si toutes les vérifications réussissent, 1 sinon.
+ */
+
+#include <cstring>
+#include <limits>
+
+#include <QBuffer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <QtEndian>
+
+#include "LevelCompression.h"
+#include "LevelFile.h"
+#include "LevelJsonStream.h"
+
+//! Lit un niveau JSON avec LevelJsonReader
+//! \param json Le contenu du fichier
+//! \param level Reçoit le niveau et ses sprites
+//! \param pError Reçoit la description de l'erreur
+//! \return true si le niveau a pu être lu
+static bool readLevel(const QByteArray& json, LevelData& level, QString* pError) {
+    QBuffer buffer;
+    buffer.setData(json);
+    buffer.open(QIODevice::ReadOnly);
+
+    LevelJsonReader reader(&buffer);
+    bool ok = reader.read(level, [&level](const LevelSprite& sprite) {
+        level.sprites.append(sprite);
+    });
+    *pError = reader.errorString();
+    return ok;
+}
+
+//! Un niveau écrit par QJsonDocument, qui trie les clés : "sprites" précède "textures"
+static bool checkSpritesBeforeTextures(QString* pError) {
+    QJsonObject sprite1;
+    sprite1["id"] = 1;
+    sprite1["texture"] = 1;
+    sprite1["x"] = 10.0;
+    QJsonObject sprite2;
+    sprite2["id"] = 2;
+    sprite2["texture"] = 0;
+    sprite2["x"] = 20.0;
+    QJsonObject sprite3; // Ancien format : chemin de la texture
+    sprite3["id"] = 3;
+    sprite3["texturePath"] = "images/c.png";
+
+    QJsonObject json;
+    json["textures"] = QJsonArray({"images/a.png", "images/b.png"});
+    json["sprites"] = QJsonArray({sprite1, sprite2, sprite3});
+    json["sceneWidth"] = 800;
+    json["sceneHeight"] = 600;
+
+    QByteArray data = QJsonDocument(json).toJson();
+    if (data.indexOf("\"sprites\"") > data.indexOf("\"textures\"")) {
+        *pError = "les clés ne sont pas dans l'ordre attendu";
+        return false;
+    }
+
+    LevelData level;
+    if (!readLevel(data, level, pError)) {
+        return false;
+    }
+
+    if (level.sprites.size() != 3
+        || level.sprites[0].id != 1 || level.sprites[0].textureIndex != 1 || level.sprites[0].texturePath != "images/b.png"
+        || level.sprites[1].id != 2 || level.sprites[1].textureIndex != 0 || level.sprites[1].texturePath != "images/a.png"
+        || level.sprites[2].id != 3 || level.sprites[2].textureIndex != 2 || level.sprites[2].texturePath != "images/c.png"
+        || level.textures != QStringList({"images/a.png", "images/b.png", "images/c.png"})
+        || level.sceneSize != QSize(800, 600)) {
+        *pError = "sprites ou table des textures incorrects";
+        return false;
+    }
+    return true;
+}
+
+//! Un index de texture hors de la table est refusé, même lorsque la table suit les sprites
+static bool checkInvalidTextureIndex(QString* pError) {
+    QByteArray data = R"({"sprites": [{"id": 1, "texture": 2}], "textures": ["images/a.png", "images/b.png"]})";
+
+    LevelData level;
+    if (readLevel(data, level, pError)) {
+        *pError = "index de texture invalide accepté";
+        return false;
+    }
+    return true;
+}
+
+//! Les sprites de l'ancien format sont transmis au fil de la lecture, même sans table des textures,
+//! et leur index reste valide lorsque la table du fichier les suit
+static bool checkLegacySpritesStreamed(QString* pError) {
+    // Un fichier plus grand qu'un bloc de lecture : le premier sprite doit être transmis avant la fin du fichier
+    QByteArray data = R"({"sprites": [)";
+    for (int i = 0; i < 2000; i++) {
+        data += QString(R"(%1{"id": %2, "texturePath": "images/legacy%3.png", "x": %4})")
+                    .arg(i == 0 ? "" : ", ").arg(i + 1).arg(i % 4).arg(i).toUtf8();
+    }
+    data += R"(, {"id": 2001, "texture": 0}], "textures": ["images/a.png", "images/legacy1.png"]})";
+
+    QBuffer buffer;
+    buffer.setData(data);
+    buffer.open(QIODevice::ReadOnly);
+
+    LevelData level;
+    qint64 firstSpritePosition = -1;
+    LevelJsonReader reader(&buffer);
+    bool ok = reader.read(level, [&](const LevelSprite& sprite) {
+        if (level.sprites.isEmpty()) {
+            firstSpritePosition = buffer.pos();
+        }
+        level.sprites.append(sprite);
+    });
+    if (!ok) {
+        *pError = reader.errorString();
+        return false;
+    }
+
+    if (firstSpritePosition < 0 || firstSpritePosition >= data.size()) {
+        *pError = "sprites de l'ancien format transmis à la fin de la lecture";
+        return false;
+    }
+    if (level.sprites.size() != 2001 || level.textures.size() != 5) {
+        *pError = "sprites ou table des textures incorrects";
+        return false;
+    }
+    for (const LevelSprite& sprite : std::as_const(level.sprites)) {
+        if (sprite.textureIndex < 0 || sprite.textureIndex >= level.textures.size()
+            || level.textures[sprite.textureIndex] != sprite.texturePath) {
+            *pError = "index de texture incohérent : sprite " + QString::number(sprite.id);
+            return false;
+        }
+    }
+    if (level.sprites.last().texturePath != "images/a.png") {
+        *pError = "texture du dernier sprite incorrecte";
+        return false;
+    }
+    return true;
+}
+
+//! Un niveau écrit par LevelJsonWriter est relu à l'identique
+static bool checkWriterRoundTrip(QString* pError) {
+    LevelData written;
+    written.sceneSize = QSize(1024, 768);
+    written.tags = QStringList({"sol"});
+    for (int i = 0; i < 10; i++) {
+        LevelSprite sprite;
+        sprite.id = i + 1;
+        sprite.texturePath = QString("images/%1.png").arg(i % 3);
+        sprite.tag = i % 2 == 0 ? "sol" : QString();
+        sprite.x = i * 32.5;
+        sprite.y = -i * 16.25;
+        written.sprites.append(sprite);
+    }
+    LevelFile::indexTextures(written);
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    LevelJsonWriter writer(&buffer);
+    writer.writeHeader(written);
+    for (const LevelSprite& sprite : written.sprites) {
+        writer.writeSprite(sprite);
+    }
+    if (!writer.finish()) {
+        *pError = "écriture impossible";
+        return false;
+    }
+
+    LevelData level;
+    if (!readLevel(buffer.data(), level, pError)) {
+        return false;
+    }
+
+    if (level.sprites.size() != written.sprites.size() || level.textures != written.textures
+        || level.tags != written.tags || level.sceneSize != written.sceneSize) {
+        *pError = "niveau relu différent du niveau écrit";
+        return false;
+    }
+    for (qsizetype i = 0; i < level.sprites.size(); i++) {
+        const LevelSprite& a = written.sprites[i];
+        const LevelSprite& b = level.sprites[i];
+        if (a.id != b.id || a.texturePath != b.texturePath || a.textureIndex != b.textureIndex
+            || a.tag != b.tag || a.x != b.x || a.y != b.y) {
+            *pError = "sprite relu différent du sprite écrit : " + QString::number(a.id);
+            return false;
+        }
+    }
+    return true;
+}
+
+//! Les positions extrêmes ou non numériques et une taille de région nulle ne produisent pas de conversion indéfinie
+static bool checkChunkAt(QString* pError) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const double infinity = std::numeric_limits<double>::infinity();
+    const int intMin = std::numeric_limits<int>::min();
+    const int intMax = std::numeric_limits<int>::max();
+
+    if (LevelFile::chunkAt(-1, 2048, 1024) != QPoint(-1, 2)
+        || LevelFile::chunkAt(10, 10, 0) != QPoint(0, 0)
+        || LevelFile::chunkAt(nan, 1, 1) != QPoint(0, 1)
+        || LevelFile::chunkAt(1e300, -1e300, 1) != QPoint(intMax, intMin)
+        || LevelFile::chunkAt(infinity, -infinity, 1024) != QPoint(intMax, intMin)) {
+        *pError = "coordonnées de région incorrectes";
+        return false;
+    }
+    return true;
+}
+
+//! Une section des régions corrompue est refusée à l'ouverture
+static bool checkCorruptedChunks(QString* pError) {
+    // Tous les sprites dans la même région : la section se termine par une région et l'index des sprites
+    LevelData level;
+    for (int i = 0; i < 4; i++) {
+        LevelSprite sprite;
+        sprite.id = i + 1;
+        sprite.texturePath = "images/a.png";
+        sprite.x = i;
+        level.sprites.append(sprite);
+    }
+    const QByteArray data = LevelFile::toBinary(level);
+    const qsizetype spriteIndexOffset = data.size() - level.sprites.size() * 4;
+    const qsizetype chunkSizeOffset = spriteIndexOffset - 16 - 8;
+
+    LevelFileView view;
+    if (!view.setData(data.constData(), data.size(), pError) || view.chunkCount() != 1) {
+        *pError = "niveau valide refusé : " + *pError;
+        return false;
+    }
+
+    QByteArray zeroChunkSize = data;
+    qToLittleEndian<quint32>(0, zeroChunkSize.data() + chunkSizeOffset);
+    if (view.setData(zeroChunkSize.constData(), zeroChunkSize.size())) {
+        *pError = "taille de région nulle acceptée";
+        return false;
+    }
+
+    QByteArray badSpriteIndex = data;
+    qToLittleEndian<quint32>(level.sprites.size(), badSpriteIndex.data() + spriteIndexOffset);
+    if (view.setData(badSpriteIndex.constData(), badSpriteIndex.size())) {
+        *pError = "index de sprite hors du niveau accepté";
+        return false;
+    }
+    return true;
+}
+
+//! La rotation, l'échelle, l'opacité et la profondeur des sprites sont relues sans perte de précision,
+//! et les niveaux de version 2, où elles sont en simple précision, restent lisibles
+static bool checkSpritePrecision(QString* pError) {
+    LevelData level;
+    for (int i = 0; i < 3; i++) {
+        LevelSprite sprite;
+        sprite.id = i + 1;
+        sprite.texturePath = "images/a.png";
+        sprite.x = i * 100.1;
+        sprite.rotation = 0.1 + i;
+        sprite.scale = 1.0 / 3 + i;
+        sprite.opacity = 0.7;
+        sprite.z = 1e9 + 0.5 + i; // Non représentable en simple précision
+        level.sprites.append(sprite);
+    }
+    const QByteArray data = LevelFile::toBinary(level);
+
+    LevelData read;
+    if (!LevelFile::fromBinary(data.constData(), data.size(), read, pError)) {
+        return false;
+    }
+    for (qsizetype i = 0; i < level.sprites.size(); i++) {
+        const LevelSprite& a = level.sprites[i];
+        const LevelSprite& b = read.sprites[i];
+        if (a.rotation != b.rotation || a.scale != b.scale || a.opacity != b.opacity || a.z != b.z) {
+            *pError = "valeurs relues différentes : sprite " + QString::number(a.id);
+            return false;
+        }
+    }
+
+    // Conversion en version 2 : mêmes sections, enregistrements des sprites en simple précision (48 octets au lieu de 64)
+    const qsizetype spritesOffset = 40 + qFromLittleEndian<quint32>(data.constData() + 36)
+                                  + qFromLittleEndian<quint32>(data.constData() + 28) * 4;
+    QByteArray version2 = data.left(spritesOffset);
+    qToLittleEndian<quint16>(2, version2.data() + 4);
+    for (qsizetype i = 0; i < level.sprites.size(); i++) {
+        const char* pRecord = data.constData() + spritesOffset + i * 64;
+        char record[48];
+        std::memcpy(record, pRecord, 24); // Identifiant et position
+        for (int value = 0; value < 4; value++) {
+            qToLittleEndian<float>(static_cast<float>(qFromLittleEndian<double>(pRecord + 24 + value * 8)), record + 24 + value * 4);
+        }
+        std::memcpy(record + 40, pRecord + 56, 8); // Index de la texture et du tag
+        version2.append(record, sizeof(record));
+    }
+    version2.append(data.mid(spritesOffset + level.sprites.size() * 64));
+
+    if (!LevelFile::fromBinary(version2.constData(), version2.size(), read, pError)) {
+        *pError = "niveau de version 2 refusé : " + *pError;
+        return false;
+    }
+    for (qsizetype i = 0; i < level.sprites.size(); i++) {
+        const LevelSprite& a = level.sprites[i];
+        const LevelSprite& b = read.sprites[i];
+        if (a.id != b.id || a.x != b.x || b.rotation != static_cast<float>(a.rotation) || b.scale != static_cast<float>(a.scale)
+            || b.opacity != static_cast<float>(a.opacity) || b.z != static_cast<float>(a.z) || b.texturePath != a.texturePath) {
+            *pError = "niveau de version 2 mal relu : sprite " + QString::number(a.id);
+            return false;
+        }
+    }
+    return true;
+}
+
+//! Un niveau binaire plus grand qu'un bloc d'écriture est écrit par blocs, relu à l'identique,
+//! et une erreur d'écriture est signalée
+static bool checkBinaryWriter(QString* pError) {
+    LevelData level;
+    for (int i = 0; i < 5000; i++) { // Environ 320 Kio : plusieurs blocs de sprites
+        LevelSprite sprite;
+        sprite.id = i + 1;
+        sprite.texturePath = QString("images/%1.png").arg(i % 7);
+        sprite.x = i * 10;
+        level.sprites.append(sprite);
+    }
+    LevelFile::indexTextures(level);
+
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    qsizetype lastProgress = 0;
+    int progressCount = 0;
+    bool ok = LevelFile::writeBinary(&buffer, level, LevelFile::DEFAULT_CHUNK_SIZE, [&](qsizetype writtenSprites) {
+        if (writtenSprites <= lastProgress || writtenSprites > level.sprites.size()) {
+            progressCount = -1000;
+        }
+        lastProgress = writtenSprites;
+        progressCount++;
+    });
+    if (!ok || progressCount < 2) {
+        *pError = "écriture par blocs incorrecte";
+        return false;
+    }
+
+    LevelData read;
+    if (!LevelFile::fromBinary(data.constData(), data.size(), read, pError)) {
+        return false;
+    }
+    if (read.sprites.size() != level.sprites.size() || read.textures != level.textures
+        || read.sprites.last().x != level.sprites.last().x) {
+        *pError = "niveau relu différent du niveau écrit";
+        return false;
+    }
+
+    QBuffer readOnly;
+    readOnly.open(QIODevice::ReadOnly);
+    if (LevelFile::writeBinary(&readOnly, level)) {
+        *pError = "erreur d'écriture ignorée";
+        return false;
+    }
+    return true;
+}
+
+//! Des données compressées puis décompressées sont identiques aux données d'origine
+//! \param data Les données
+//! \param codec L'algorithme de compression
+//! \param pCompressedSize Reçoit la taille des données compressées, en-tête compris
+//! \param pError Reçoit la description de l'erreur
+static bool checkRoundTrip(const QByteArray& data, LevelCompression::Codec codec, qsizetype* pCompressedSize, QString* pError) {
+    const QByteArray compressed = LevelCompression::compress(data, codec);
+    *pCompressedSize = compressed.size();
+
+    QByteArray decompressed;
+    if (!LevelCompression::decompress(compressed.constData(), compressed.size(), decompressed, pError)) {
+        return false;
+    }
+    if (decompressed != data) {
+        *pError = "données décompressées différentes";
+        return false;
+    }
+    return true;
+}
+
+//! Les données vides, incompressibles ou très répétitives sont restituées à l'identique par LZ4
+static bool checkLz4RoundTrip(QString* pError) {
+    // Données incompressibles : générateur pseudo-aléatoire (xorshift), reproductible
+    QByteArray incompressible(100000, Qt::Uninitialized);
+    quint32 state = 2463534242u;
+    for (char& byte : incompressible) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        byte = static_cast<char>(state >> 24);
+    }
+
+    // Longues correspondances : leur longueur dépasse celle que le jeton peut coder seul,
+    // et une distance plus courte que la correspondance recouvre les octets produits
+    const QByteArray longMatch = QByteArray(300000, 'a') + QByteArray("abc").repeated(20000) + incompressible.left(1000);
+
+    struct RoundTrip {
+        const char* name;
+        QByteArray data;
+        qsizetype maxCompressedSize;
+    };
+    const RoundTrip roundTrips[] = {
+        {"vides", QByteArray(), LevelCompression::HEADER_SIZE + 1},
+        {"courtes", QByteArray("abcdabcdabc"), LevelCompression::HEADER_SIZE + 12},
+        {"incompressibles", incompressible, LevelCompression::HEADER_SIZE + incompressible.size() + incompressible.size() / 255 + 16},
+        {"longues correspondances", longMatch, LevelCompression::HEADER_SIZE + 6000},
+    };
+    for (const RoundTrip& roundTrip : roundTrips) {
+        qsizetype compressedSize = 0;
+        if (!checkRoundTrip(roundTrip.data, LevelCompression::Lz4Codec, &compressedSize, pError)) {
+            *pError = QString("données %1 : %2").arg(roundTrip.name, *pError);
+            return false;
+        }
+        if (compressedSize > roundTrip.maxCompressedSize) {
+            *pError = QString("données %1 : %2 octets compressés, au plus %3 attendus").arg(roundTrip.name)
+                          .arg(compressedSize).arg(roundTrip.maxCompressedSize);
+            return false;
+        }
+    }
+    return true;
+}
+
+//! Enveloppe un bloc LZ4 écrit à la main dans le conteneur de niveau compressé
+//! \param block Le bloc LZ4
+//! \param outputSize La taille des données décompressées annoncée par l'en-tête
+static QByteArray lz4Container(const QByteArray& block, quint64 outputSize) {
+    char header[LevelCompression::HEADER_SIZE] = {};
+    std::memcpy(header, "WBLZ", 4);
+    qToLittleEndian<quint16>(1, header + 4);
+    header[6] = static_cast<char>(LevelCompression::Lz4Codec);
+    qToLittleEndian<quint64>(outputSize, header + 8);
+    return QByteArray(header, LevelCompression::HEADER_SIZE) + block;
+}
+
+//! Un bloc LZ4 corrompu est refusé, sans lire ni écrire hors des données
+static bool checkLz4Corrupted(QString* pError) {
+    // Bloc valide de référence : quatre littéraux et une correspondance de quatre octets à la distance 4,
+    // puis la dernière séquence, vide
+    const QByteArray valid("\x40" "abcd" "\x04\x00" "\x00", 8);
+    QByteArray output;
+    if (!LevelCompression::decompress(lz4Container(valid, 8).constData(), valid.size() + LevelCompression::HEADER_SIZE, output)
+        || output != "abcdabcd") {
+        *pError = "bloc de référence refusé";
+        return false;
+    }
+
+    const QByteArray truncated = LevelCompression::compress(QByteArray("0123456789").repeated(100), LevelCompression::Lz4Codec);
+
+    struct Corruption {
+        const char* name;
+        QByteArray container;
+    };
+    const Corruption corruptions[] = {
+        {"distance nulle", lz4Container(QByteArray("\x10" "a" "\x00\x00", 4), 5)},
+        {"distance avant le début", lz4Container(QByteArray("\x10" "a" "\x02\x00", 4), 5)},
+        {"littéraux au-delà du bloc", lz4Container(QByteArray("\x50" "ab", 3), 5)},
+        {"longueur de littéraux au-delà du bloc", lz4Container(QByteArray("\xf0\xff\xff", 3), 525)},
+        {"littéraux au-delà de la taille annoncée", lz4Container(QByteArray("\x40" "abcd", 5), 3)},
+        {"correspondance au-delà de la taille annoncée", lz4Container(valid, 7)},
+        {"taille annoncée trop grande", lz4Container(valid, 9)},
+        {"taille annoncée impossible", lz4Container(valid, std::numeric_limits<quint64>::max())},
+        {"distance tronquée", lz4Container(QByteArray("\x10" "a" "\x01", 3), 5)},
+        {"bloc tronqué", truncated.left(truncated.size() - 1)},
+    };
+    for (const Corruption& corruption : corruptions) {
+        QByteArray data;
+        if (LevelCompression::decompress(corruption.container.constData(), corruption.container.size(), data)) {
+            *pError = QString("bloc accepté : %1").arg(corruption.name);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    QTextStream out(stdout);
+
+    struct Check {
+        const char* name;
+        bool (*run)(QString*);
+    };
+    const Check checks[] = {
+        {"sprites avant textures", checkSpritesBeforeTextures},
+        {"index de texture invalide", checkInvalidTextureIndex},
+        {"ancien format au fil de la lecture", checkLegacySpritesStreamed},
+        {"écriture puis lecture JSON", checkWriterRoundTrip},
+        {"coordonnées de région", checkChunkAt},
+        {"régions corrompues", checkCorruptedChunks},
+        {"précision des sprites", checkSpritePrecision},
+        {"écriture binaire par blocs", checkBinaryWriter},
+        {"compression LZ4", checkLz4RoundTrip},
+        {"blocs LZ4 corrompus", checkLz4Corrupted},
+    };
+
+    int failures = 0;
+    for (const Check& check : checks) {
+        QString error;
+        bool ok = check.run(&error);
+        out << (ok ? "OK     " : "ÉCHEC  ") << check.name;
+        if (!ok) {
+            out << " : " << error;
+            failures++;
+        }
+        out << Qt::endl;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,193 @@
+/*
+ * @file LevelLoaderCheck.cpp
+ * @brief Vérification du chargement des niveaux dans une scène.
+ * @author Noah Blattner
+ * @date Octobre 2026
+ *
+ * Programme autonome : charge un petit niveau découpé en régions avec LevelLoader, progressivement autour d'un point
+ * (openStream(), updateStreaming()) puis par tranches (loadLevelIncrementally()).
+ * Retourne 0 si toutes les vérifications réussissent, 1 sinon. Lancé sans affichage (QT_QPA_PLATFORM=offscreen).
+ */
+
+#include <QApplication>
+#include <QEventLoop>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QTimer>
+
+#include "gamecanvas.h"
+#include "gamescene.h"
+#include "sprite.h"
+#include "LevelFile.h"
+#include "LevelLoader.h"
+
+static const QString LEVEL_NAME = "niveau";
+static constexpr int LOADING_TIMEOUT = 10000; // En millisecondes
+
+//! Le niveau des vérifications : cinq sprites répartis dans quatre régions de LevelFile::DEFAULT_CHUNK_SIZE unités
+static LevelData checkLevel() {
+    const QList<QPointF> positions = {
+        QPointF(100, 100), QPointF(200, 200), // Région (0, 0)
+        QPointF(1100, 100), // Région (1, 0)
+        QPointF(5000, 5000), // Région (4, 4)
+        QPointF(-3000, 100), // Région (-3, 0)
+    };
+
+    LevelData level;
+    level.sceneSize = QSize(8192, 8192);
+    for (qsizetype i = 0; i < positions.size(); i++) {
+        LevelSprite sprite;
+        sprite.id = i + 1;
+        sprite.texturePath = QString("images/inexistante%1.png").arg(i % 2); // Décodage en échec : image vide
+        sprite.x = positions[i].x();
+        sprite.y = positions[i].y();
+        level.sprites.append(sprite);
+    }
+    LevelFile::indexTextures(level);
+    return level;
+}
+
+//! Vérifie le nombre de régions chargées et de sprites dans la scène
+static bool checkLoaded(const LevelLoader& loader, GameScene* pScene, int chunkCount, int spriteCount,
+                        const QString& step, QString* pError) {
+    if (loader.loadedChunkCount() != chunkCount || pScene->sprites().size() != spriteCount) {
+        *pError = QString("%1 : %2 régions et %3 sprites chargés, %4 et %5 attendus").arg(step)
+                      .arg(loader.loadedChunkCount()).arg(pScene->sprites().size()).arg(chunkCount).arg(spriteCount);
+        return false;
+    }
+    return true;
+}
+
+//! Seules les régions proches du point suivi sont chargées, y compris lorsque le point ou la distance de chargement
+//! atteignent les limites des coordonnées de région
+static bool checkStreaming(GameScene* pScene, const QString& levelsPath, QString* pError) {
+    LevelLoader loader(pScene, levelsPath);
+    if (!loader.openStream(LEVEL_NAME)) {
+        *pError = "ouverture impossible";
+        return false;
+    }
+
+    loader.setStreamingRadius(10, 20);
+    loader.updateStreaming(QPointF(100, 100));
+    if (!checkLoaded(loader, pScene, 1, 2, "autour de l'origine", pError)) {
+        return false;
+    }
+
+    loader.updateStreaming(QPointF(5000, 5000));
+    if (!checkLoaded(loader, pScene, 1, 1, "après un déplacement", pError)) {
+        return false;
+    }
+
+    // Point hors des coordonnées de région représentables : chunkAt() retourne les limites de int
+    loader.updateStreaming(QPointF(1e300, -1e300));
+    if (!checkLoaded(loader, pScene, 0, 0, "point à l'infini", pError)) {
+        return false;
+    }
+
+    // Distance plus grande que le niveau : toutes les régions sont chargées
+    loader.setStreamingRadius(1e300, 1e300);
+    loader.updateStreaming(QPointF(0, 0));
+    if (!checkLoaded(loader, pScene, 4, 5, "distance infinie", pError)) {
+        return false;
+    }
+
+    loader.closeStream();
+    return checkLoaded(loader, pScene, 0, 0, "après la fermeture", pError);
+}
+
+//! Les sprites sont créés par tranches, une fois les textures décodées, et la fin du chargement est signalée
+static bool checkIncrementalLoading(GameScene* pScene, const QString& levelsPath, QString* pError) {
+    LevelLoader loader(pScene, levelsPath);
+
+    QEventLoop loop;
+    int progressCount = 0;
+    QList<Sprite*> loadedSprites;
+    bool isFinished = false;
+    QObject::connect(&loader, &LevelLoader::loadingProgress, [&progressCount](int, int) {
+        progressCount++;
+    });
+    QObject::connect(&loader, &LevelLoader::loadingFinished, [&](const QString&, const QList<Sprite*>& sprites) {
+        loadedSprites = sprites;
+        isFinished = true;
+        loop.quit();
+    });
+
+    // Budget nul : un sprite par tranche
+    if (!loader.loadLevelIncrementally(LEVEL_NAME, 0) || !loader.isLoading()) {
+        *pError = "le chargement n'a pas commencé";
+        return false;
+    }
+    QTimer::singleShot(LOADING_TIMEOUT, &loop, &QEventLoop::quit);
+    loop.exec();
+
+    if (!isFinished) {
+        *pError = "chargement inachevé";
+        return false;
+    }
+    if (loader.isLoading() || progressCount != 5 || loadedSprites.size() != 5 || pScene->sprites().size() != 5) {
+        *pError = QString("%1 tranches et %2 sprites chargés, 5 attendus").arg(progressCount).arg(loadedSprites.size());
+        return false;
+    }
+
+    QList<QPointF> positions;
+    for (Sprite* pSprite : std::as_const(loadedSprites)) {
+        positions.append(pSprite->pos());
+    }
+    if (!positions.contains(QPointF(-3000, 100)) || !positions.contains(QPointF(5000, 5000))) {
+        *pError = "positions des sprites incorrectes";
+        return false;
+    }
+
+    loader.unloadLevel();
+    if (!pScene->sprites().isEmpty()) {
+        *pError = "sprites restants après le déchargement";
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    QApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    QTemporaryDir directory;
+    QFile file(directory.filePath(LEVEL_NAME + LevelFile::BINARY_EXTENSION));
+    const QByteArray data = LevelFile::toBinary(checkLevel());
+    if (!directory.isValid() || !file.open(QIODevice::WriteOnly) || file.write(data) != data.size()) {
+        out << "Impossible d'écrire le niveau" << Qt::endl;
+        return 1;
+    }
+    file.close();
+
+    // La scène est créée par GameCanvas, sans démarrer le jeu : l'initialisation de GameCore est annulée
+    QWidget window;
+    Ui::MainFrm ui;
+    ui.setupUi(&window);
+    GameCanvas canvas(&ui);
+    QCoreApplication::removePostedEvents(&canvas, QEvent::MetaCall);
+    GameScene* pScene = canvas.createScene(-4096, -4096, 8192, 8192);
+
+    struct Check {
+        const char* name;
+        bool (*run)(GameScene*, const QString&, QString*);
+    };
+    const Check checks[] = {
+        {"chargement par régions", checkStreaming},
+        {"chargement par tranches", checkIncrementalLoading},
+    };
+
+    int failures = 0;
+    for (const Check& check : checks) {
+        QString error;
+        bool ok = check.run(pScene, directory.path(), &error);
+        out << (ok ? "OK     " : "ÉCHEC  ") << check.name;
+        if (!ok) {
+            out << " : " << error;
+            failures++;
+        }
+        out << Qt::endl;
+    }
+
+    return failures == 0 ? 0 : 1;
+}